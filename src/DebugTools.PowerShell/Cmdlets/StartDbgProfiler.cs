@@ -1,5 +1,6 @@
 ﻿using System;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.IO;
 using System.Linq;
 using System.Management.Automation;
@@ -9,12 +10,15 @@ using ChaosPEFile = ChaosLib.Metadata.PEFile;
 
 namespace DebugTools.PowerShell.Cmdlets
 {
-    [Cmdlet(VerbsLifecycle.Start, "DbgProfiler")]
+    [Cmdlet(VerbsLifecycle.Start, "DbgProfiler", DefaultParameterSetName = ParameterSet.Default)]
     public class StartDbgProfiler : ProfilerCmdlet
     {
-        [Parameter(Mandatory = true, Position = 0)]
+        [Parameter(Mandatory = true, Position = 0, ParameterSetName = ParameterSet.Default)]
         public string ProcessName { get; set; }
 
+        [Parameter(Mandatory = true, ParameterSetName = ParameterSet.Attach)]
+        public int Id { get; set; }
+
         [Parameter(Mandatory = false)]
         public SwitchParameter Dbg { get; set; }
 
@@ -58,6 +62,78 @@ namespace DebugTools.PowerShell.Cmdlets
         [Parameter(Mandatory = false)]
         public SwitchParameter Minimized { get; set; }
 
+        [Parameter(Mandatory = false)]
+        public int SnapshotInterval { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public SwitchParameter CoalesceCalls { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public SwitchParameter CollapseRepeatedCalls { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public int SuppressCallRate { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public int SuppressMaxDuration { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public int SkipTrivialMethods { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public string[] TrivialMethodWhitelist { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public int SampleInterval { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public int StackWalkInterval { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public SwitchParameter ILInstrumentation { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public SwitchParameter PreserveNativeImages { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public SwitchParameter Coverage { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public SwitchParameter CpuTime { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public SwitchParameter OffCpu { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public SwitchParameter CompensateHookOverhead { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public int ContinuousInterval { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public SwitchParameter PInvokeStats { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public int SlowCallThreshold { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public string[] SlowCallTriggers { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public SwitchParameter UnhookWhenNotTracing { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public int FlightRecorder { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public string FlightRecorderPath { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public string FlightRecorderException { get; set; }
+
+        [Parameter(Mandatory = false)]
+        public int FlightRecorderSlowFrame { get; set; }
+
         [Parameter(Mandatory = false)]
         public SwitchParameter PassThru { get; set; }
 
@@ -66,6 +142,9 @@ namespace DebugTools.PowerShell.Cmdlets
             if (PassThru && TraceStart)
                 throw new ParameterBindingException($"Cannot specify -{nameof(PassThru)} and -{nameof(TraceStart)} at the same time.");
 
+            if (WinDbg && ParameterSetName == ParameterSet.Attach)
+                throw new ParameterBindingException($"Cannot specify -{nameof(WinDbg)} when attaching to an existing process.");
+
             if (WinDbg)
             {
                 var windbgPath = GetWinDbgAndResolveProcessName();
@@ -115,6 +194,86 @@ namespace DebugTools.PowerShell.Cmdlets
             if (ModuleWhitelist != null)
                 settings.Add(ProfilerSetting.ModuleWhitelist(matcher.Execute(ModuleWhitelist)));
 
+            if (MyInvocation.BoundParameters.ContainsKey(nameof(SnapshotInterval)))
+                settings.Add(ProfilerSetting.SnapshotInterval(SnapshotInterval));
+
+            if (CoalesceCalls)
+                settings.Add(ProfilerSetting.CoalesceCalls);
+
+            if (CollapseRepeatedCalls)
+                settings.Add(ProfilerSetting.CollapseRepeatedCalls);
+
+            if (MyInvocation.BoundParameters.ContainsKey(nameof(SuppressCallRate)))
+            {
+                settings.Add(ProfilerSetting.SuppressCallRate(SuppressCallRate));
+
+                if (MyInvocation.BoundParameters.ContainsKey(nameof(SuppressMaxDuration)))
+                    settings.Add(ProfilerSetting.SuppressMaxDuration(SuppressMaxDuration));
+            }
+
+            if (MyInvocation.BoundParameters.ContainsKey(nameof(SkipTrivialMethods)))
+            {
+                settings.Add(ProfilerSetting.SkipTrivialMethods(SkipTrivialMethods));
+
+                if (TrivialMethodWhitelist != null)
+                    settings.Add(ProfilerSetting.TrivialMethodWhitelist(new WildcardMatcher().Execute(TrivialMethodWhitelist)));
+            }
+
+            if (MyInvocation.BoundParameters.ContainsKey(nameof(SampleInterval)))
+                settings.Add(ProfilerSetting.SampleInterval(SampleInterval));
+
+            if (MyInvocation.BoundParameters.ContainsKey(nameof(StackWalkInterval)))
+                settings.Add(ProfilerSetting.StackWalkInterval(StackWalkInterval));
+
+            if (ILInstrumentation)
+                settings.Add(ProfilerSetting.ILInstrumentation);
+
+            if (PreserveNativeImages)
+                settings.Add(ProfilerSetting.PreserveNativeImages);
+
+            if (Coverage)
+                settings.Add(ProfilerSetting.Coverage);
+
+            if (CpuTime)
+                settings.Add(ProfilerSetting.CpuTime);
+
+            if (OffCpu)
+                settings.Add(ProfilerSetting.OffCpu);
+
+            if (CompensateHookOverhead)
+                settings.Add(ProfilerSetting.CompensateHookOverhead);
+
+            if (MyInvocation.BoundParameters.ContainsKey(nameof(ContinuousInterval)))
+                settings.Add(ProfilerSetting.ContinuousInterval(ContinuousInterval));
+
+            if (PInvokeStats)
+                settings.Add(ProfilerSetting.PInvokeStats);
+
+            if (MyInvocation.BoundParameters.ContainsKey(nameof(SlowCallThreshold)))
+            {
+                settings.Add(ProfilerSetting.SlowCallThreshold(SlowCallThreshold));
+
+                if (SlowCallTriggers != null)
+                    settings.Add(ProfilerSetting.SlowCallTriggers(new WildcardMatcher().Execute(SlowCallTriggers)));
+            }
+
+            if (UnhookWhenNotTracing)
+                settings.Add(ProfilerSetting.UnhookWhenNotTracing);
+
+            if (MyInvocation.BoundParameters.ContainsKey(nameof(FlightRecorder)))
+            {
+                settings.Add(ProfilerSetting.FlightRecorder(FlightRecorder));
+
+                if (FlightRecorderPath != null)
+                    settings.Add(ProfilerSetting.FlightRecorderPath(FlightRecorderPath));
+
+                if (FlightRecorderException != null)
+                    settings.Add(ProfilerSetting.FlightRecorderException(FlightRecorderException));
+
+                if (MyInvocation.BoundParameters.ContainsKey(nameof(FlightRecorderSlowFrame)))
+                    settings.Add(ProfilerSetting.FlightRecorderSlowFrame(FlightRecorderSlowFrame));
+            }
+
             var config = GetProfilerConfig(settings.ToArray());
 
             var session = new ProfilerSession(config);
@@ -161,6 +320,9 @@ namespace DebugTools.PowerShell.Cmdlets
         {
             var type = Synchronous ? ProfilerSessionType.MMF : ProfilerSessionType.Normal;
 
+            if (ParameterSetName == ParameterSet.Attach)
+                return new LiveProfilerReaderConfig(type, Process.GetProcessById(Id), settings);
+
             return new LiveProfilerReaderConfig(type, ProcessName, settings);
         }
 
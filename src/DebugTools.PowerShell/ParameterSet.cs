@@ -15,5 +15,7 @@
         public const string Address = "AddressSet";
 
         public const string Global = "GlobalSet";
+
+        public const string Attach = "AttachSet";
     }
 }
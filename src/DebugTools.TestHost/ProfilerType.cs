@@ -1,4 +1,5 @@
-﻿using System.Runtime.CompilerServices;
+﻿using System.Diagnostics;
+using System.Runtime.CompilerServices;
 using System.Threading;
 using System.Threading.Tasks;
 
@@ -39,6 +40,124 @@ namespace DebugTools.TestHost
         {
         }
 
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        public void TwoChildren_Loop()
+        {
+            //Keep calling the same functions for long enough that they'll be seen by anything that periodically inspects the thread
+            var stopwatch = Stopwatch.StartNew();
+
+            while (stopwatch.ElapsedMilliseconds < 500)
+                TwoChildren();
+        }
+
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        public void Sleep()
+        {
+            Thread.Sleep(500);
+        }
+
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        public void Suppression()
+        {
+            //Functions are only considered for suppression at the end of each one second measurement window
+            var stopwatch = Stopwatch.StartNew();
+
+            while (stopwatch.ElapsedMilliseconds < 2500)
+            {
+                HotFunction();
+
+                //Stay above the call rate without flooding the trace
+                Thread.SpinWait(1000);
+            }
+
+            Suppression_AfterSuppressed();
+        }
+
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        public void Suppression_AfterSuppressed()
+        {
+            HotFunction();
+        }
+
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        public void HotFunction()
+        {
+        }
+
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        public void Suppression_Unsuppress()
+        {
+            var stopwatch = Stopwatch.StartNew();
+
+            while (stopwatch.ElapsedMilliseconds < 2500)
+            {
+                HotParent(false);
+
+                Thread.SpinWait(1000);
+            }
+
+            //HotParent has been suppressed as a leaf function, but now turns out to have a child
+            HotParent(true);
+        }
+
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        public void HotParent(bool callChild)
+        {
+            if (callChild)
+                Suppression_Child();
+        }
+
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        public void Suppression_Child()
+        {
+        }
+
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        public void SlowCall()
+        {
+            SlowCall1();
+            Thread.Sleep(200);
+        }
+
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        public void SlowCall1()
+        {
+        }
+
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        public void FastCall()
+        {
+        }
+
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        public void RepeatedChild()
+        {
+            for (var i = 0; i < 3; i++)
+                RepeatedChild1();
+        }
+
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        public void RepeatedChild1()
+        {
+        }
+
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        public void PInvoke()
+        {
+            for (var i = 0; i < 5; i++)
+                NativeMethods.PInvokeSleep(10);
+        }
+
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        public void NativeImageUsed()
+        {
+        }
+
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        public void NativeImageNotUsed()
+        {
+        }
+
         [MethodImpl(MethodImplOptions.NoInlining)]
         public async Task Async()
         {
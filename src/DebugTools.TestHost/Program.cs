@@ -37,7 +37,7 @@ namespace DebugTools.TestHost
                     break;
 
                 case TestType.Profiler:
-                    ProcessProfilerTest(args[1]);
+                    ProcessProfilerTest(args[1], args.Skip(2).ToArray());
                     break;
 
                 case TestType.Exception:
@@ -1015,7 +1015,7 @@ namespace DebugTools.TestHost
             }
         }
 
-        private static void ProcessProfilerTest(string subType)
+        private static void ProcessProfilerTest(string subType, string[] additionalArgs)
         {
             var test = (ProfilerTestType)Enum.Parse(typeof(ProfilerTestType), subType);
 
@@ -1037,6 +1037,69 @@ namespace DebugTools.TestHost
                     instance.TwoChildren();
                     break;
 
+                case ProfilerTestType.TwoChildren_Loop:
+                    instance.TwoChildren_Loop();
+                    break;
+
+                case ProfilerTestType.Sleep:
+                    instance.Sleep();
+                    break;
+
+                case ProfilerTestType.RepeatedChild:
+                    instance.RepeatedChild();
+                    break;
+
+                case ProfilerTestType.RepeatedChild_LastOnThread:
+                {
+                    //Each target of a multicast delegate is invoked by the runtime, so the repeated calls are the outermost frames of the thread
+                    ThreadStart start = instance.RepeatedChild1;
+                    start += instance.RepeatedChild1;
+                    start += instance.RepeatedChild1;
+
+                    var thread = new Thread(start);
+                    thread.Start();
+                    thread.Join();
+                    break;
+                }
+
+                case ProfilerTestType.Suppression:
+                    instance.Suppression();
+                    break;
+
+                case ProfilerTestType.Suppression_Unsuppress:
+                    instance.Suppression_Unsuppress();
+                    break;
+
+                case ProfilerTestType.SlowCall:
+                {
+                    //The entry point of each thread is a root call, so each thread's call is captured separately
+                    foreach (var start in new ThreadStart[] { instance.FastCall, instance.SlowCall })
+                    {
+                        var thread = new Thread(start);
+                        thread.Start();
+                        thread.Join();
+                    }
+                    break;
+                }
+
+                case ProfilerTestType.PInvoke:
+                    instance.PInvoke();
+                    break;
+
+                case ProfilerTestType.Attach:
+                {
+                    //The test attaches the profiler once we've started, and detaches it once we've made our first call
+                    var eventName = additionalArgs[0];
+
+                    SignalAndWait($"{eventName}_Started", $"{eventName}_Attached");
+                    instance.TwoChildren();
+                    SignalAndWait($"{eventName}_Called", $"{eventName}_Detached");
+
+                    //Methods that were instrumented while the profiler was attached still call into it after it has detached
+                    instance.TwoChildren();
+                    return;
+                }
+
                 case ProfilerTestType.Async:
                     Task.Run(async () => await instance.Async()).Wait();
                     break;
@@ -1076,11 +1139,43 @@ namespace DebugTools.TestHost
                     break;
                 }
 
+                case ProfilerTestType.NativeImage:
+                {
+                    instance.TwoChildren();
+
+                    //The framework's native image is only loaded when the profiler hasn't required that everything be JITted
+                    var modules = Process.GetCurrentProcess().Modules.Cast<ProcessModule>();
+
+                    if (modules.Any(m => string.Equals(m.ModuleName, "mscorlib.ni.dll", StringComparison.OrdinalIgnoreCase)))
+                        instance.NativeImageUsed();
+                    else
+                        instance.NativeImageNotUsed();
+                    break;
+                }
+
                 default:
                     Debug.WriteLine($"Don't know how to run profiler test '{test}'");
                     Environment.Exit(2);
                     break;
             }
+
+            //Tests that query the profiler while we're still alive specify an event to signal once the test has run
+            if (additionalArgs.Length > 0)
+                WaitForLiveTest(additionalArgs[0]);
+        }
+
+        private static void WaitForLiveTest(string eventName) =>
+            SignalAndWait($"{eventName}_Ready", $"{eventName}_Exit");
+
+        private static void SignalAndWait(string signalName, string waitName)
+        {
+            using (var signalEvent = new EventWaitHandle(false, EventResetMode.ManualReset, signalName))
+            using (var waitEvent = new EventWaitHandle(false, EventResetMode.ManualReset, waitName))
+            {
+                signalEvent.Set();
+
+                waitEvent.WaitOne();
+            }
         }
 
         private static void ProcessExceptionTest(string subType)
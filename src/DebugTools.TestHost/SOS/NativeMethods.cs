@@ -15,6 +15,9 @@ namespace DebugTools.TestHost
         private const string kernel32 = "kernel32.dll";
         private const string user32 = "user32.dll";
 
+        [DllImport(kernel32, EntryPoint = "Sleep")]
+        public static extern void PInvokeSleep(uint dwMilliseconds);
+
         [DllImport(user32)]
         [return: MarshalAs(UnmanagedType.Bool)]
         public static extern bool EnumWindows(EnumWindowsProc lpEnumFunc, IntPtr lParam);
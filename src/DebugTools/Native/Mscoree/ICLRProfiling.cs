@@ -0,0 +1,19 @@
+﻿using System;
+using System.Runtime.InteropServices;
+
+namespace DebugTools
+{
+    [Guid("B349ABE3-B56F-4689-BFCD-76BF39D888EA")]
+    [InterfaceType(ComInterfaceType.InterfaceIsIUnknown)]
+    [ComImport]
+    interface ICLRProfiling
+    {
+        void AttachProfiler(
+            [In] int dwProfileeProcessID,
+            [In] int dwMillisecondsMax,
+            [In, MarshalAs(UnmanagedType.LPStruct)] Guid pClsidProfiler,
+            [In, MarshalAs(UnmanagedType.LPWStr)] string wszProfilerPath,
+            [In] IntPtr pvClientData,
+            [In] int cbClientData);
+    }
+}
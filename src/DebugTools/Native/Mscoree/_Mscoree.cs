@@ -0,0 +1,21 @@
+﻿using System;
+using System.Runtime.InteropServices;
+
+namespace DebugTools
+{
+    static class Mscoree
+    {
+        private const string mscoree = "mscoree.dll";
+
+        private static readonly Guid CLSID_CLRProfiling = new Guid("BD097ED8-733E-43FE-8ED7-A95FF9A8448C");
+
+        [DllImport(mscoree, PreserveSig = false)]
+        [return: MarshalAs(UnmanagedType.Interface)]
+        private static extern object CLRCreateInstance(
+            [In, MarshalAs(UnmanagedType.LPStruct)] Guid clsid,
+            [In, MarshalAs(UnmanagedType.LPStruct)] Guid riid);
+
+        public static ICLRProfiling CreateCLRProfiling() =>
+            (ICLRProfiling) CLRCreateInstance(CLSID_CLRProfiling, typeof(ICLRProfiling).GUID);
+    }
+}
@@ -0,0 +1,34 @@
+﻿using System;
+
+namespace DebugTools.Profiler
+{
+    /// <summary>
+    /// Describes the methods that were called the most, or that took the most time, during a single interval of continuous profiling.
+    /// </summary>
+    public class ContinuousSnapshot
+    {
+        /// <summary>
+        /// Gets the time at which the snapshot was received.
+        /// </summary>
+        public DateTime TimeStamp { get; }
+
+        /// <summary>
+        /// Gets the total number of calls that returned during the interval, including calls to methods that were not included in the snapshot.
+        /// </summary>
+        public long TotalCalls { get; }
+
+        public MethodAggregate[] Methods { get; }
+
+        public ContinuousSnapshot(DateTime timeStamp, long totalCalls, MethodAggregate[] methods)
+        {
+            TimeStamp = timeStamp;
+            TotalCalls = totalCalls;
+            Methods = methods;
+        }
+
+        public override string ToString()
+        {
+            return $"{TimeStamp:HH:mm:ss.fff}: {TotalCalls} calls";
+        }
+    }
+}
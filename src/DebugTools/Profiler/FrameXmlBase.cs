@@ -24,5 +24,7 @@
         public const string SequenceAttrib = "Sequence";
         public const string EnterAttrib = "Enter";
         public const string LeaveAttrib = "Leave";
+        public const string InclusiveCpuCyclesAttrib = "InclusiveCpuCycles";
+        public const string ExclusiveCpuCyclesAttrib = "ExclusiveCpuCycles";
     }
 }
@@ -201,6 +201,14 @@ namespace DebugTools.Profiler
 
             var result = makeFrame(method, Convert.ToInt64(sequence));
 
+            var inclusiveCpuCycles = reader.GetAttribute(InclusiveCpuCyclesAttrib);
+
+            if (inclusiveCpuCycles != null && result is MethodFrame m)
+            {
+                m.InclusiveCpuCycles = Convert.ToInt64(inclusiveCpuCycles);
+                m.ExclusiveCpuCycles = Convert.ToInt64(reader.GetAttribute(ExclusiveCpuCyclesAttrib));
+            }
+
             reader.Read();
 
             return result;
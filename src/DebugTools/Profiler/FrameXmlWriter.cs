@@ -142,6 +142,12 @@ namespace DebugTools.Profiler
             writer.WriteStartElement(elementName);
             writer.WriteAttributeString(FunctionIDAttrib, ((ulong) (void*) frame.MethodInfo.FunctionID.Value).ToString("X"));
             writer.WriteAttributeString(SequenceAttrib, frame.Sequence.ToString());
+
+            if (frame is MethodFrame m && m.InclusiveCpuCycles != 0)
+            {
+                writer.WriteAttributeString(InclusiveCpuCyclesAttrib, m.InclusiveCpuCycles.ToString());
+                writer.WriteAttributeString(ExclusiveCpuCyclesAttrib, m.ExclusiveCpuCycles.ToString());
+            }
         }
     }
 }
@@ -4,6 +4,11 @@
     public enum MessageType
     {
         EnableTracing,
-        GetStaticField
+        GetStaticField,
+        DumpFlightRecorder,
+        GetSuppressedFunctions,
+        Detach,
+        GetCoveredFunctions,
+        GetPInvokeStats
     }
 }
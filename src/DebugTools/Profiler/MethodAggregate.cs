@@ -0,0 +1,39 @@
+﻿using System;
+
+namespace DebugTools.Profiler
+{
+    /// <summary>
+    /// Describes the calls to a method that returned during a single interval of continuous profiling.
+    /// </summary>
+    public class MethodAggregate
+    {
+        public IMethodInfo Method { get; }
+
+        public long CallCount { get; }
+
+        /// <summary>
+        /// Gets the time spent executing the method and the methods it called.
+        /// </summary>
+        public TimeSpan InclusiveTime { get; }
+
+        /// <summary>
+        /// Gets the time spent executing the method itself.
+        /// </summary>
+        public TimeSpan ExclusiveTime { get; }
+
+        public MethodAggregate(IMethodInfo method, long callCount, long inclusiveNanoseconds, long exclusiveNanoseconds)
+        {
+            Method = method;
+            CallCount = callCount;
+
+            //A tick is 100 nanoseconds
+            InclusiveTime = TimeSpan.FromTicks(inclusiveNanoseconds / 100);
+            ExclusiveTime = TimeSpan.FromTicks(exclusiveNanoseconds / 100);
+        }
+
+        public override string ToString()
+        {
+            return $"{Method.MethodName}: {CallCount} calls, {ExclusiveTime.TotalMilliseconds}ms";
+        }
+    }
+}
@@ -10,6 +10,16 @@ namespace DebugTools.Profiler
 
         public long Sequence { get; }
 
+        /// <summary>
+        /// Gets the number of CPU cycles the thread spent executing this frame and the frames it called. Only recorded when the profiler is measuring CPU time.
+        /// </summary>
+        public long InclusiveCpuCycles { get; internal set; }
+
+        /// <summary>
+        /// Gets the number of CPU cycles the thread spent executing this frame itself. Only recorded when the profiler is measuring CPU time.
+        /// </summary>
+        public long ExclusiveCpuCycles { get; internal set; }
+
         public List<IMethodFrame> Children { get; set; } = new List<IMethodFrame>();
 
         public int HashCode => GetHashCode();
@@ -25,6 +35,8 @@ namespace DebugTools.Profiler
             Parent = newParent;
             MethodInfo = originalFrame.MethodInfo;
             Sequence = originalFrame.Sequence;
+            InclusiveCpuCycles = originalFrame.InclusiveCpuCycles;
+            ExclusiveCpuCycles = originalFrame.ExclusiveCpuCycles;
         }
 
         public IRootFrame GetRoot()
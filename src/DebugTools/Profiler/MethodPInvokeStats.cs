@@ -0,0 +1,39 @@
+﻿using System;
+
+namespace DebugTools.Profiler
+{
+    /// <summary>
+    /// Describes how long the calls to an unmanaged method took, from the transition out of managed code to the transition back.
+    /// </summary>
+    public class MethodPInvokeStats
+    {
+        public IMethodInfo Method { get; }
+
+        public long CallCount { get; }
+
+        public TimeSpan TotalTime { get; }
+
+        public TimeSpan AverageTime => CallCount == 0 ? TimeSpan.Zero : TimeSpan.FromTicks(TotalTime.Ticks / CallCount);
+
+        /// <summary>
+        /// Gets the number of calls that fell into each bucket of the histogram. Bucket 0 counts calls that took less than a microsecond,
+        /// and each bucket n after that counts calls that took at least 2^(n-1) microseconds but less than 2^n microseconds.
+        /// </summary>
+        public long[] Buckets { get; }
+
+        public MethodPInvokeStats(IMethodInfo method, long callCount, long totalNanoseconds, long[] buckets)
+        {
+            Method = method;
+            CallCount = callCount;
+
+            //A tick is 100 nanoseconds
+            TotalTime = TimeSpan.FromTicks(totalNanoseconds / 100);
+            Buckets = buckets;
+        }
+
+        public override string ToString()
+        {
+            return $"{Method.MethodName}: {CallCount} calls, {AverageTime.TotalMilliseconds}ms average";
+        }
+    }
+}
@@ -122,8 +122,13 @@ namespace DebugTools.Profiler
         /// <summary>
         /// The CLR reported that the field cannot be inspected as it, or its containing class, have not yet been initialized.
         /// </summary>
-        PROFILER_E_STATICFIELD_NOT_INITIALIZED = 0x80041015
+        PROFILER_E_STATICFIELD_NOT_INITIALIZED = 0x80041015,
 
         #endregion
+
+        /// <summary>
+        /// The IL body of a method could not be instrumented as it contained an unexpected instruction or section.
+        /// </summary>
+        PROFILER_E_INVALID_IL = 0x80041016
     }
 }
@@ -12,6 +12,32 @@
         IgnorePointerValue,
         IgnoreDefaultBlacklist,
         SynchronousTransfers,
+        ValuePredicates,
+        ValuePredicateSubtree,
+        FlightRecorder,
+        FlightRecorderPath,
+        FlightRecorderException,
+        FlightRecorderSlowFrame,
+        SnapshotInterval,
+        CoalesceCalls,
+        CollapseRepeatedCalls,
+        SuppressCallRate,
+        SuppressMaxDuration,
+        SkipTrivialMethods,
+        TrivialMethodWhitelist,
+        SampleInterval,
+        StackWalkInterval,
+        ILInstrumentation,
+        PreserveNativeImages,
+        Coverage,
+        CpuTime,
+        OffCpu,
+        CompensateHookOverhead,
+        ContinuousInterval,
+        PInvokeStats,
+        SlowCallThreshold,
+        SlowCallTriggers,
+        UnhookWhenNotTracing,
 
         DisablePipe,
         IncludeUnknownUnmanagedTransitions,
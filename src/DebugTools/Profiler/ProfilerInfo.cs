@@ -101,9 +101,62 @@ namespace DebugTools.Profiler
                 envVariables["CORECLR_PROFILER_PATH_64"] = Profilerx64;
             }
 
-            bool needDebug = false;
+            AddSettingVariables(envVariables, settings, out var needDebug, out var minimized);
+
+            STARTUPINFOA si = new STARTUPINFOA
+            {
+                cb = Marshal.SizeOf<STARTUPINFOA>(),
+            };
+
+            if (minimized)
+            {
+                si.dwFlags = STARTF.STARTF_USESHOWWINDOW;
+                si.wShowWindow = ShowWindow.Minimized;
+            }
+
+            //You MUST ensure all global environment variables are defined; otherwise certain programs that assume these variables exist (such as PowerShell) may crash
+            foreach (DictionaryEntry environmentVariable in Environment.GetEnvironmentVariables())
+                envVariables.Add((string)environmentVariable.Key, (string)environmentVariable.Value);
+
+            var envHandle = GCHandle.Alloc(GetEnvironmentBytes(envVariables), GCHandleType.Pinned);
+            var envPtr = envHandle.AddrOfPinnedObject();
+
+            try
+            {
+                Kernel32.CreateProcessA(
+                    processName,
+                    CreateProcessFlags.CREATE_NEW_CONSOLE | CreateProcessFlags.CREATE_SUSPENDED,
+                    envPtr,
+                    Environment.CurrentDirectory,
+                    ref si,
+                    out var pi
+                );
+
+                var process = Process.GetProcessById(pi.dwProcessId);
+
+                startCallback?.Invoke(process);
+
+                Kernel32.ResumeThread(pi.hThread);
+
+                Kernel32.CloseHandle(pi.hProcess);
+                Kernel32.CloseHandle(pi.hThread);
+
+                if (needDebug)
+                    VsDebugger.Attach(process, VsDebuggerType.Native);
+
+                return process;
+            }
+            finally
+            {
+                envHandle.Free();
+            }
+        }
+
+        private static void AddSettingVariables(StringDictionary envVariables, ProfilerSetting[] settings, out bool needDebug, out bool minimized)
+        {
+            needDebug = false;
+            minimized = false;
             bool ignoreDefaultBlacklist = false;
-            bool minimized = false;
 
             if (settings != null)
             {
@@ -157,6 +210,110 @@ namespace DebugTools.Profiler
                             envVariables.Add("DEBUGTOOLS_SYNCHRONOUS_TRANSFERS", "1");
                             break;
 
+                        case ProfilerEnvFlags.ValuePredicates:
+                            envVariables.Add("DEBUGTOOLS_VALUEPREDICATES", setting.StringValue);
+                            break;
+
+                        case ProfilerEnvFlags.ValuePredicateSubtree:
+                            envVariables.Add("DEBUGTOOLS_VALUEPREDICATE_SUBTREE", "1");
+                            break;
+
+                        case ProfilerEnvFlags.SnapshotInterval:
+                            envVariables.Add("DEBUGTOOLS_SNAPSHOTINTERVAL", setting.StringValue);
+                            break;
+
+                        case ProfilerEnvFlags.CoalesceCalls:
+                            envVariables.Add("DEBUGTOOLS_COALESCE_CALLS", "1");
+                            break;
+
+                        case ProfilerEnvFlags.CollapseRepeatedCalls:
+                            envVariables.Add("DEBUGTOOLS_COLLAPSE_REPEATED_CALLS", "1");
+                            break;
+
+                        case ProfilerEnvFlags.SuppressCallRate:
+                            envVariables.Add("DEBUGTOOLS_SUPPRESS_CALLRATE", setting.StringValue);
+                            break;
+
+                        case ProfilerEnvFlags.SuppressMaxDuration:
+                            envVariables.Add("DEBUGTOOLS_SUPPRESS_MAXDURATION", setting.StringValue);
+                            break;
+
+                        case ProfilerEnvFlags.SkipTrivialMethods:
+                            envVariables.Add("DEBUGTOOLS_SKIP_TRIVIAL_IL", setting.StringValue);
+                            break;
+
+                        case ProfilerEnvFlags.TrivialMethodWhitelist:
+                            envVariables.Add("DEBUGTOOLS_TRIVIALWHITELIST", setting.StringValue);
+                            break;
+
+                        case ProfilerEnvFlags.SampleInterval:
+                            envVariables.Add("DEBUGTOOLS_SAMPLEINTERVAL", setting.StringValue);
+                            break;
+
+                        case ProfilerEnvFlags.StackWalkInterval:
+                            envVariables.Add("DEBUGTOOLS_STACKWALKINTERVAL", setting.StringValue);
+                            break;
+
+                        case ProfilerEnvFlags.ILInstrumentation:
+                            envVariables.Add("DEBUGTOOLS_ILINSTRUMENTATION", "1");
+                            break;
+
+                        case ProfilerEnvFlags.PreserveNativeImages:
+                            envVariables.Add("DEBUGTOOLS_PRESERVE_NATIVE_IMAGES", "1");
+                            break;
+
+                        case ProfilerEnvFlags.Coverage:
+                            envVariables.Add("DEBUGTOOLS_COVERAGE", "1");
+                            break;
+
+                        case ProfilerEnvFlags.CpuTime:
+                            envVariables.Add("DEBUGTOOLS_CPU_TIME", "1");
+                            break;
+
+                        case ProfilerEnvFlags.OffCpu:
+                            envVariables.Add("DEBUGTOOLS_OFFCPU", "1");
+                            break;
+
+                        case ProfilerEnvFlags.CompensateHookOverhead:
+                            envVariables.Add("DEBUGTOOLS_COMPENSATE_HOOK_OVERHEAD", "1");
+                            break;
+
+                        case ProfilerEnvFlags.ContinuousInterval:
+                            envVariables.Add("DEBUGTOOLS_CONTINUOUS_INTERVAL", setting.StringValue);
+                            break;
+
+                        case ProfilerEnvFlags.PInvokeStats:
+                            envVariables.Add("DEBUGTOOLS_PINVOKE_STATS", "1");
+                            break;
+
+                        case ProfilerEnvFlags.SlowCallThreshold:
+                            envVariables.Add("DEBUGTOOLS_SLOW_CALL_THRESHOLD", setting.StringValue);
+                            break;
+
+                        case ProfilerEnvFlags.SlowCallTriggers:
+                            envVariables.Add("DEBUGTOOLS_SLOW_CALL_TRIGGERS", setting.StringValue);
+                            break;
+
+                        case ProfilerEnvFlags.UnhookWhenNotTracing:
+                            envVariables.Add("DEBUGTOOLS_UNHOOK_WHEN_NOT_TRACING", "1");
+                            break;
+
+                        case ProfilerEnvFlags.FlightRecorder:
+                            envVariables.Add("DEBUGTOOLS_FLIGHTRECORDER", setting.StringValue);
+                            break;
+
+                        case ProfilerEnvFlags.FlightRecorderPath:
+                            envVariables.Add("DEBUGTOOLS_FLIGHTRECORDER_PATH", setting.StringValue);
+                            break;
+
+                        case ProfilerEnvFlags.FlightRecorderException:
+                            envVariables.Add("DEBUGTOOLS_FLIGHTRECORDER_EXCEPTION", setting.StringValue);
+                            break;
+
+                        case ProfilerEnvFlags.FlightRecorderSlowFrame:
+                            envVariables.Add("DEBUGTOOLS_FLIGHTRECORDER_SLOWFRAME", setting.StringValue);
+                            break;
+
                         case ProfilerEnvFlags.Minimized:
                             minimized = true;
                             break;
@@ -173,53 +330,42 @@ namespace DebugTools.Profiler
 
             if (ignoreDefaultBlacklist)
                 envVariables.Add("DEBUGTOOLS_IGNORE_DEFAULT_BLACKLIST", "1");
+        }
 
-            STARTUPINFOA si = new STARTUPINFOA
-            {
-                cb = Marshal.SizeOf<STARTUPINFOA>(),
-            };
+        /// <summary>
+        /// Attaches the profiler to a process that is already running. Settings are passed to the profiler as client data, as the environment of the target can no longer be modified.
+        /// </summary>
+        public static void AttachProcess(Process process, ProfilerSetting[] settings)
+        {
+            //We don't pass DEBUGTOOLS_PARENT_PID; the target existed before us and shouldn't be terminated when we exit
+            var envVariables = new StringDictionary();
 
-            if (minimized)
-            {
-                si.dwFlags = STARTF.STARTF_USESHOWWINDOW;
-                si.wShowWindow = ShowWindow.Minimized;
-            }
+            AddSettingVariables(envVariables, settings, out _, out _);
 
-            //You MUST ensure all global environment variables are defined; otherwise certain programs that assume these variables exist (such as PowerShell) may crash
-            foreach (DictionaryEntry environmentVariable in Environment.GetEnvironmentVariables())
-                envVariables.Add((string)environmentVariable.Key, (string)environmentVariable.Value);
+            var profilerPath = Kernel32.IsWow64Process(process.Handle) ? Profilerx86 : Profilerx64;
 
-            var envHandle = GCHandle.Alloc(GetEnvironmentBytes(envVariables), GCHandleType.Pinned);
-            var envPtr = envHandle.AddrOfPinnedObject();
+            if (profilerPath == null)
+                throw new InvalidOperationException($"Cannot attach to process '{process.ProcessName}' ({process.Id}): the profiler DLL for its architecture could not be found.");
+
+            var clientData = GetEnvironmentBytes(envVariables);
+            var clientDataHandle = GCHandle.Alloc(clientData, GCHandleType.Pinned);
 
             try
             {
-                Kernel32.CreateProcessA(
-                    processName,
-                    CreateProcessFlags.CREATE_NEW_CONSOLE | CreateProcessFlags.CREATE_SUSPENDED,
-                    envPtr,
-                    Environment.CurrentDirectory,
-                    ref si,
-                    out var pi
+                var profiling = Mscoree.CreateCLRProfiling();
+
+                profiling.AttachProfiler(
+                    process.Id,
+                    10000,
+                    Guid,
+                    profilerPath,
+                    clientDataHandle.AddrOfPinnedObject(),
+                    clientData.Length
                 );
-
-                var process = Process.GetProcessById(pi.dwProcessId);
-
-                startCallback?.Invoke(process);
-
-                Kernel32.ResumeThread(pi.hThread);
-
-                Kernel32.CloseHandle(pi.hProcess);
-                Kernel32.CloseHandle(pi.hThread);
-
-                if (needDebug)
-                    VsDebugger.Attach(process, VsDebuggerType.Native);
-
-                return process;
             }
             finally
             {
-                envHandle.Free();
+                clientDataHandle.Free();
             }
         }
 
@@ -1,4 +1,5 @@
 ﻿using System;
+using System.Linq;
 using ClrDebug;
 using DebugTools.Tracing;
 
@@ -15,7 +16,10 @@ namespace DebugTools.Profiler
 
             Reader.CallEnter += Parser_CallEnter;
             Reader.CallLeave += Parser_CallLeave;
+            Reader.CallCpuTime += Parser_CallCpuTime;
             Reader.Tailcall += Parser_Tailcall;
+            Reader.CallComplete += Parser_CallComplete;
+            Reader.CallRepeated += Parser_CallRepeated;
 
             Reader.CallEnterDetailed += Parser_CallEnterDetailed;
             Reader.CallLeaveDetailed += Parser_CallLeaveDetailed;
@@ -29,11 +33,23 @@ namespace DebugTools.Profiler
             Reader.ExceptionCompleted += Parser_ExceptionCompleted;
 
             Reader.StaticFieldValue += Parser_StaticFieldValue;
+            Reader.SuppressedFunctions += Parser_SuppressedFunctions;
+            Reader.MethodCovered += Parser_MethodCovered;
+            Reader.CoveredFunctions += Parser_CoveredFunctions;
+            Reader.HookOverhead += v => HookOverheadCycles = v.EnterLeaveCycles;
+            Reader.ContinuousSnapshot += Parser_ContinuousSnapshot;
+            Reader.PInvokeStats += Parser_PInvokeStats;
 
             Reader.ThreadCreate += Parser_ThreadCreate;
             Reader.ThreadDestroy += Parser_ThreadDestroy;
             Reader.ThreadName += Parser_ThreadName;
 
+            Reader.FlightRecorderDump += Parser_FlightRecorderDump;
+            Reader.SlowCall += Parser_SlowCall;
+            Reader.CallStackSnapshot += Parser_CallStackSnapshot;
+            Reader.StackDefined += Parser_StackDefined;
+            Reader.StackSample += Parser_StackSample;
+
             Reader.Shutdown += v =>
             {
                 //If we're monitoring sessions globally, we don't care if a given process exits, we want to keep
@@ -117,6 +133,18 @@ namespace DebugTools.Profiler
         private void Parser_Tailcall(CallArgs args) =>
             CallLeaveCommon(args, (t, v, m) => t.Tailcall(v, m));
 
+        private void Parser_CallCpuTime(CallCpuTimeArgs args)
+        {
+            if (collectStackTrace && ThreadCache.TryGetValue(args.ThreadID, out var threadStack))
+                threadStack.CpuTime(args);
+        }
+
+        private void Parser_CallComplete(CallCompleteArgs args) =>
+            CallEnterCommon(args, (t, v, m) => t.Complete(v, m));
+
+        private void Parser_CallRepeated(CallRepeatedArgs args) =>
+            CallEnterCommon(args, (t, v, m) => t.Repeated(v, m));
+
         private void CallEnterCommon<T>(T args, Func<ThreadStack, T, IMethodInfoInternal, IFrame> addMethod, bool ignoreUnknown = false) where T : ICallArgs
         {
             ProcessStopping(args.TimeStamp);
@@ -258,6 +286,62 @@ namespace DebugTools.Profiler
 
         #endregion
 
+        private void Parser_CallStackSnapshot(CallStackSnapshotArgs args)
+        {
+            ProcessStopping(args.TimeStamp);
+
+            if (collectStackTrace)
+            {
+                if (!ThreadCache.TryGetValue(args.ThreadID, out var threadStack))
+                {
+                    threadStack = new ThreadStack(includeUnknownTransitions, args.ThreadID);
+                    ThreadCache[args.ThreadID] = threadStack;
+                }
+
+                threadStack.Snapshot(args, GetMethodSafe);
+
+                if (threadStack.Root.ThreadName == null)
+                {
+                    if (threadIdToSequenceMap.TryGetValue(args.ThreadID, out var threadSequence) && threadNames.TryGetValue(threadSequence, out var name))
+                        threadStack.Root.ThreadName = name;
+                }
+            }
+        }
+
+        private void Parser_StackDefined(StackDefinedArgs args) => Stacks[args.StackID] = args.Frames;
+
+        private void Parser_StackSample(StackSampleArgs args)
+        {
+            ProcessStopping(args.TimeStamp);
+
+            foreach (var sample in args.Samples)
+            {
+                StackSampleCounts.AddOrUpdate(sample.StackID, 1, (k, v) => v + 1);
+
+                if (sample.OffCpuTime > TimeSpan.Zero)
+                    OffCpuStackTimes.AddOrUpdate(sample.StackID, sample.OffCpuTime, (k, v) => v + sample.OffCpuTime);
+            }
+        }
+
+        private void Parser_FlightRecorderDump(FlightRecorderDumpArgs args)
+        {
+            //Each dump only contains the most recent events the profiler had buffered for each thread, so the events
+            //we're about to receive won't necessarily follow on from anything we've previously seen
+            if (collectStackTrace)
+            {
+                foreach (var threadStack in ThreadCache.Values)
+                    threadStack.Resynchronize();
+            }
+        }
+
+        private void Parser_SlowCall(SlowCallArgs args)
+        {
+            //The events of the calls the thread made since its previous slow call were discarded, so the events that follow
+            //won't continue on from the last sequence we saw
+            if (collectStackTrace && ThreadCache.TryGetValue(args.ThreadID, out var threadStack))
+                threadStack.Resynchronize();
+        }
+
         public void Parser_StaticFieldValue(StaticFieldValueArgs args)
         {
             if (args.HRESULT == HRESULT.S_OK)
@@ -267,5 +351,44 @@ namespace DebugTools.Profiler
 
             staticFieldValueEvent.Set();
         }
+
+        private void Parser_SuppressedFunctions(SuppressedFunctionsArgs args)
+        {
+            suppressedFunctions = args.FunctionIDs;
+
+            suppressedFunctionsEvent.Set();
+        }
+
+        private void Parser_MethodCovered(MethodCoveredArgs args) => CoveredFunctions[args.FunctionID] = 0;
+
+        private void Parser_CoveredFunctions(CoveredFunctionsArgs args)
+        {
+            foreach (var functionId in args.FunctionIDs)
+                CoveredFunctions[functionId] = 0;
+
+            if (args.Final)
+                coveredFunctionsEvent.Set();
+        }
+
+        private void Parser_PInvokeStats(PInvokeStatsArgs args)
+        {
+            pinvokeStats.AddRange(args.PInvokeStats);
+
+            if (args.Final)
+                pinvokeStatsEvent.Set();
+        }
+
+        private void Parser_ContinuousSnapshot(ContinuousSnapshotArgs args)
+        {
+            var methods = args.Functions
+                .Select(v => new MethodAggregate(GetMethodSafe(v.FunctionID), v.CallCount, v.InclusiveNanoseconds, v.ExclusiveNanoseconds))
+                .OrderByDescending(v => v.ExclusiveTime)
+                .ToArray();
+
+            var snapshot = new ContinuousSnapshot(DateTime.Now, args.TotalCalls, methods);
+
+            lock (continuousSnapshotsLock)
+                continuousSnapshots.Add(snapshot);
+        }
     }
 }
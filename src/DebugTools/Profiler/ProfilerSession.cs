@@ -5,6 +5,7 @@ using System.Diagnostics;
 using System.Linq;
 using System.Threading;
 using ClrDebug;
+using DebugTools.Tracing;
 
 namespace DebugTools.Profiler
 {
@@ -44,6 +45,24 @@ namespace DebugTools.Profiler
         //Only populated in detailed mode
         internal ConcurrentDictionary<int, ModuleInfo> Modules { get; } = new ConcurrentDictionary<int, ModuleInfo>();
 
+        //Each stack is only defined once for the lifetime of the process, so unlike the ThreadCache this is never cleared
+        internal ConcurrentDictionary<int, CallStackSnapshotFrame[]> Stacks { get; } = new ConcurrentDictionary<int, CallStackSnapshotFrame[]>();
+
+        //StackID -> Number of times the stack was sampled in the current trace
+        internal ConcurrentDictionary<int, int> StackSampleCounts { get; } = new ConcurrentDictionary<int, int>();
+
+        //StackID -> Total time the sampled threads spent switched out while in the stack
+        internal ConcurrentDictionary<int, TimeSpan> OffCpuStackTimes { get; } = new ConcurrentDictionary<int, TimeSpan>();
+
+        /// <summary>
+        /// Gets the number of CPU cycles the profiler measured a single call to its Enter and Leave hooks to take when it started.
+        /// Only measured when each call is hooked.
+        /// </summary>
+        public long HookOverheadCycles { get; private set; }
+
+        //The FunctionIDs of all functions that have been called at least once in coverage mode. Used as a set
+        internal ConcurrentDictionary<long, byte> CoveredFunctions { get; } = new ConcurrentDictionary<long, byte>();
+
         public Dictionary<int, ThreadStack> ThreadCache { get; } = new Dictionary<int, ThreadStack>();
         private Dictionary<int, int> threadIdToSequenceMap = new Dictionary<int, int>();
         private Dictionary<int, int> threadSequenceToIdMap = new Dictionary<int, int>();
@@ -69,6 +88,16 @@ namespace DebugTools.Profiler
         private object staticFieldLock = new object();
         private Either<object, HRESULT> staticFieldValue;
         private AutoResetEvent staticFieldValueEvent = new AutoResetEvent(false);
+        private object suppressedFunctionsLock = new object();
+        private long[] suppressedFunctions;
+        private AutoResetEvent suppressedFunctionsEvent = new AutoResetEvent(false);
+        private object coveredFunctionsLock = new object();
+        private AutoResetEvent coveredFunctionsEvent = new AutoResetEvent(false);
+        private object pinvokeStatsLock = new object();
+        private List<PInvokeStat> pinvokeStats = new List<PInvokeStat>();
+        private AutoResetEvent pinvokeStatsEvent = new AutoResetEvent(false);
+        private object continuousSnapshotsLock = new object();
+        private List<ContinuousSnapshot> continuousSnapshots = new List<ContinuousSnapshot>();
 
         public ThreadStack[] LastTrace { get; internal set; }
 
@@ -309,6 +338,11 @@ namespace DebugTools.Profiler
                 traceCTS = new CancellationTokenSource();
 
             ThreadCache.Clear();
+            StackSampleCounts.Clear();
+            OffCpuStackTimes.Clear();
+
+            lock (continuousSnapshotsLock)
+                continuousSnapshots.Clear();
 
             if (Target != null && Target.IsAlive)
                 ExecuteCommand(MessageType.EnableTracing, true);
@@ -428,6 +462,102 @@ namespace DebugTools.Profiler
             throw new InvalidOperationException("This code should be unreachable.");
         }
 
+        public void DumpFlightRecorder() => ExecuteCommand(MessageType.DumpFlightRecorder, true);
+
+        /// <summary>
+        /// Requests that the profiler stop tracing and detach from a process it was previously attached to, allowing the process to continue running unprofiled.
+        /// </summary>
+        public void Detach() => ExecuteCommand(MessageType.Detach, true);
+
+        public IMethodInfo[] GetSuppressedFunctions()
+        {
+            lock (suppressedFunctionsLock)
+            {
+                ExecuteCommand(MessageType.GetSuppressedFunctions, true);
+
+                if (!suppressedFunctionsEvent.WaitOne(isDebugged ? -1 : (int) TimeSpan.FromSeconds(5).TotalMilliseconds))
+                    throw new TimeoutException("Timed out waiting for profiler to list suppressed functions");
+
+                return suppressedFunctions.Select(GetMethodSafe).Cast<IMethodInfo>().ToArray();
+            }
+        }
+
+        /// <summary>
+        /// Gets all functions that have been called at least once since the process started. Only available when the profiler is running in coverage mode.
+        /// </summary>
+        public IMethodInfo[] GetCoveredFunctions()
+        {
+            lock (coveredFunctionsLock)
+            {
+                //Functions that were covered while tracing was disabled didn't write a MethodCoveredEvent, so ask for all of them
+                ExecuteCommand(MessageType.GetCoveredFunctions, true);
+
+                if (!coveredFunctionsEvent.WaitOne(isDebugged ? -1 : (int) TimeSpan.FromSeconds(5).TotalMilliseconds))
+                    throw new TimeoutException("Timed out waiting for profiler to list covered functions");
+
+                return CoveredFunctions.Keys.Select(GetMethodSafe).Cast<IMethodInfo>().ToArray();
+            }
+        }
+
+        /// <summary>
+        /// Gets the latency of each unmanaged method that has been called since the process started, ordered by the total time spent in the method.
+        /// Only available when the profiler is recording P/Invoke statistics.
+        /// </summary>
+        public MethodPInvokeStats[] GetPInvokeStats()
+        {
+            lock (pinvokeStatsLock)
+            {
+                pinvokeStats.Clear();
+
+                ExecuteCommand(MessageType.GetPInvokeStats, true);
+
+                if (!pinvokeStatsEvent.WaitOne(isDebugged ? -1 : (int) TimeSpan.FromSeconds(5).TotalMilliseconds))
+                    throw new TimeoutException("Timed out waiting for profiler to list P/Invoke statistics");
+
+                return pinvokeStats
+                    .Select(v => new MethodPInvokeStats(GetMethodSafe(v.FunctionID), v.CallCount, v.TotalNanoseconds, v.Buckets))
+                    .OrderByDescending(v => v.TotalTime)
+                    .ToArray();
+            }
+        }
+
+        /// <summary>
+        /// Gets the snapshots that have been written by the continuous profiler in the current trace, from oldest to newest.
+        /// </summary>
+        public ContinuousSnapshot[] GetContinuousSnapshots()
+        {
+            lock (continuousSnapshotsLock)
+                return continuousSnapshots.ToArray();
+        }
+
+        /// <summary>
+        /// Gets the stacks that were observed by the sampler in the current trace, from the most frequently sampled stack to the least.
+        /// </summary>
+        /// <param name="offCpu">Whether to only include stacks in which threads spent time switched out, ordered from the stack with the most off-CPU time to the least.
+        /// Requires off-CPU sampling to be enabled.</param>
+        public SampledStack[] GetSampledStacks(bool offCpu = false)
+        {
+            var results = new List<SampledStack>();
+
+            foreach (var item in StackSampleCounts)
+            {
+                if (!Stacks.TryGetValue(item.Key, out var frames))
+                    continue;
+
+                OffCpuStackTimes.TryGetValue(item.Key, out var offCpuTime);
+
+                if (offCpu && offCpuTime == TimeSpan.Zero)
+                    continue;
+
+                results.Add(new SampledStack(frames.Select(f => (IMethodInfo) GetMethodSafe(f.FunctionID)).ToArray(), item.Value, offCpuTime));
+            }
+
+            if (offCpu)
+                return results.OrderByDescending(s => s.OffCpuTime).ToArray();
+
+            return results.OrderByDescending(s => s.Count).ToArray();
+        }
+
         public void ExecuteCommand(MessageType messageType, object value) =>
             Target.ExecuteCommand(messageType, value);
 
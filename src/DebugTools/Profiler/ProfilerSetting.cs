@@ -11,6 +11,17 @@
         public static readonly ProfilerSetting IncludeUnknownUnmanagedTransitions = new ProfilerSetting(ProfilerEnvFlags.IncludeUnknownUnmanagedTransitions, null);
         public static readonly ProfilerSetting SynchronousTransfers = new ProfilerSetting(ProfilerEnvFlags.SynchronousTransfers, null);
         public static readonly ProfilerSetting Minimized = new ProfilerSetting(ProfilerEnvFlags.Minimized, null);
+        public static readonly ProfilerSetting ValuePredicateSubtree = new ProfilerSetting(ProfilerEnvFlags.ValuePredicateSubtree, null);
+        public static readonly ProfilerSetting CoalesceCalls = new ProfilerSetting(ProfilerEnvFlags.CoalesceCalls, null);
+        public static readonly ProfilerSetting CollapseRepeatedCalls = new ProfilerSetting(ProfilerEnvFlags.CollapseRepeatedCalls, null);
+        public static readonly ProfilerSetting ILInstrumentation = new ProfilerSetting(ProfilerEnvFlags.ILInstrumentation, null);
+        public static readonly ProfilerSetting PreserveNativeImages = new ProfilerSetting(ProfilerEnvFlags.PreserveNativeImages, null);
+        public static readonly ProfilerSetting Coverage = new ProfilerSetting(ProfilerEnvFlags.Coverage, null);
+        public static readonly ProfilerSetting CpuTime = new ProfilerSetting(ProfilerEnvFlags.CpuTime, null);
+        public static readonly ProfilerSetting OffCpu = new ProfilerSetting(ProfilerEnvFlags.OffCpu, null);
+        public static readonly ProfilerSetting CompensateHookOverhead = new ProfilerSetting(ProfilerEnvFlags.CompensateHookOverhead, null);
+        public static readonly ProfilerSetting PInvokeStats = new ProfilerSetting(ProfilerEnvFlags.PInvokeStats, null);
+        public static readonly ProfilerSetting UnhookWhenNotTracing = new ProfilerSetting(ProfilerEnvFlags.UnhookWhenNotTracing, null);
 
         public ProfilerEnvFlags Flag { get; }
 
@@ -44,6 +55,16 @@
             return ModuleWhitelist(new MatchCollection { { kind, value } });
         }
 
+        public static ProfilerSetting ValuePredicates(ValuePredicateCollection collection)
+        {
+            return new ProfilerSetting(ProfilerEnvFlags.ValuePredicates, collection);
+        }
+
+        public static ProfilerSetting ValuePredicate(string method, string parameter, ValuePredicateKind kind, object value)
+        {
+            return ValuePredicates(new ValuePredicateCollection { { method, parameter, kind, value } });
+        }
+
         public static ProfilerSetting TraceValueDepth(int valueDepth)
         {
             return new ProfilerSetting(ProfilerEnvFlags.TraceValueDepth, valueDepth);
@@ -53,5 +74,85 @@
         {
             return new ProfilerSetting(ProfilerEnvFlags.TargetProcess, targetProcess);
         }
+
+        public static ProfilerSetting SnapshotInterval(int milliseconds)
+        {
+            return new ProfilerSetting(ProfilerEnvFlags.SnapshotInterval, milliseconds);
+        }
+
+        public static ProfilerSetting SuppressCallRate(int callsPerSecond)
+        {
+            return new ProfilerSetting(ProfilerEnvFlags.SuppressCallRate, callsPerSecond);
+        }
+
+        public static ProfilerSetting SuppressMaxDuration(int nanoseconds)
+        {
+            return new ProfilerSetting(ProfilerEnvFlags.SuppressMaxDuration, nanoseconds);
+        }
+
+        public static ProfilerSetting SkipTrivialMethods(int maxILSize)
+        {
+            return new ProfilerSetting(ProfilerEnvFlags.SkipTrivialMethods, maxILSize);
+        }
+
+        public static ProfilerSetting TrivialMethodWhitelist(MatchCollection collection)
+        {
+            return new ProfilerSetting(ProfilerEnvFlags.TrivialMethodWhitelist, collection);
+        }
+
+        public static ProfilerSetting TrivialMethodWhitelist(MatchKind kind, string value)
+        {
+            return TrivialMethodWhitelist(new MatchCollection { { kind, value } });
+        }
+
+        public static ProfilerSetting SampleInterval(int milliseconds)
+        {
+            return new ProfilerSetting(ProfilerEnvFlags.SampleInterval, milliseconds);
+        }
+
+        public static ProfilerSetting StackWalkInterval(int milliseconds)
+        {
+            return new ProfilerSetting(ProfilerEnvFlags.StackWalkInterval, milliseconds);
+        }
+
+        public static ProfilerSetting ContinuousInterval(int milliseconds)
+        {
+            return new ProfilerSetting(ProfilerEnvFlags.ContinuousInterval, milliseconds);
+        }
+
+        public static ProfilerSetting SlowCallThreshold(int milliseconds)
+        {
+            return new ProfilerSetting(ProfilerEnvFlags.SlowCallThreshold, milliseconds);
+        }
+
+        public static ProfilerSetting SlowCallTriggers(MatchCollection collection)
+        {
+            return new ProfilerSetting(ProfilerEnvFlags.SlowCallTriggers, collection);
+        }
+
+        public static ProfilerSetting SlowCallTriggers(MatchKind kind, string value)
+        {
+            return SlowCallTriggers(new MatchCollection { { kind, value } });
+        }
+
+        public static ProfilerSetting FlightRecorder(int bufferSizeMB)
+        {
+            return new ProfilerSetting(ProfilerEnvFlags.FlightRecorder, bufferSizeMB);
+        }
+
+        public static ProfilerSetting FlightRecorderPath(string directory)
+        {
+            return new ProfilerSetting(ProfilerEnvFlags.FlightRecorderPath, directory);
+        }
+
+        public static ProfilerSetting FlightRecorderException(string exceptionType)
+        {
+            return new ProfilerSetting(ProfilerEnvFlags.FlightRecorderException, exceptionType);
+        }
+
+        public static ProfilerSetting FlightRecorderSlowFrame(int thresholdMilliseconds)
+        {
+            return new ProfilerSetting(ProfilerEnvFlags.FlightRecorderSlowFrame, thresholdMilliseconds);
+        }
     }
 }
@@ -16,11 +16,25 @@ namespace DebugTools.Profiler
 
         public ProfilerSetting[] Settings { get; }
 
+        /// <summary>
+        /// Gets whether the profiler should be attached to an existing <see cref="Process"/> rather than starting a new process.
+        /// </summary>
+        public bool Attach { get; }
+
         public LiveProfilerReaderConfig(ProfilerSessionType sessionType, string processName, params ProfilerSetting[] settings)
         {
             SessionType = sessionType;
             ProcessName = processName;
             Settings = settings;
         }
+
+        public LiveProfilerReaderConfig(ProfilerSessionType sessionType, Process process, params ProfilerSetting[] settings)
+        {
+            SessionType = sessionType;
+            Process = process;
+            ProcessName = process.ProcessName;
+            Settings = settings;
+            Attach = true;
+        }
     }
 }
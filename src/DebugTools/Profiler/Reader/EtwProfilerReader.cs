@@ -146,6 +146,96 @@ namespace DebugTools.Profiler
             remove => Parser.Shutdown -= value;
         }
 
+        public event Action<FlightRecorderDumpArgs> FlightRecorderDump
+        {
+            add => Parser.FlightRecorderDump += value;
+            remove => Parser.FlightRecorderDump -= value;
+        }
+
+        public event Action<CallStackSnapshotArgs> CallStackSnapshot
+        {
+            add => Parser.CallStackSnapshot += value;
+            remove => Parser.CallStackSnapshot -= value;
+        }
+
+        public event Action<CallCompleteArgs> CallComplete
+        {
+            add => Parser.CallComplete += value;
+            remove => Parser.CallComplete -= value;
+        }
+
+        public event Action<CallRepeatedArgs> CallRepeated
+        {
+            add => Parser.CallRepeated += value;
+            remove => Parser.CallRepeated -= value;
+        }
+
+        public event Action<FunctionSuppressedArgs> FunctionSuppressed
+        {
+            add => Parser.FunctionSuppressed += value;
+            remove => Parser.FunctionSuppressed -= value;
+        }
+
+        public event Action<SuppressedFunctionsArgs> SuppressedFunctions
+        {
+            add => Parser.SuppressedFunctions += value;
+            remove => Parser.SuppressedFunctions -= value;
+        }
+
+        public event Action<StackDefinedArgs> StackDefined
+        {
+            add => Parser.StackDefined += value;
+            remove => Parser.StackDefined -= value;
+        }
+
+        public event Action<StackSampleArgs> StackSample
+        {
+            add => Parser.StackSample += value;
+            remove => Parser.StackSample -= value;
+        }
+
+        public event Action<MethodCoveredArgs> MethodCovered
+        {
+            add => Parser.MethodCovered += value;
+            remove => Parser.MethodCovered -= value;
+        }
+
+        public event Action<CoveredFunctionsArgs> CoveredFunctions
+        {
+            add => Parser.CoveredFunctions += value;
+            remove => Parser.CoveredFunctions -= value;
+        }
+
+        public event Action<CallCpuTimeArgs> CallCpuTime
+        {
+            add => Parser.CallCpuTime += value;
+            remove => Parser.CallCpuTime -= value;
+        }
+
+        public event Action<HookOverheadArgs> HookOverhead
+        {
+            add => Parser.HookOverhead += value;
+            remove => Parser.HookOverhead -= value;
+        }
+
+        public event Action<ContinuousSnapshotArgs> ContinuousSnapshot
+        {
+            add => Parser.ContinuousSnapshot += value;
+            remove => Parser.ContinuousSnapshot -= value;
+        }
+
+        public event Action<PInvokeStatsArgs> PInvokeStats
+        {
+            add => Parser.PInvokeStats += value;
+            remove => Parser.PInvokeStats -= value;
+        }
+
+        public event Action<SlowCallArgs> SlowCall
+        {
+            add => Parser.SlowCall += value;
+            remove => Parser.SlowCall -= value;
+        }
+
 #pragma warning disable CS0067
         public virtual event Action Completed;
 #pragma warning restore CS0067
@@ -31,7 +31,22 @@ namespace DebugTools.Profiler
             new ThreadArgs(null, 0, 0, null, default, 0, null, default, null), //ThreadCreate 16
             new ThreadArgs(null, 0, 0, null, default, 0, null, default, null), //ThreadDestroy 17
             new ThreadNameArgs(null, 0, 0, null, default, 0, null, default, null), //ThreadName 18
-            new ShutdownArgs(null, 0, 0, null, default, 0, null, default, null) //Shutdown 19
+            new ShutdownArgs(null, 0, 0, null, default, 0, null, default, null), //Shutdown 19
+            new FlightRecorderDumpArgs(null, 0, 0, null, default, 0, null, default, null), //FlightRecorderDump 20
+            new CallStackSnapshotArgs(null, 0, 0, null, default, 0, null, default, null), //CallStackSnapshot 21
+            new CallCompleteArgs(null, 0, 0, null, default, 0, null, default, null), //CallComplete 22
+            new CallRepeatedArgs(null, 0, 0, null, default, 0, null, default, null), //CallRepeated 23
+            new FunctionSuppressedArgs(null, 0, 0, null, default, 0, null, default, null), //FunctionSuppressed 24
+            new SuppressedFunctionsArgs(null, 0, 0, null, default, 0, null, default, null), //SuppressedFunctions 25
+            new StackDefinedArgs(null, 0, 0, null, default, 0, null, default, null), //StackDefined 26
+            new StackSampleArgs(null, 0, 0, null, default, 0, null, default, null), //StackSample 27
+            new MethodCoveredArgs(null, 0, 0, null, default, 0, null, default, null), //MethodCovered 28
+            new CoveredFunctionsArgs(null, 0, 0, null, default, 0, null, default, null), //CoveredFunctions 29
+            new CallCpuTimeArgs(null, 0, 0, null, default, 0, null, default, null), //CallCpuTime 30
+            new HookOverheadArgs(null, 0, 0, null, default, 0, null, default, null), //HookOverhead 31
+            new ContinuousSnapshotArgs(null, 0, 0, null, default, 0, null, default, null), //ContinuousSnapshot 32
+            new PInvokeStatsArgs(null, 0, 0, null, default, 0, null, default, null), //PInvokeStats 33
+            new SlowCallArgs(null, 0, 0, null, default, 0, null, default, null) //SlowCall 34
         };
 
         private static IntPtr eventRecordBuffer;
@@ -46,6 +46,21 @@ namespace DebugTools.Profiler
         public event Action<ThreadArgs> ThreadDestroy;
         public event Action<ThreadNameArgs> ThreadName;
         public event Action<ShutdownArgs> Shutdown;
+        public event Action<FlightRecorderDumpArgs> FlightRecorderDump;
+        public event Action<CallStackSnapshotArgs> CallStackSnapshot;
+        public event Action<CallCompleteArgs> CallComplete;
+        public event Action<CallRepeatedArgs> CallRepeated;
+        public event Action<FunctionSuppressedArgs> FunctionSuppressed;
+        public event Action<SuppressedFunctionsArgs> SuppressedFunctions;
+        public event Action<StackDefinedArgs> StackDefined;
+        public event Action<StackSampleArgs> StackSample;
+        public event Action<MethodCoveredArgs> MethodCovered;
+        public event Action<CoveredFunctionsArgs> CoveredFunctions;
+        public event Action<CallCpuTimeArgs> CallCpuTime;
+        public event Action<HookOverheadArgs> HookOverhead;
+        public event Action<ContinuousSnapshotArgs> ContinuousSnapshot;
+        public event Action<PInvokeStatsArgs> PInvokeStats;
+        public event Action<SlowCallArgs> SlowCall;
         public event Action Completed;
 #pragma warning enable CS0067
     }
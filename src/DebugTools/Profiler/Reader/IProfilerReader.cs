@@ -45,6 +45,36 @@ namespace DebugTools.Profiler
 
         event Action<ShutdownArgs> Shutdown;
 
+        event Action<FlightRecorderDumpArgs> FlightRecorderDump;
+
+        event Action<CallStackSnapshotArgs> CallStackSnapshot;
+
+        event Action<CallCompleteArgs> CallComplete;
+
+        event Action<CallRepeatedArgs> CallRepeated;
+
+        event Action<FunctionSuppressedArgs> FunctionSuppressed;
+
+        event Action<SuppressedFunctionsArgs> SuppressedFunctions;
+
+        event Action<StackDefinedArgs> StackDefined;
+
+        event Action<StackSampleArgs> StackSample;
+
+        event Action<MethodCoveredArgs> MethodCovered;
+
+        event Action<CoveredFunctionsArgs> CoveredFunctions;
+
+        event Action<CallCpuTimeArgs> CallCpuTime;
+
+        event Action<HookOverheadArgs> HookOverhead;
+
+        event Action<ContinuousSnapshotArgs> ContinuousSnapshot;
+
+        event Action<PInvokeStatsArgs> PInvokeStats;
+
+        event Action<SlowCallArgs> SlowCall;
+
         event Action Completed;
     }
 }
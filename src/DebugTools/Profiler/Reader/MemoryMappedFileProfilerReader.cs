@@ -30,6 +30,21 @@ namespace DebugTools.Profiler
         public event Action<ThreadArgs> ThreadDestroy;
         public event Action<ThreadNameArgs> ThreadName;
         public event Action<ShutdownArgs> Shutdown;
+        public event Action<FlightRecorderDumpArgs> FlightRecorderDump;
+        public event Action<CallStackSnapshotArgs> CallStackSnapshot;
+        public event Action<CallCompleteArgs> CallComplete;
+        public event Action<CallRepeatedArgs> CallRepeated;
+        public event Action<FunctionSuppressedArgs> FunctionSuppressed;
+        public event Action<SuppressedFunctionsArgs> SuppressedFunctions;
+        public event Action<StackDefinedArgs> StackDefined;
+        public event Action<StackSampleArgs> StackSample;
+        public event Action<MethodCoveredArgs> MethodCovered;
+        public event Action<CoveredFunctionsArgs> CoveredFunctions;
+        public event Action<CallCpuTimeArgs> CallCpuTime;
+        public event Action<HookOverheadArgs> HookOverhead;
+        public event Action<ContinuousSnapshotArgs> ContinuousSnapshot;
+        public event Action<PInvokeStatsArgs> PInvokeStats;
+        public event Action<SlowCallArgs> SlowCall;
         public event Action Completed;
 #pragma warning restore CS0067
 
@@ -195,6 +210,66 @@ namespace DebugTools.Profiler
                     Shutdown?.Invoke((ShutdownArgs)data);
                     break;
 
+                case ProfilerTraceEventParser.EventId.FlightRecorderDump:
+                    FlightRecorderDump?.Invoke((FlightRecorderDumpArgs)data);
+                    break;
+
+                case ProfilerTraceEventParser.EventId.CallStackSnapshot:
+                    CallStackSnapshot?.Invoke((CallStackSnapshotArgs)data);
+                    break;
+
+                case ProfilerTraceEventParser.EventId.CallComplete:
+                    CallComplete?.Invoke((CallCompleteArgs)data);
+                    break;
+
+                case ProfilerTraceEventParser.EventId.CallRepeated:
+                    CallRepeated?.Invoke((CallRepeatedArgs)data);
+                    break;
+
+                case ProfilerTraceEventParser.EventId.FunctionSuppressed:
+                    FunctionSuppressed?.Invoke((FunctionSuppressedArgs)data);
+                    break;
+
+                case ProfilerTraceEventParser.EventId.SuppressedFunctions:
+                    SuppressedFunctions?.Invoke((SuppressedFunctionsArgs)data);
+                    break;
+
+                case ProfilerTraceEventParser.EventId.StackDefined:
+                    StackDefined?.Invoke((StackDefinedArgs)data);
+                    break;
+
+                case ProfilerTraceEventParser.EventId.StackSample:
+                    StackSample?.Invoke((StackSampleArgs)data);
+                    break;
+
+                case ProfilerTraceEventParser.EventId.MethodCovered:
+                    MethodCovered?.Invoke((MethodCoveredArgs)data);
+                    break;
+
+                case ProfilerTraceEventParser.EventId.CoveredFunctions:
+                    CoveredFunctions?.Invoke((CoveredFunctionsArgs)data);
+                    break;
+
+                case ProfilerTraceEventParser.EventId.CallCpuTime:
+                    CallCpuTime?.Invoke((CallCpuTimeArgs)data);
+                    break;
+
+                case ProfilerTraceEventParser.EventId.HookOverhead:
+                    HookOverhead?.Invoke((HookOverheadArgs)data);
+                    break;
+
+                case ProfilerTraceEventParser.EventId.ContinuousSnapshot:
+                    ContinuousSnapshot?.Invoke((ContinuousSnapshotArgs)data);
+                    break;
+
+                case ProfilerTraceEventParser.EventId.PInvokeStats:
+                    PInvokeStats?.Invoke((PInvokeStatsArgs)data);
+                    break;
+
+                case ProfilerTraceEventParser.EventId.SlowCall:
+                    SlowCall?.Invoke((SlowCallArgs)data);
+                    break;
+
                 default:
                     throw new NotImplementedException($"Don't know how to handle event '{eventType}'.");
             }
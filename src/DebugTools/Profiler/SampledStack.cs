@@ -0,0 +1,34 @@
+﻿using System;
+
+namespace DebugTools.Profiler
+{
+    /// <summary>
+    /// Describes a stack that was observed by the sampler, and how many times it was observed.
+    /// </summary>
+    public class SampledStack
+    {
+        /// <summary>
+        /// Gets the frames of the stack, from the outermost frame to the innermost.
+        /// </summary>
+        public IMethodInfo[] Frames { get; }
+
+        public int Count { get; }
+
+        /// <summary>
+        /// Gets the total time threads spent switched out while in this stack. Only measured when off-CPU sampling is enabled.
+        /// </summary>
+        public TimeSpan OffCpuTime { get; }
+
+        public SampledStack(IMethodInfo[] frames, int count, TimeSpan offCpuTime)
+        {
+            Frames = frames;
+            Count = count;
+            OffCpuTime = offCpuTime;
+        }
+
+        public override string ToString()
+        {
+            return $"{Count}: {(Frames.Length > 0 ? Frames[Frames.Length - 1].MethodName : "<empty>")}";
+        }
+    }
+}
@@ -33,12 +33,22 @@ namespace DebugTools.Profiler
         {
             pipeCTS = CancellationTokenSource.CreateLinkedTokenSource(cancellationToken);
 
-            ProfilerInfo.CreateProcess(config.ProcessName, p =>
+            if (config.Attach)
             {
-                config.Process = p;
-
+                //The process is already running, so there's no window in which it's suspended. Start listening before the profiler begins sending events
                 startCallback();
-            }, config.Settings);
+
+                ProfilerInfo.AttachProcess(config.Process, config.Settings);
+            }
+            else
+            {
+                ProfilerInfo.CreateProcess(config.ProcessName, p =>
+                {
+                    config.Process = p;
+
+                    startCallback();
+                }, config.Settings);
+            }
 
             var sw = new Stopwatch();
             sw.Start();
@@ -216,7 +226,8 @@ namespace DebugTools.Profiler
         {
             pipe?.Dispose();
 
-            if (IsAlive)
+            //We didn't start the process, so it's not ours to kill
+            if (IsAlive && !config.Attach)
             {
                 try
                 {
@@ -58,6 +58,60 @@ namespace DebugTools.Profiler
             EndCallInternal();
         }
 
+        public void CpuTime(CallCpuTimeArgs args)
+        {
+            //The CPU time of a frame is written immediately before the event that ends it
+            if (Current is MethodFrame m && m.MethodInfo.FunctionID.Value == args.FunctionID)
+            {
+                m.InclusiveCpuCycles = args.InclusiveCycles;
+                m.ExclusiveCpuCycles = args.ExclusiveCycles;
+            }
+        }
+
+        #endregion
+        #region CallCompleteArgs
+
+        public IFrame Complete(CallCompleteArgs args, IMethodInfo method)
+        {
+            ValidateSequence(args);
+
+            var newFrame = new MethodFrame(method, args.Sequence);
+
+            if (Current == null)
+                Current = new RootFrame { ThreadId = args.ThreadID };
+
+            newFrame.Parent = Current;
+            Current.Children.Add(newFrame);
+
+            //A complete event stands in for both an enter and a leave, so has consumed two sequence numbers
+            lastSequence = args.Sequence + 1;
+
+            return newFrame;
+        }
+
+        public IFrame Repeated(CallRepeatedArgs args, IMethodInfo method)
+        {
+            ValidateSequence(args);
+
+            if (Current == null)
+                Current = new RootFrame { ThreadId = args.ThreadID };
+
+            //Expand the run back into the individual calls it represents, so that the tree looks the same as if the calls had never been collapsed
+            MethodFrame newFrame = null;
+
+            for (var i = 0; i < args.Count; i++)
+            {
+                newFrame = new MethodFrame(method, args.Sequence + i * 2);
+
+                newFrame.Parent = Current;
+                Current.Children.Add(newFrame);
+            }
+
+            lastSequence = args.Sequence + args.Count * 2 - 1;
+
+            return newFrame;
+        }
+
         #endregion
         #region CallArgsDetailed
 
@@ -136,6 +190,64 @@ namespace DebugTools.Profiler
             EndCallInternal();
         }
 
+        #endregion
+        #region CallStackSnapshot
+
+        internal void Snapshot(CallStackSnapshotArgs args, Func<long, IMethodInfoInternal> getMethod)
+        {
+            var frames = args.Frames;
+
+            //If we've been tracing the entire time, the frames we have open will already match the snapshot.
+            //Otherwise, we start a new branch from the root containing the frames that are currently active
+            if (!IsActive(frames))
+            {
+                if (Current == null)
+                    Current = new RootFrame { ThreadId = args.ThreadID };
+                else
+                    Current = Root;
+
+                foreach (var frame in frames)
+                {
+                    var method = getMethod(frame.FunctionID);
+
+                    MethodFrame newFrame;
+
+                    if (frame.Kind == FrameKind.Managed)
+                        newFrame = new MethodFrame(method, args.Sequence);
+                    else
+                    {
+                        //LeaveUnmanagedTransition won't try and leave these frames either
+                        if (method.WasUnknown && !includeUnknownTransitions)
+                            continue;
+
+                        newFrame = new UnmanagedTransitionFrame(method, args.Sequence, frame.Kind);
+                    }
+
+                    newFrame.Parent = Current;
+                    Current.Children.Add(newFrame);
+
+                    Current = newFrame;
+                }
+            }
+
+            lastSequence = args.Sequence;
+        }
+
+        private bool IsActive(CallStackSnapshotFrame[] frames)
+        {
+            var frame = Current;
+
+            for (var i = frames.Length - 1; i >= 0; i--)
+            {
+                if (!(frame is IMethodFrame m) || m.MethodInfo.FunctionID.Value != frames[i].FunctionID)
+                    return false;
+
+                frame = frame.Parent;
+            }
+
+            return frame == null || frame is IRootFrame;
+        }
+
         #endregion
         #region Exception
 
@@ -176,6 +288,18 @@ namespace DebugTools.Profiler
 
         #endregion
 
+        /// <summary>
+        /// Discards any frames that are still open and stops validating the sequence of the next call event.<para/>
+        /// Used when the profiler is known to have dropped events, such as when the flight recorder has been dumped.
+        /// </summary>
+        public void Resynchronize()
+        {
+            if (Current != null)
+                Current = Root;
+
+            lastSequence = 0;
+        }
+
         private void EndCallInternal()
         {
             if (!(Current is IRootFrame))
@@ -0,0 +1,48 @@
+﻿using System.Collections;
+using System.Collections.Generic;
+using System.Text;
+
+namespace DebugTools.Profiler
+{
+    /// <summary>
+    /// Specifies how the value of a parameter is compared against the value of a predicate. Strings are compared case-insensitively.
+    /// </summary>
+    public enum ValuePredicateKind
+    {
+        Equals = 1,
+        NotEquals,
+        Contains
+    }
+
+    public class ValuePredicateCollection : IEnumerable
+    {
+        private List<(string method, string parameter, ValuePredicateKind kind, string value)> list = new List<(string method, string parameter, ValuePredicateKind kind, string value)>();
+
+        public void Add(string method, string parameter, ValuePredicateKind kind, object value)
+        {
+            list.Add((method, parameter, kind, value?.ToString() ?? string.Empty));
+        }
+
+        public override string ToString()
+        {
+            var builder = new StringBuilder();
+
+            foreach (var item in list)
+            {
+                builder.Append((char) item.kind);
+                builder.Append(item.method);
+                builder.Append('\t');
+                builder.Append(item.parameter);
+                builder.Append('\t');
+                builder.Append(item.value);
+                builder.Append('\t');
+            }
+
+            builder.Append('\t');
+
+            return builder.ToString();
+        }
+
+        public IEnumerator GetEnumerator() => list.GetEnumerator();
+    }
+}
@@ -0,0 +1,86 @@
+﻿using System;
+using System.Diagnostics;
+using System.Text;
+using ClrDebug;
+using DebugTools.Profiler;
+using Microsoft.Diagnostics.Tracing;
+
+namespace DebugTools.Tracing
+{
+    /// <summary>
+    /// Describes the CallCompleteArgs template defined in DebugToolsProfiler.man
+    /// </summary>
+    public sealed class CallCompleteArgs : TraceEvent, ICallArgs
+    {
+        public long FunctionID => GetInt64At(0);
+
+        public long Sequence => GetInt64At(8);
+
+        public HRESULT HRESULT => (HRESULT) GetInt32At(16);
+
+        /// <summary>
+        /// Gets the amount of time the call took, measured in 100ns ticks.
+        /// </summary>
+        public TimeSpan Duration => new TimeSpan(GetInt64At(20));
+
+        private Action<CallCompleteArgs> action;
+
+        internal CallCompleteArgs(Action<CallCompleteArgs> action, int eventID, int task, string taskName, Guid taskGuid, int opcode, string opcodeName, Guid providerGuid, string providerName) :
+            base(eventID, task, taskName, taskGuid, opcode, opcodeName, providerGuid, providerName)
+        {
+            this.action = action;
+        }
+
+        protected override Delegate Target
+        {
+            get => action;
+            set => action = (Action<CallCompleteArgs>) value;
+        }
+
+        public override string[] PayloadNames
+        {
+            get
+            {
+                if (payloadNames == null)
+                    payloadNames = new[] { nameof(FunctionID), nameof(Sequence), nameof(HRESULT), nameof(Duration) };
+
+                return payloadNames;
+            }
+        }
+
+        public override object PayloadValue(int index)
+        {
+            switch (index)
+            {
+                case 0:
+                    return FunctionID;
+
+                case 1:
+                    return Sequence;
+
+                case 2:
+                    return HRESULT;
+
+                case 3:
+                    return Duration;
+
+                default:
+                    Debug.Assert(false, $"Unknown payload field '{index}'");
+                    return null;
+            }
+        }
+
+        public override StringBuilder ToXml(StringBuilder sb)
+        {
+            Prefix(sb);
+            XmlAttrib(sb, nameof(FunctionID), FunctionID);
+            XmlAttrib(sb, nameof(Sequence), Sequence);
+            XmlAttrib(sb, nameof(HRESULT), HRESULT);
+            XmlAttrib(sb, nameof(Duration), Duration.Ticks);
+            sb.Append("/>");
+            return sb;
+        }
+
+        protected override void Dispatch() => action(this);
+    }
+}
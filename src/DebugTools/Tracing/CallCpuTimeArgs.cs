@@ -0,0 +1,81 @@
+﻿using System;
+using System.Diagnostics;
+using System.Text;
+using Microsoft.Diagnostics.Tracing;
+
+namespace DebugTools.Tracing
+{
+    /// <summary>
+    /// Describes the CallCpuTimeArgs template defined in DebugToolsProfiler.man
+    /// </summary>
+    public sealed class CallCpuTimeArgs : TraceEvent
+    {
+        public long FunctionID => GetInt64At(0);
+
+        /// <summary>
+        /// Gets the number of CPU cycles the thread spent executing the frame, including any frames it called.
+        /// </summary>
+        public long InclusiveCycles => GetInt64At(8);
+
+        /// <summary>
+        /// Gets the number of CPU cycles the thread spent executing the frame itself, excluding any frames it called.
+        /// </summary>
+        public long ExclusiveCycles => GetInt64At(16);
+
+        private Action<CallCpuTimeArgs> action;
+
+        internal CallCpuTimeArgs(Action<CallCpuTimeArgs> action, int eventID, int task, string taskName, Guid taskGuid, int opcode, string opcodeName, Guid providerGuid, string providerName) :
+            base(eventID, task, taskName, taskGuid, opcode, opcodeName, providerGuid, providerName)
+        {
+            this.action = action;
+        }
+
+        protected override Delegate Target
+        {
+            get => action;
+            set => action = (Action<CallCpuTimeArgs>) value;
+        }
+
+        public override string[] PayloadNames
+        {
+            get
+            {
+                if (payloadNames == null)
+                    payloadNames = new[] { nameof(FunctionID), nameof(InclusiveCycles), nameof(ExclusiveCycles) };
+
+                return payloadNames;
+            }
+        }
+
+        public override object PayloadValue(int index)
+        {
+            switch (index)
+            {
+                case 0:
+                    return FunctionID;
+
+                case 1:
+                    return InclusiveCycles;
+
+                case 2:
+                    return ExclusiveCycles;
+
+                default:
+                    Debug.Assert(false, $"Unknown payload field '{index}'");
+                    return null;
+            }
+        }
+
+        public override StringBuilder ToXml(StringBuilder sb)
+        {
+            Prefix(sb);
+            XmlAttrib(sb, nameof(FunctionID), FunctionID);
+            XmlAttrib(sb, nameof(InclusiveCycles), InclusiveCycles);
+            XmlAttrib(sb, nameof(ExclusiveCycles), ExclusiveCycles);
+            sb.Append("/>");
+            return sb;
+        }
+
+        protected override void Dispatch() => action(this);
+    }
+}
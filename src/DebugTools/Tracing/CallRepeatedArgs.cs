@@ -0,0 +1,100 @@
+﻿using System;
+using System.Diagnostics;
+using System.Text;
+using ClrDebug;
+using Microsoft.Diagnostics.Tracing;
+
+namespace DebugTools.Tracing
+{
+    /// <summary>
+    /// Describes the CallRepeatedArgs template defined in DebugToolsProfiler.man
+    /// </summary>
+    public sealed class CallRepeatedArgs : TraceEvent, ICallArgs
+    {
+        public long FunctionID => GetInt64At(0);
+
+        public long Sequence => GetInt64At(8);
+
+        /// <summary>
+        /// Gets the number of consecutive calls that were made. Each call consumes two sequence numbers, starting from <see cref="Sequence"/>.
+        /// </summary>
+        public int Count => GetInt32At(16);
+
+        public TimeSpan TotalDuration => new TimeSpan(GetInt64At(20));
+
+        public TimeSpan MinDuration => new TimeSpan(GetInt64At(28));
+
+        public TimeSpan MaxDuration => new TimeSpan(GetInt64At(36));
+
+        //Only calls that succeeded are ever collapsed
+        HRESULT ICallArgs.HRESULT => HRESULT.S_OK;
+
+        private Action<CallRepeatedArgs> action;
+
+        internal CallRepeatedArgs(Action<CallRepeatedArgs> action, int eventID, int task, string taskName, Guid taskGuid, int opcode, string opcodeName, Guid providerGuid, string providerName) :
+            base(eventID, task, taskName, taskGuid, opcode, opcodeName, providerGuid, providerName)
+        {
+            this.action = action;
+        }
+
+        protected override Delegate Target
+        {
+            get => action;
+            set => action = (Action<CallRepeatedArgs>) value;
+        }
+
+        public override string[] PayloadNames
+        {
+            get
+            {
+                if (payloadNames == null)
+                    payloadNames = new[] { nameof(FunctionID), nameof(Sequence), nameof(Count), nameof(TotalDuration), nameof(MinDuration), nameof(MaxDuration) };
+
+                return payloadNames;
+            }
+        }
+
+        public override object PayloadValue(int index)
+        {
+            switch (index)
+            {
+                case 0:
+                    return FunctionID;
+
+                case 1:
+                    return Sequence;
+
+                case 2:
+                    return Count;
+
+                case 3:
+                    return TotalDuration;
+
+                case 4:
+                    return MinDuration;
+
+                case 5:
+                    return MaxDuration;
+
+                default:
+                    Debug.Assert(false, $"Unknown payload field '{index}'");
+                    return null;
+            }
+        }
+
+        public override StringBuilder ToXml(StringBuilder sb)
+        {
+            Prefix(sb);
+            XmlAttrib(sb, nameof(FunctionID), FunctionID);
+            XmlAttrib(sb, nameof(Sequence), Sequence);
+            XmlAttrib(sb, nameof(Count), Count);
+            XmlAttrib(sb, nameof(TotalDuration), TotalDuration.Ticks);
+            XmlAttrib(sb, nameof(MinDuration), MinDuration.Ticks);
+            XmlAttrib(sb, nameof(MaxDuration), MaxDuration.Ticks);
+            sb.Append("/>");
+            return sb;
+        }
+
+        protected override void Dispatch() => action(this);
+    }
+}
@@ -0,0 +1,104 @@
+﻿using System;
+using System.Diagnostics;
+using System.Text;
+using DebugTools.Profiler;
+using Microsoft.Diagnostics.Tracing;
+
+namespace DebugTools.Tracing
+{
+    /// <summary>
+    /// Describes the CallStackSnapshotArgs template defined in DebugToolsProfiler.man
+    /// </summary>
+    public sealed class CallStackSnapshotArgs : TraceEvent
+    {
+        //Each frame is serialized as a FunctionID followed by a FrameKind
+        private const int FrameSize = sizeof(long) + sizeof(int);
+
+        /// <summary>
+        /// Gets the sequence of the last call event that was written on the thread prior to this snapshot.
+        /// </summary>
+        public long Sequence => GetInt64At(0);
+
+        public int FramesLength => GetInt32At(8);
+
+        /// <summary>
+        /// Gets the frames that were active on the thread at the time of the snapshot, from the outermost frame to the innermost.
+        /// </summary>
+        public CallStackSnapshotFrame[] Frames
+        {
+            get
+            {
+                var bytes = GetByteArrayAt(12, FramesLength);
+
+                var frames = new CallStackSnapshotFrame[bytes.Length / FrameSize];
+
+                for (var i = 0; i < frames.Length; i++)
+                {
+                    var offset = i * FrameSize;
+
+                    frames[i] = new CallStackSnapshotFrame(
+                        BitConverter.ToInt64(bytes, offset),
+                        (FrameKind) BitConverter.ToInt32(bytes, offset + sizeof(long))
+                    );
+                }
+
+                return frames;
+            }
+        }
+
+        private Action<CallStackSnapshotArgs> action;
+
+        internal CallStackSnapshotArgs(Action<CallStackSnapshotArgs> action, int eventID, int task, string taskName, Guid taskGuid, int opcode, string opcodeName, Guid providerGuid, string providerName) :
+            base(eventID, task, taskName, taskGuid, opcode, opcodeName, providerGuid, providerName)
+        {
+            this.action = action;
+        }
+
+        protected override Delegate Target
+        {
+            get => action;
+            set => action = (Action<CallStackSnapshotArgs>) value;
+        }
+
+        public override string[] PayloadNames
+        {
+            get
+            {
+                if (payloadNames == null)
+                    payloadNames = new[] { nameof(Sequence), nameof(FramesLength), nameof(Frames) };
+
+                return payloadNames;
+            }
+        }
+
+        public override object PayloadValue(int index)
+        {
+            switch (index)
+            {
+                case 0:
+                    return Sequence;
+
+                case 1:
+                    return FramesLength;
+
+                case 2:
+                    return Frames;
+
+                default:
+                    Debug.Assert(false, $"Unknown payload field '{index}'");
+                    return null;
+            }
+        }
+
+        public override StringBuilder ToXml(StringBuilder sb)
+        {
+            Prefix(sb);
+            XmlAttrib(sb, nameof(Sequence), Sequence);
+            XmlAttrib(sb, nameof(FramesLength), FramesLength);
+            sb.Append("/>");
+            return sb;
+        }
+
+        protected override void Dispatch() => action(this);
+    }
+}
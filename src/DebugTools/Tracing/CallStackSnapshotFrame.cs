@@ -0,0 +1,22 @@
+﻿using DebugTools.Profiler;
+
+namespace DebugTools.Tracing
+{
+    public struct CallStackSnapshotFrame
+    {
+        public long FunctionID { get; }
+
+        public FrameKind Kind { get; }
+
+        public CallStackSnapshotFrame(long functionId, FrameKind kind)
+        {
+            FunctionID = functionId;
+            Kind = kind;
+        }
+
+        public override string ToString()
+        {
+            return $"{FunctionID:X} ({Kind})";
+        }
+    }
+}
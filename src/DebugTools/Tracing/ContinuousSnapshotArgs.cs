@@ -0,0 +1,103 @@
+﻿using System;
+using System.Diagnostics;
+using System.Text;
+using Microsoft.Diagnostics.Tracing;
+
+namespace DebugTools.Tracing
+{
+    /// <summary>
+    /// Describes the ContinuousSnapshotArgs template defined in DebugToolsProfiler.man
+    /// </summary>
+    public sealed class ContinuousSnapshotArgs : TraceEvent
+    {
+        /// <summary>
+        /// Gets the total number of calls that returned during the interval, including calls to functions that were not included in the snapshot.
+        /// </summary>
+        public long TotalCalls => GetInt64At(0);
+
+        public int FunctionsLength => GetInt32At(8);
+
+        /// <summary>
+        /// Gets the functions that were called the most, or that took the most time, during the interval.
+        /// </summary>
+        public FunctionAggregate[] Functions
+        {
+            get
+            {
+                var bytes = GetByteArrayAt(12, FunctionsLength);
+
+                //Each function is serialized as its FunctionID, call count, inclusive nanoseconds and exclusive nanoseconds
+                var functions = new FunctionAggregate[bytes.Length / (sizeof(long) * 4)];
+
+                for (var i = 0; i < functions.Length; i++)
+                {
+                    var offset = i * sizeof(long) * 4;
+
+                    functions[i] = new FunctionAggregate(
+                        BitConverter.ToInt64(bytes, offset),
+                        BitConverter.ToInt64(bytes, offset + sizeof(long)),
+                        BitConverter.ToInt64(bytes, offset + sizeof(long) * 2),
+                        BitConverter.ToInt64(bytes, offset + sizeof(long) * 3)
+                    );
+                }
+
+                return functions;
+            }
+        }
+
+        private Action<ContinuousSnapshotArgs> action;
+
+        internal ContinuousSnapshotArgs(Action<ContinuousSnapshotArgs> action, int eventID, int task, string taskName, Guid taskGuid, int opcode, string opcodeName, Guid providerGuid, string providerName) :
+            base(eventID, task, taskName, taskGuid, opcode, opcodeName, providerGuid, providerName)
+        {
+            this.action = action;
+        }
+
+        protected override Delegate Target
+        {
+            get => action;
+            set => action = (Action<ContinuousSnapshotArgs>) value;
+        }
+
+        public override string[] PayloadNames
+        {
+            get
+            {
+                if (payloadNames == null)
+                    payloadNames = new[] { nameof(TotalCalls), nameof(FunctionsLength), nameof(Functions) };
+
+                return payloadNames;
+            }
+        }
+
+        public override object PayloadValue(int index)
+        {
+            switch (index)
+            {
+                case 0:
+                    return TotalCalls;
+
+                case 1:
+                    return FunctionsLength;
+
+                case 2:
+                    return Functions;
+
+                default:
+                    Debug.Assert(false, $"Unknown payload field '{index}'");
+                    return null;
+            }
+        }
+
+        public override StringBuilder ToXml(StringBuilder sb)
+        {
+            Prefix(sb);
+            XmlAttrib(sb, nameof(TotalCalls), TotalCalls);
+            XmlAttrib(sb, nameof(FunctionsLength), FunctionsLength);
+            sb.Append("/>");
+            return sb;
+        }
+
+        protected override void Dispatch() => action(this);
+    }
+}
@@ -0,0 +1,93 @@
+﻿using System;
+using System.Diagnostics;
+using System.Text;
+using Microsoft.Diagnostics.Tracing;
+
+namespace DebugTools.Tracing
+{
+    /// <summary>
+    /// Describes the CoveredFunctionsArgs template defined in DebugToolsProfiler.man
+    /// </summary>
+    public sealed class CoveredFunctionsArgs : TraceEvent
+    {
+        /// <summary>
+        /// Gets whether this is the last event written in response to a single request for the covered functions.
+        /// </summary>
+        public bool Final => GetInt32At(0) != 0;
+
+        public int FunctionIDsLength => GetInt32At(4);
+
+        /// <summary>
+        /// Gets the FunctionIDs of the functions that had been covered at the time the event was written. Large sets of functions are split across multiple events.
+        /// </summary>
+        public long[] FunctionIDs
+        {
+            get
+            {
+                var bytes = GetByteArrayAt(8, FunctionIDsLength);
+
+                var functionIds = new long[bytes.Length / sizeof(long)];
+
+                for (var i = 0; i < functionIds.Length; i++)
+                    functionIds[i] = BitConverter.ToInt64(bytes, i * sizeof(long));
+
+                return functionIds;
+            }
+        }
+
+        private Action<CoveredFunctionsArgs> action;
+
+        internal CoveredFunctionsArgs(Action<CoveredFunctionsArgs> action, int eventID, int task, string taskName, Guid taskGuid, int opcode, string opcodeName, Guid providerGuid, string providerName) :
+            base(eventID, task, taskName, taskGuid, opcode, opcodeName, providerGuid, providerName)
+        {
+            this.action = action;
+        }
+
+        protected override Delegate Target
+        {
+            get => action;
+            set => action = (Action<CoveredFunctionsArgs>) value;
+        }
+
+        public override string[] PayloadNames
+        {
+            get
+            {
+                if (payloadNames == null)
+                    payloadNames = new[] { nameof(Final), nameof(FunctionIDsLength), nameof(FunctionIDs) };
+
+                return payloadNames;
+            }
+        }
+
+        public override object PayloadValue(int index)
+        {
+            switch (index)
+            {
+                case 0:
+                    return Final;
+
+                case 1:
+                    return FunctionIDsLength;
+
+                case 2:
+                    return FunctionIDs;
+
+                default:
+                    Debug.Assert(false, $"Unknown payload field '{index}'");
+                    return null;
+            }
+        }
+
+        public override StringBuilder ToXml(StringBuilder sb)
+        {
+            Prefix(sb);
+            XmlAttrib(sb, nameof(Final), Final);
+            XmlAttrib(sb, nameof(FunctionIDsLength), FunctionIDsLength);
+            sb.Append("/>");
+            return sb;
+        }
+
+        protected override void Dispatch() => action(this);
+    }
+}
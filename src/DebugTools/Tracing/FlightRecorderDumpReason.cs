@@ -0,0 +1,13 @@
+﻿namespace DebugTools.Tracing
+{
+    /// <summary>
+    /// Specifies what caused the profiler's flight recorder to be dumped.<para/>
+    /// Keep in sync with CFlightRecorder.h
+    /// </summary>
+    public enum FlightRecorderDumpReason
+    {
+        Exception = 0,
+        Command,
+        SlowFrame
+    }
+}
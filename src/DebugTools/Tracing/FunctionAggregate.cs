@@ -0,0 +1,26 @@
+﻿namespace DebugTools.Tracing
+{
+    public struct FunctionAggregate
+    {
+        public long FunctionID { get; }
+
+        public long CallCount { get; }
+
+        public long InclusiveNanoseconds { get; }
+
+        public long ExclusiveNanoseconds { get; }
+
+        public FunctionAggregate(long functionId, long callCount, long inclusiveNanoseconds, long exclusiveNanoseconds)
+        {
+            FunctionID = functionId;
+            CallCount = callCount;
+            InclusiveNanoseconds = inclusiveNanoseconds;
+            ExclusiveNanoseconds = exclusiveNanoseconds;
+        }
+
+        public override string ToString()
+        {
+            return $"{FunctionID:X}: {CallCount} calls, {ExclusiveNanoseconds}ns exclusive";
+        }
+    }
+}
@@ -0,0 +1,90 @@
+﻿using System;
+using System.Diagnostics;
+using System.Text;
+using Microsoft.Diagnostics.Tracing;
+
+namespace DebugTools.Tracing
+{
+    /// <summary>
+    /// Describes the FunctionSuppressedArgs template defined in DebugToolsProfiler.man
+    /// </summary>
+    public sealed class FunctionSuppressedArgs : TraceEvent
+    {
+        public long FunctionID => GetInt64At(0);
+
+        /// <summary>
+        /// Gets the total number of times the function had been called at the time it was suppressed.
+        /// </summary>
+        public long CallCount => GetInt64At(8);
+
+        /// <summary>
+        /// Gets the number of calls per second that were made to the function in the measurement window that caused it to be suppressed.
+        /// </summary>
+        public long CallRate => GetInt64At(16);
+
+        /// <summary>
+        /// Gets the average duration of each call to the function in the measurement window that caused it to be suppressed, in nanoseconds.
+        /// </summary>
+        public long AverageDuration => GetInt64At(24);
+
+        private Action<FunctionSuppressedArgs> action;
+
+        internal FunctionSuppressedArgs(Action<FunctionSuppressedArgs> action, int eventID, int task, string taskName, Guid taskGuid, int opcode, string opcodeName, Guid providerGuid, string providerName) :
+            base(eventID, task, taskName, taskGuid, opcode, opcodeName, providerGuid, providerName)
+        {
+            this.action = action;
+        }
+
+        protected override Delegate Target
+        {
+            get => action;
+            set => action = (Action<FunctionSuppressedArgs>) value;
+        }
+
+        public override string[] PayloadNames
+        {
+            get
+            {
+                if (payloadNames == null)
+                    payloadNames = new[] { nameof(FunctionID), nameof(CallCount), nameof(CallRate), nameof(AverageDuration) };
+
+                return payloadNames;
+            }
+        }
+
+        public override object PayloadValue(int index)
+        {
+            switch (index)
+            {
+                case 0:
+                    return FunctionID;
+
+                case 1:
+                    return CallCount;
+
+                case 2:
+                    return CallRate;
+
+                case 3:
+                    return AverageDuration;
+
+                default:
+                    Debug.Assert(false, $"Unknown payload field '{index}'");
+                    return null;
+            }
+        }
+
+        public override StringBuilder ToXml(StringBuilder sb)
+        {
+            Prefix(sb);
+            XmlAttrib(sb, nameof(FunctionID), FunctionID);
+            XmlAttrib(sb, nameof(CallCount), CallCount);
+            XmlAttrib(sb, nameof(CallRate), CallRate);
+            XmlAttrib(sb, nameof(AverageDuration), AverageDuration);
+            sb.Append("/>");
+            return sb;
+        }
+
+        protected override void Dispatch() => action(this);
+    }
+}
@@ -0,0 +1,66 @@
+﻿using System;
+using System.Diagnostics;
+using System.Text;
+using Microsoft.Diagnostics.Tracing;
+
+namespace DebugTools.Tracing
+{
+    /// <summary>
+    /// Describes the HookOverheadArgs template defined in DebugToolsProfiler.man
+    /// </summary>
+    public sealed class HookOverheadArgs : TraceEvent
+    {
+        /// <summary>
+        /// Gets the number of CPU cycles the profiler measured a single call to its Enter and Leave hooks to take.
+        /// </summary>
+        public long EnterLeaveCycles => GetInt64At(0);
+
+        private Action<HookOverheadArgs> action;
+
+        internal HookOverheadArgs(Action<HookOverheadArgs> action, int eventID, int task, string taskName, Guid taskGuid, int opcode, string opcodeName, Guid providerGuid, string providerName) :
+            base(eventID, task, taskName, taskGuid, opcode, opcodeName, providerGuid, providerName)
+        {
+            this.action = action;
+        }
+
+        protected override Delegate Target
+        {
+            get => action;
+            set => action = (Action<HookOverheadArgs>) value;
+        }
+
+        public override string[] PayloadNames
+        {
+            get
+            {
+                if (payloadNames == null)
+                    payloadNames = new[] { nameof(EnterLeaveCycles) };
+
+                return payloadNames;
+            }
+        }
+
+        public override object PayloadValue(int index)
+        {
+            switch (index)
+            {
+                case 0:
+                    return EnterLeaveCycles;
+
+                default:
+                    Debug.Assert(false, $"Unknown payload field '{index}'");
+                    return null;
+            }
+        }
+
+        public override StringBuilder ToXml(StringBuilder sb)
+        {
+            Prefix(sb);
+            XmlAttrib(sb, nameof(EnterLeaveCycles), EnterLeaveCycles);
+            sb.Append("/>");
+            return sb;
+        }
+
+        protected override void Dispatch() => action(this);
+    }
+}
@@ -0,0 +1,30 @@
+﻿namespace DebugTools.Tracing
+{
+    public struct PInvokeStat
+    {
+        public long FunctionID { get; }
+
+        public long CallCount { get; }
+
+        public long TotalNanoseconds { get; }
+
+        /// <summary>
+        /// Gets the number of calls that fell into each bucket of the histogram. Bucket 0 counts calls that took less than a microsecond,
+        /// and each bucket n after that counts calls that took at least 2^(n-1) microseconds but less than 2^n microseconds.
+        /// </summary>
+        public long[] Buckets { get; }
+
+        public PInvokeStat(long functionId, long callCount, long totalNanoseconds, long[] buckets)
+        {
+            FunctionID = functionId;
+            CallCount = callCount;
+            TotalNanoseconds = totalNanoseconds;
+            Buckets = buckets;
+        }
+
+        public override string ToString()
+        {
+            return $"{FunctionID:X}: {CallCount} calls, {TotalNanoseconds}ns";
+        }
+    }
+}
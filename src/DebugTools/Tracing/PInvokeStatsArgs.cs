@@ -0,0 +1,112 @@
+﻿using System;
+using System.Diagnostics;
+using System.Text;
+using Microsoft.Diagnostics.Tracing;
+
+namespace DebugTools.Tracing
+{
+    /// <summary>
+    /// Describes the PInvokeStatsArgs template defined in DebugToolsProfiler.man
+    /// </summary>
+    public sealed class PInvokeStatsArgs : TraceEvent
+    {
+        //Keep in sync with PINVOKE_HISTOGRAM_BUCKETS
+        private const int BucketCount = 32;
+
+        /// <summary>
+        /// Gets whether this is the last event written in response to a single request for the P/Invoke statistics.
+        /// </summary>
+        public bool Final => GetInt32At(0) != 0;
+
+        public int PInvokeStatsLength => GetInt32At(4);
+
+        /// <summary>
+        /// Gets the latency histogram of each unmanaged function that had been called at the time the event was written. Large sets of functions are split across multiple events.
+        /// </summary>
+        public PInvokeStat[] PInvokeStats
+        {
+            get
+            {
+                var bytes = GetByteArrayAt(8, PInvokeStatsLength);
+
+                //Each function is serialized as its FunctionID, call count, total nanoseconds and each bucket of its histogram
+                var size = sizeof(long) * (3 + BucketCount);
+                var stats = new PInvokeStat[bytes.Length / size];
+
+                for (var i = 0; i < stats.Length; i++)
+                {
+                    var offset = i * size;
+
+                    var buckets = new long[BucketCount];
+
+                    for (var j = 0; j < BucketCount; j++)
+                        buckets[j] = BitConverter.ToInt64(bytes, offset + sizeof(long) * (3 + j));
+
+                    stats[i] = new PInvokeStat(
+                        BitConverter.ToInt64(bytes, offset),
+                        BitConverter.ToInt64(bytes, offset + sizeof(long)),
+                        BitConverter.ToInt64(bytes, offset + sizeof(long) * 2),
+                        buckets
+                    );
+                }
+
+                return stats;
+            }
+        }
+
+        private Action<PInvokeStatsArgs> action;
+
+        internal PInvokeStatsArgs(Action<PInvokeStatsArgs> action, int eventID, int task, string taskName, Guid taskGuid, int opcode, string opcodeName, Guid providerGuid, string providerName) :
+            base(eventID, task, taskName, taskGuid, opcode, opcodeName, providerGuid, providerName)
+        {
+            this.action = action;
+        }
+
+        protected override Delegate Target
+        {
+            get => action;
+            set => action = (Action<PInvokeStatsArgs>) value;
+        }
+
+        public override string[] PayloadNames
+        {
+            get
+            {
+                if (payloadNames == null)
+                    payloadNames = new[] { nameof(Final), nameof(PInvokeStatsLength), nameof(PInvokeStats) };
+
+                return payloadNames;
+            }
+        }
+
+        public override object PayloadValue(int index)
+        {
+            switch (index)
+            {
+                case 0:
+                    return Final;
+
+                case 1:
+                    return PInvokeStatsLength;
+
+                case 2:
+                    return PInvokeStats;
+
+                default:
+                    Debug.Assert(false, $"Unknown payload field '{index}'");
+                    return null;
+            }
+        }
+
+        public override StringBuilder ToXml(StringBuilder sb)
+        {
+            Prefix(sb);
+            XmlAttrib(sb, nameof(Final), Final);
+            XmlAttrib(sb, nameof(PInvokeStatsLength), PInvokeStatsLength);
+            sb.Append("/>");
+            return sb;
+        }
+
+        protected override void Dispatch() => action(this);
+    }
+}
@@ -34,6 +34,36 @@ namespace DebugTools.Tracing
             public const int ThreadName = 18;
 
             public const int Shutdown = 19;
+
+            public const int FlightRecorderDump = 20;
+
+            public const int CallStackSnapshot = 21;
+
+            public const int CallComplete = 22;
+
+            public const int CallRepeated = 23;
+
+            public const int FunctionSuppressed = 24;
+
+            public const int SuppressedFunctions = 25;
+
+            public const int StackDefined = 26;
+
+            public const int StackSample = 27;
+
+            public const int MethodCovered = 28;
+
+            public const int CoveredFunctions = 29;
+
+            public const int CallCpuTime = 30;
+
+            public const int HookOverhead = 31;
+
+            public const int ContinuousSnapshot = 32;
+
+            public const int PInvokeStats = 33;
+
+            public const int SlowCall = 34;
         }
 
         /// <summary>
@@ -164,6 +194,96 @@ namespace DebugTools.Tracing
             remove => source.UnregisterEventTemplate(value, EventId.Shutdown, ProviderGuid);
         }
 
+        public event Action<FlightRecorderDumpArgs> FlightRecorderDump
+        {
+            add => source.RegisterEventTemplate(FlightRecorderDumpTemplate(value));
+            remove => source.UnregisterEventTemplate(value, EventId.FlightRecorderDump, ProviderGuid);
+        }
+
+        public event Action<CallStackSnapshotArgs> CallStackSnapshot
+        {
+            add => source.RegisterEventTemplate(CallStackSnapshotTemplate(value));
+            remove => source.UnregisterEventTemplate(value, EventId.CallStackSnapshot, ProviderGuid);
+        }
+
+        public event Action<CallCompleteArgs> CallComplete
+        {
+            add => source.RegisterEventTemplate(CallCompleteTemplate(value));
+            remove => source.UnregisterEventTemplate(value, EventId.CallComplete, ProviderGuid);
+        }
+
+        public event Action<CallRepeatedArgs> CallRepeated
+        {
+            add => source.RegisterEventTemplate(CallRepeatedTemplate(value));
+            remove => source.UnregisterEventTemplate(value, EventId.CallRepeated, ProviderGuid);
+        }
+
+        public event Action<FunctionSuppressedArgs> FunctionSuppressed
+        {
+            add => source.RegisterEventTemplate(FunctionSuppressedTemplate(value));
+            remove => source.UnregisterEventTemplate(value, EventId.FunctionSuppressed, ProviderGuid);
+        }
+
+        public event Action<SuppressedFunctionsArgs> SuppressedFunctions
+        {
+            add => source.RegisterEventTemplate(SuppressedFunctionsTemplate(value));
+            remove => source.UnregisterEventTemplate(value, EventId.SuppressedFunctions, ProviderGuid);
+        }
+
+        public event Action<StackDefinedArgs> StackDefined
+        {
+            add => source.RegisterEventTemplate(StackDefinedTemplate(value));
+            remove => source.UnregisterEventTemplate(value, EventId.StackDefined, ProviderGuid);
+        }
+
+        public event Action<StackSampleArgs> StackSample
+        {
+            add => source.RegisterEventTemplate(StackSampleTemplate(value));
+            remove => source.UnregisterEventTemplate(value, EventId.StackSample, ProviderGuid);
+        }
+
+        public event Action<MethodCoveredArgs> MethodCovered
+        {
+            add => source.RegisterEventTemplate(MethodCoveredTemplate(value));
+            remove => source.UnregisterEventTemplate(value, EventId.MethodCovered, ProviderGuid);
+        }
+
+        public event Action<CoveredFunctionsArgs> CoveredFunctions
+        {
+            add => source.RegisterEventTemplate(CoveredFunctionsTemplate(value));
+            remove => source.UnregisterEventTemplate(value, EventId.CoveredFunctions, ProviderGuid);
+        }
+
+        public event Action<CallCpuTimeArgs> CallCpuTime
+        {
+            add => source.RegisterEventTemplate(CallCpuTimeTemplate(value));
+            remove => source.UnregisterEventTemplate(value, EventId.CallCpuTime, ProviderGuid);
+        }
+
+        public event Action<HookOverheadArgs> HookOverhead
+        {
+            add => source.RegisterEventTemplate(HookOverheadTemplate(value));
+            remove => source.UnregisterEventTemplate(value, EventId.HookOverhead, ProviderGuid);
+        }
+
+        public event Action<ContinuousSnapshotArgs> ContinuousSnapshot
+        {
+            add => source.RegisterEventTemplate(ContinuousSnapshotTemplate(value));
+            remove => source.UnregisterEventTemplate(value, EventId.ContinuousSnapshot, ProviderGuid);
+        }
+
+        public event Action<PInvokeStatsArgs> PInvokeStats
+        {
+            add => source.RegisterEventTemplate(PInvokeStatsTemplate(value));
+            remove => source.UnregisterEventTemplate(value, EventId.PInvokeStats, ProviderGuid);
+        }
+
+        public event Action<SlowCallArgs> SlowCall
+        {
+            add => source.RegisterEventTemplate(SlowCallTemplate(value));
+            remove => source.UnregisterEventTemplate(value, EventId.SlowCall, ProviderGuid);
+        }
+
         #endregion
 
         public ProfilerTraceEventParser(TraceEventSource source, bool dontRegister = false) : base(source, dontRegister)
@@ -204,7 +324,37 @@ namespace DebugTools.Tracing
                     ThreadDestroyTemplate(null),
                     ThreadNameTemplate(null),
 
-                    ShutdownTemplate(null)
+                    ShutdownTemplate(null),
+
+                    FlightRecorderDumpTemplate(null),
+
+                    CallStackSnapshotTemplate(null),
+
+                    CallCompleteTemplate(null),
+
+                    CallRepeatedTemplate(null),
+
+                    FunctionSuppressedTemplate(null),
+
+                    SuppressedFunctionsTemplate(null),
+
+                    StackDefinedTemplate(null),
+
+                    StackSampleTemplate(null),
+
+                    MethodCoveredTemplate(null),
+
+                    CoveredFunctionsTemplate(null),
+
+                    CallCpuTimeTemplate(null),
+
+                    HookOverheadTemplate(null),
+
+                    ContinuousSnapshotTemplate(null),
+
+                    PInvokeStatsTemplate(null),
+
+                    SlowCallTemplate(null)
                 };
             }
 
@@ -255,6 +405,36 @@ namespace DebugTools.Tracing
 
         public static ShutdownArgs ShutdownTemplate(Action<ShutdownArgs> action) => new ShutdownArgs(action, EventId.Shutdown, 0, null, Guid.Empty, 0, null, ProviderGuid, ProviderName);
 
+        private static FlightRecorderDumpArgs FlightRecorderDumpTemplate(Action<FlightRecorderDumpArgs> action) => new FlightRecorderDumpArgs(action, EventId.FlightRecorderDump, 0, null, Guid.Empty, 0, null, ProviderGuid, ProviderName);
+
+        private static CallStackSnapshotArgs CallStackSnapshotTemplate(Action<CallStackSnapshotArgs> action) => new CallStackSnapshotArgs(action, EventId.CallStackSnapshot, 0, null, Guid.Empty, 0, null, ProviderGuid, ProviderName);
+
+        private static CallCompleteArgs CallCompleteTemplate(Action<CallCompleteArgs> action) => new CallCompleteArgs(action, EventId.CallComplete, 0, null, Guid.Empty, 0, null, ProviderGuid, ProviderName);
+
+        private static CallRepeatedArgs CallRepeatedTemplate(Action<CallRepeatedArgs> action) => new CallRepeatedArgs(action, EventId.CallRepeated, 0, null, Guid.Empty, 0, null, ProviderGuid, ProviderName);
+
+        private static FunctionSuppressedArgs FunctionSuppressedTemplate(Action<FunctionSuppressedArgs> action) => new FunctionSuppressedArgs(action, EventId.FunctionSuppressed, 0, null, Guid.Empty, 0, null, ProviderGuid, ProviderName);
+
+        private static SuppressedFunctionsArgs SuppressedFunctionsTemplate(Action<SuppressedFunctionsArgs> action) => new SuppressedFunctionsArgs(action, EventId.SuppressedFunctions, 0, null, Guid.Empty, 0, null, ProviderGuid, ProviderName);
+
+        private static StackDefinedArgs StackDefinedTemplate(Action<StackDefinedArgs> action) => new StackDefinedArgs(action, EventId.StackDefined, 0, null, Guid.Empty, 0, null, ProviderGuid, ProviderName);
+
+        private static StackSampleArgs StackSampleTemplate(Action<StackSampleArgs> action) => new StackSampleArgs(action, EventId.StackSample, 0, null, Guid.Empty, 0, null, ProviderGuid, ProviderName);
+
+        private static MethodCoveredArgs MethodCoveredTemplate(Action<MethodCoveredArgs> action) => new MethodCoveredArgs(action, EventId.MethodCovered, 0, null, Guid.Empty, 0, null, ProviderGuid, ProviderName);
+
+        private static CoveredFunctionsArgs CoveredFunctionsTemplate(Action<CoveredFunctionsArgs> action) => new CoveredFunctionsArgs(action, EventId.CoveredFunctions, 0, null, Guid.Empty, 0, null, ProviderGuid, ProviderName);
+
+        private static CallCpuTimeArgs CallCpuTimeTemplate(Action<CallCpuTimeArgs> action) => new CallCpuTimeArgs(action, EventId.CallCpuTime, 0, null, Guid.Empty, 0, null, ProviderGuid, ProviderName);
+
+        private static HookOverheadArgs HookOverheadTemplate(Action<HookOverheadArgs> action) => new HookOverheadArgs(action, EventId.HookOverhead, 0, null, Guid.Empty, 0, null, ProviderGuid, ProviderName);
+
+        private static ContinuousSnapshotArgs ContinuousSnapshotTemplate(Action<ContinuousSnapshotArgs> action) => new ContinuousSnapshotArgs(action, EventId.ContinuousSnapshot, 0, null, Guid.Empty, 0, null, ProviderGuid, ProviderName);
+
+        private static PInvokeStatsArgs PInvokeStatsTemplate(Action<PInvokeStatsArgs> action) => new PInvokeStatsArgs(action, EventId.PInvokeStats, 0, null, Guid.Empty, 0, null, ProviderGuid, ProviderName);
+
+        private static SlowCallArgs SlowCallTemplate(Action<SlowCallArgs> action) => new SlowCallArgs(action, EventId.SlowCall, 0, null, Guid.Empty, 0, null, ProviderGuid, ProviderName);
+
         #endregion
     }
 }
@@ -0,0 +1,104 @@
+﻿using System;
+using System.Diagnostics;
+using System.Text;
+using DebugTools.Profiler;
+using Microsoft.Diagnostics.Tracing;
+
+namespace DebugTools.Tracing
+{
+    /// <summary>
+    /// Describes the StackDefinedArgs template defined in DebugToolsProfiler.man
+    /// </summary>
+    public sealed class StackDefinedArgs : TraceEvent
+    {
+        //Each frame is serialized as a FunctionID followed by a FrameKind
+        private const int FrameSize = sizeof(long) + sizeof(int);
+
+        /// <summary>
+        /// Gets the ID that other events use to refer to this stack.
+        /// </summary>
+        public int StackID => GetInt32At(0);
+
+        public int FramesLength => GetInt32At(4);
+
+        /// <summary>
+        /// Gets the frames of the stack, from the outermost frame to the innermost.
+        /// </summary>
+        public CallStackSnapshotFrame[] Frames
+        {
+            get
+            {
+                var bytes = GetByteArrayAt(8, FramesLength);
+
+                var frames = new CallStackSnapshotFrame[bytes.Length / FrameSize];
+
+                for (var i = 0; i < frames.Length; i++)
+                {
+                    var offset = i * FrameSize;
+
+                    frames[i] = new CallStackSnapshotFrame(
+                        BitConverter.ToInt64(bytes, offset),
+                        (FrameKind) BitConverter.ToInt32(bytes, offset + sizeof(long))
+                    );
+                }
+
+                return frames;
+            }
+        }
+
+        private Action<StackDefinedArgs> action;
+
+        internal StackDefinedArgs(Action<StackDefinedArgs> action, int eventID, int task, string taskName, Guid taskGuid, int opcode, string opcodeName, Guid providerGuid, string providerName) :
+            base(eventID, task, taskName, taskGuid, opcode, opcodeName, providerGuid, providerName)
+        {
+            this.action = action;
+        }
+
+        protected override Delegate Target
+        {
+            get => action;
+            set => action = (Action<StackDefinedArgs>) value;
+        }
+
+        public override string[] PayloadNames
+        {
+            get
+            {
+                if (payloadNames == null)
+                    payloadNames = new[] { nameof(StackID), nameof(FramesLength), nameof(Frames) };
+
+                return payloadNames;
+            }
+        }
+
+        public override object PayloadValue(int index)
+        {
+            switch (index)
+            {
+                case 0:
+                    return StackID;
+
+                case 1:
+                    return FramesLength;
+
+                case 2:
+                    return Frames;
+
+                default:
+                    Debug.Assert(false, $"Unknown payload field '{index}'");
+                    return null;
+            }
+        }
+
+        public override StringBuilder ToXml(StringBuilder sb)
+        {
+            Prefix(sb);
+            XmlAttrib(sb, nameof(StackID), StackID);
+            XmlAttrib(sb, nameof(FramesLength), FramesLength);
+            sb.Append("/>");
+            return sb;
+        }
+
+        protected override void Dispatch() => action(this);
+    }
+}
@@ -0,0 +1,28 @@
+﻿using System;
+
+namespace DebugTools.Tracing
+{
+    public struct StackSample
+    {
+        public int ThreadID { get; }
+
+        public int StackID { get; }
+
+        /// <summary>
+        /// Gets the time the thread spent switched out during the interval leading up to the sample. Only measured when off-CPU sampling is enabled.
+        /// </summary>
+        public TimeSpan OffCpuTime { get; }
+
+        public StackSample(int threadId, int stackId, TimeSpan offCpuTime)
+        {
+            ThreadID = threadId;
+            StackID = stackId;
+            OffCpuTime = offCpuTime;
+        }
+
+        public override string ToString()
+        {
+            return $"{ThreadID}: {StackID}";
+        }
+    }
+}
@@ -0,0 +1,93 @@
+﻿using System;
+using System.Diagnostics;
+using System.Text;
+using Microsoft.Diagnostics.Tracing;
+
+namespace DebugTools.Tracing
+{
+    /// <summary>
+    /// Describes the StackSampleArgs template defined in DebugToolsProfiler.man
+    /// </summary>
+    public sealed class StackSampleArgs : TraceEvent
+    {
+        public int SamplesLength => GetInt32At(0);
+
+        /// <summary>
+        /// Gets the stack of each thread that was inside a hooked function at the time the sample was taken.
+        /// </summary>
+        public StackSample[] Samples
+        {
+            get
+            {
+                var bytes = GetByteArrayAt(4, SamplesLength);
+
+                //Each sample is serialized as a ThreadID, a StackID and the number of microseconds the thread was off-CPU
+                var samples = new StackSample[bytes.Length / (sizeof(int) * 3)];
+
+                for (var i = 0; i < samples.Length; i++)
+                {
+                    var offset = i * sizeof(int) * 3;
+
+                    samples[i] = new StackSample(
+                        BitConverter.ToInt32(bytes, offset),
+                        BitConverter.ToInt32(bytes, offset + sizeof(int)),
+                        TimeSpan.FromTicks(BitConverter.ToUInt32(bytes, offset + sizeof(int) * 2) * TimeSpan.TicksPerMillisecond / 1000)
+                    );
+                }
+
+                return samples;
+            }
+        }
+
+        private Action<StackSampleArgs> action;
+
+        internal StackSampleArgs(Action<StackSampleArgs> action, int eventID, int task, string taskName, Guid taskGuid, int opcode, string opcodeName, Guid providerGuid, string providerName) :
+            base(eventID, task, taskName, taskGuid, opcode, opcodeName, providerGuid, providerName)
+        {
+            this.action = action;
+        }
+
+        protected override Delegate Target
+        {
+            get => action;
+            set => action = (Action<StackSampleArgs>) value;
+        }
+
+        public override string[] PayloadNames
+        {
+            get
+            {
+                if (payloadNames == null)
+                    payloadNames = new[] { nameof(SamplesLength), nameof(Samples) };
+
+                return payloadNames;
+            }
+        }
+
+        public override object PayloadValue(int index)
+        {
+            switch (index)
+            {
+                case 0:
+                    return SamplesLength;
+
+                case 1:
+                    return Samples;
+
+                default:
+                    Debug.Assert(false, $"Unknown payload field '{index}'");
+                    return null;
+            }
+        }
+
+        public override StringBuilder ToXml(StringBuilder sb)
+        {
+            Prefix(sb);
+            XmlAttrib(sb, nameof(SamplesLength), SamplesLength);
+            sb.Append("/>");
+            return sb;
+        }
+
+        protected override void Dispatch() => action(this);
+    }
+}
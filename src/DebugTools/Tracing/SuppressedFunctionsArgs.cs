@@ -0,0 +1,84 @@
+﻿using System;
+using System.Diagnostics;
+using System.Text;
+using Microsoft.Diagnostics.Tracing;
+
+namespace DebugTools.Tracing
+{
+    /// <summary>
+    /// Describes the SuppressedFunctionsArgs template defined in DebugToolsProfiler.man
+    /// </summary>
+    public sealed class SuppressedFunctionsArgs : TraceEvent
+    {
+        public int FunctionIDsLength => GetInt32At(0);
+
+        /// <summary>
+        /// Gets the FunctionIDs of all functions that had been suppressed at the time the event was written.
+        /// </summary>
+        public long[] FunctionIDs
+        {
+            get
+            {
+                var bytes = GetByteArrayAt(4, FunctionIDsLength);
+
+                var functionIds = new long[bytes.Length / sizeof(long)];
+
+                for (var i = 0; i < functionIds.Length; i++)
+                    functionIds[i] = BitConverter.ToInt64(bytes, i * sizeof(long));
+
+                return functionIds;
+            }
+        }
+
+        private Action<SuppressedFunctionsArgs> action;
+
+        internal SuppressedFunctionsArgs(Action<SuppressedFunctionsArgs> action, int eventID, int task, string taskName, Guid taskGuid, int opcode, string opcodeName, Guid providerGuid, string providerName) :
+            base(eventID, task, taskName, taskGuid, opcode, opcodeName, providerGuid, providerName)
+        {
+            this.action = action;
+        }
+
+        protected override Delegate Target
+        {
+            get => action;
+            set => action = (Action<SuppressedFunctionsArgs>) value;
+        }
+
+        public override string[] PayloadNames
+        {
+            get
+            {
+                if (payloadNames == null)
+                    payloadNames = new[] { nameof(FunctionIDsLength), nameof(FunctionIDs) };
+
+                return payloadNames;
+            }
+        }
+
+        public override object PayloadValue(int index)
+        {
+            switch (index)
+            {
+                case 0:
+                    return FunctionIDsLength;
+
+                case 1:
+                    return FunctionIDs;
+
+                default:
+                    Debug.Assert(false, $"Unknown payload field '{index}'");
+                    return null;
+            }
+        }
+
+        public override StringBuilder ToXml(StringBuilder sb)
+        {
+            Prefix(sb);
+            XmlAttrib(sb, nameof(FunctionIDsLength), FunctionIDsLength);
+            sb.Append("/>");
+            return sb;
+        }
+
+        protected override void Dispatch() => action(this);
+    }
+}
@@ -20,6 +20,23 @@ namespace Profiler.Benchmarks
             return 1;
         }
 
+        //Reports the cost of a single call, which in the ELT job (where the profiler is loaded but tracing hasn't been started)
+        //is the cost of the idle path through the hooks
+        [Benchmark(OperationsPerInvoke = 10)]
+        public void CallTenTimes()
+        {
+            DoNothingInternal();
+            DoNothingInternal();
+            DoNothingInternal();
+            DoNothingInternal();
+            DoNothingInternal();
+            DoNothingInternal();
+            DoNothingInternal();
+            DoNothingInternal();
+            DoNothingInternal();
+            DoNothingInternal();
+        }
+
         [Benchmark]
         public void TakeString()
         {
@@ -32,6 +49,11 @@ namespace Profiler.Benchmarks
             TakeAndReturnString(Input);
         }
 
+        [MethodImpl(MethodImplOptions.NoInlining)]
+        private void DoNothingInternal()
+        {
+        }
+
         [MethodImpl(MethodImplOptions.NoInlining)]
         private void TakeStringInternal(string str)
         {
@@ -16,6 +16,7 @@ namespace Profiler.Benchmarks
 
         private static EnvironmentVariable EnvTraceStart = new EnvironmentVariable("DEBUGTOOLS_TRACESTART", "1");
         private static EnvironmentVariable EnvDetailed = new EnvironmentVariable("DEBUGTOOLS_DETAILED", "1");
+        private static EnvironmentVariable EnvCoverage = new EnvironmentVariable("DEBUGTOOLS_COVERAGE", "1");
 
         private static EnvironmentVariable EnvModuleBlacklist()
         {
@@ -69,9 +70,16 @@ namespace Profiler.Benchmarks
                 EnvTraceStart,
                 EnvDetailed
             )).WithId("Detailed_TraceStart"));
+
+            //Once each benchmark has been covered its hooks are disabled, which measures the cost of the naked hooks'
+            //early return compared to the Normal job
+            AddJob(defaultJob.WithEnvironmentVariables(BuildEnvVars(
+                EnvTraceStart,
+                EnvCoverage
+            )).WithId("Coverage_TraceStart"));
         }
 
-        private EnvironmentVariable[] BuildEnvVars(params EnvironmentVariable[] additionalVars)
+        internal static EnvironmentVariable[] BuildEnvVars(params EnvironmentVariable[] additionalVars)
         {
             var list = new List<EnvironmentVariable>
             {
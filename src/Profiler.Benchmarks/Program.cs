@@ -6,7 +6,14 @@ namespace Profiler.Benchmarks
     {
         static void Main(string[] args)
         {
-            var summary = BenchmarkRunner.Run<ProfilerBenchmarks>(args: args);
+            //StartupBenchmarks launches us as the process whose startup is measured
+            if (args.Length > 0 && args[0] == StartupBenchmarks.StartupArg)
+            {
+                StartupBenchmarks.Startup();
+                return;
+            }
+
+            var summary = BenchmarkRunner.Run(new[] { typeof(ProfilerBenchmarks), typeof(StartupBenchmarks) }, args: args);
         }
     }
 }
@@ -0,0 +1,87 @@
+﻿using System;
+using System.Diagnostics;
+using System.Linq;
+using System.Text.RegularExpressions;
+using System.Xml.Linq;
+using BenchmarkDotNet.Attributes;
+using BenchmarkDotNet.Engines;
+using BenchmarkDotNet.Jobs;
+
+namespace Profiler.Benchmarks
+{
+    public enum StartupMode
+    {
+        None,
+        ELT,
+        IL,
+        IL_NativeImages
+    }
+
+    /// <summary>
+    /// Measures how long it takes a profiled process to start, do a little work that pulls in framework code, and exit.
+    /// Only this assembly is whitelisted, so any time spent JITting the framework is pure overhead.
+    /// </summary>
+    [SimpleJob(RunStrategy.Monitoring, launchCount: 1, warmupCount: 1, iterationCount: 10)]
+    public class StartupBenchmarks
+    {
+        internal const string StartupArg = "--startup";
+
+        private static EnvironmentVariable EnvILInstrumentation = new EnvironmentVariable("DEBUGTOOLS_ILINSTRUMENTATION", "1");
+        private static EnvironmentVariable EnvPreserveNativeImages = new EnvironmentVariable("DEBUGTOOLS_PRESERVE_NATIVE_IMAGES", "1");
+
+        [Params(StartupMode.None, StartupMode.ELT, StartupMode.IL, StartupMode.IL_NativeImages)]
+        public StartupMode Mode { get; set; }
+
+        private ProcessStartInfo startInfo;
+
+        [GlobalSetup]
+        public void Setup()
+        {
+            startInfo = new ProcessStartInfo(Process.GetCurrentProcess().MainModule.FileName, StartupArg)
+            {
+                UseShellExecute = false,
+                CreateNoWindow = true
+            };
+
+            foreach (var variable in GetEnvVars())
+                startInfo.EnvironmentVariables[variable.Key] = variable.Value;
+        }
+
+        [Benchmark]
+        public void StartProcess()
+        {
+            using (var process = Process.Start(startInfo))
+                process.WaitForExit();
+        }
+
+        private EnvironmentVariable[] GetEnvVars()
+        {
+            switch (Mode)
+            {
+                case StartupMode.None:
+                    return new EnvironmentVariable[0];
+
+                case StartupMode.ELT:
+                    return ProfilerConfig.BuildEnvVars();
+
+                case StartupMode.IL:
+                    return ProfilerConfig.BuildEnvVars(EnvILInstrumentation);
+
+                case StartupMode.IL_NativeImages:
+                    return ProfilerConfig.BuildEnvVars(EnvILInstrumentation, EnvPreserveNativeImages);
+
+                default:
+                    throw new NotImplementedException($"Don't know how to handle {nameof(StartupMode)} '{Mode}'.");
+            }
+        }
+
+        internal static void Startup()
+        {
+            var document = XDocument.Parse("<items><item name=\"a\" /><item name=\"b\" /></items>");
+
+            var names = document.Root.Elements("item").Select(e => e.Attribute("name").Value).ToArray();
+
+            Regex.Match(string.Join(",", names), "a,b");
+        }
+    }
+}
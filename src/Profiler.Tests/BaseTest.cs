@@ -1,5 +1,6 @@
 using System;
 using System.Collections.Generic;
+using System.Diagnostics;
 using System.Linq;
 using System.Threading;
 using DebugTools.Profiler;
@@ -151,17 +152,133 @@ namespace Profiler.Tests
                 var threadStacks = session.ThreadCache.Values.ToArray();
                 var methods = session.Methods.Values.ToArray();
 
-                if (liveTarget.Process.ExitCode != 0)
+                ThrowOnFailedExitCode(type, subType, liveTarget.Process);
+
+                var validator = new Validator(threadStacks, methods, session);
+
+                validate(validator);
+            }
+        }
+
+        /// <summary>
+        /// Runs a test that queries the profiler while the TestHost is still alive. The TestHost signals once it has run the test,
+        /// and then waits for the validation to complete before exiting.
+        /// </summary>
+        internal void TestLiveInternal(TestType type, string subType, Action<ProfilerSession> validate, params ProfilerSetting[] settings)
+        {
+            var settingsList = settings.ToList();
+            settingsList.Add(ProfilerSetting.TraceStart);
+
+            var eventName = $"DebugTools_Test_{Guid.NewGuid():N}";
+
+            using (var readyEvent = new EventWaitHandle(false, EventResetMode.ManualReset, $"{eventName}_Ready"))
+            using (var exitEvent = new EventWaitHandle(false, EventResetMode.ManualReset, $"{eventName}_Exit"))
+            {
+                var config = new LiveProfilerReaderConfig(ProfilerSessionType.Normal, $"{ProfilerInfo.TestHost} {type} {subType} {eventName}", settingsList.ToArray());
+
+                using (var session = new ProfilerSession(config))
+                {
+                    var wait = new AutoResetEvent(false);
+
+                    session.Reader.Completed += () => wait.Set();
+
+                    session.Start(default);
+
+                    var process = ((LiveProfilerTarget) session.Target).Process;
+
+                    try
+                    {
+                        if (!readyEvent.WaitOne(TimeSpan.FromSeconds(30)))
+                            throw new TimeoutException($"Test '{type}' -> '{subType}' did not signal that it had run.");
+
+                        validate(session);
+                    }
+                    finally
+                    {
+                        exitEvent.Set();
+
+                        process.WaitForExit();
+
+                        wait.WaitOne();
+                    }
+
+                    session.ThrowOnError();
+
+                    ThrowOnFailedExitCode(type, subType, process);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Runs a test that attaches the profiler to a TestHost that was started without it, and then detaches it again. The TestHost
+        /// signals once it has started and once it has run the test, and then waits for the profiler to be attached or detached respectively.
+        /// </summary>
+        internal void TestAttachInternal(TestType type, string subType, Action<Validator> validate, params ProfilerSetting[] settings)
+        {
+            var settingsList = settings.ToList();
+            settingsList.Add(ProfilerSetting.TraceStart);
+
+            var eventName = $"DebugTools_Test_{Guid.NewGuid():N}";
+
+            using (var startedEvent = new EventWaitHandle(false, EventResetMode.ManualReset, $"{eventName}_Started"))
+            using (var attachedEvent = new EventWaitHandle(false, EventResetMode.ManualReset, $"{eventName}_Attached"))
+            using (var calledEvent = new EventWaitHandle(false, EventResetMode.ManualReset, $"{eventName}_Called"))
+            using (var detachedEvent = new EventWaitHandle(false, EventResetMode.ManualReset, $"{eventName}_Detached"))
+            using (var process = Process.Start(new ProcessStartInfo(ProfilerInfo.TestHost, $"{type} {subType} {eventName}") { UseShellExecute = false, CreateNoWindow = true }))
+            {
+                try
                 {
-                    if (liveTarget.Process.ExitCode == 2)
-                        throw new InvalidOperationException($"Test '{type}' -> '{subType}' has not been defined in TestHost");
+                    if (!startedEvent.WaitOne(TimeSpan.FromSeconds(30)))
+                        throw new TimeoutException($"Test '{type}' -> '{subType}' did not signal that it had started.");
+
+                    var config = new LiveProfilerReaderConfig(ProfilerSessionType.Normal, process, settingsList.ToArray());
+
+                    using (var session = new ProfilerSession(config))
+                    {
+                        //The profiler writes its ShutdownEvent once the runtime has finished detaching it
+                        var shutdown = new ManualResetEvent(false);
+
+                        session.Reader.Shutdown += v => shutdown.Set();
+
+                        session.Start(default);
+
+                        attachedEvent.Set();
+
+                        if (!calledEvent.WaitOne(TimeSpan.FromSeconds(30)))
+                            throw new TimeoutException($"Test '{type}' -> '{subType}' did not signal that it had run.");
 
-                    throw new InvalidOperationException($"TestHost exited with exit code 0x{liveTarget.Process.ExitCode.ToString("X")}");
+                        session.Detach();
+
+                        if (!shutdown.WaitOne(TimeSpan.FromSeconds(30)))
+                            throw new TimeoutException("Timed out waiting for the profiler to detach.");
+
+                        detachedEvent.Set();
+
+                        process.WaitForExit();
+
+                        session.ThrowOnError();
+
+                        ThrowOnFailedExitCode(type, subType, process);
+
+                        validate(new Validator(session));
+                    }
                 }
+                finally
+                {
+                    attachedEvent.Set();
+                    detachedEvent.Set();
+                }
+            }
+        }
 
-                var validator = new Validator(threadStacks, methods);
+        private void ThrowOnFailedExitCode(TestType type, string subType, Process process)
+        {
+            if (process.ExitCode != 0)
+            {
+                if (process.ExitCode == 2)
+                    throw new InvalidOperationException($"Test '{type}' -> '{subType}' has not been defined in TestHost");
 
-                validate(validator);
+                throw new InvalidOperationException($"TestHost exited with exit code 0x{process.ExitCode.ToString("X")}");
             }
         }
     }
@@ -206,6 +206,25 @@ namespace Profiler.Tests
                 v.HasException("System.NotImplementedException", ExceptionStatus.Caught);
             }, ProfilerSetting.ModuleBlacklist(MatchKind.All, string.Empty), ProfilerSetting.ModuleWhitelist(MatchKind.ModuleName, "System.Xml.Linq.dll"));
 
+        #region Flight Recorder
+
+        [TestMethod]
+        public void Exception_FlightRecorder_DumpOnException() =>
+            Test(ExceptionTestType.CaughtWithinMethod, v =>
+            {
+                //The dump is written in the background as soon as the exception is thrown, so the thread may or may not have caught it by the time its buffer is flushed
+                v.HasException("System.NotImplementedException", ExceptionStatus.Incomplete, ExceptionStatus.Caught);
+            }, ProfilerSetting.FlightRecorder(16), ProfilerSetting.FlightRecorderException("NotImplemented"), ProfilerSetting.SynchronousTransfers);
+
+        [TestMethod]
+        public void Exception_FlightRecorder_NoDump() =>
+            TestInternal(TestType.Exception, ExceptionTestType.CaughtWithinMethod.ToString(), v =>
+            {
+                Assert.AreEqual(0, v.ThreadStacks.Length, "Expected no call events to be received when the flight recorder was not triggered");
+            }, ProfilerSetting.FlightRecorder(16), ProfilerSetting.FlightRecorderException("ArgumentException"), ProfilerSetting.SynchronousTransfers);
+
+        #endregion
+
         internal void Test(ExceptionTestType type, Action<ExceptionVerifier> validate, params ProfilerSetting[] settings)
         {
             TestInternal(TestType.Exception, type.ToString(), v => validate(new ExceptionVerifier(v.ThreadStacks.Single().Exceptions.Values.ToArray(), v)), settings);
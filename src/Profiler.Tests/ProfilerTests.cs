@@ -34,6 +34,320 @@ namespace Profiler.Tests
             });
         }
 
+        [TestMethod]
+        public void Profiler_CallStackSnapshot_Periodic()
+        {
+            //Snapshots of stacks we've been tracing all along shouldn't change the shape of the tree
+            Test(ProfilerTestType.TwoChildren, v =>
+            {
+                var frame = v.FindFrame("TwoChildren");
+
+                frame.Verify().HasFrames("TwoChildren1", "TwoChildren2");
+            }, ProfilerSetting.SnapshotInterval(1));
+        }
+
+        [TestMethod]
+        public void Profiler_UnhookWhenNotTracing()
+        {
+            //The hooks are only skipped while tracing is disabled
+            Test(ProfilerTestType.TwoChildren, v =>
+            {
+                var frame = v.FindFrame("TwoChildren");
+
+                frame.Verify().HasFrames("TwoChildren1", "TwoChildren2");
+            }, ProfilerSetting.UnhookWhenNotTracing);
+        }
+
+        [TestMethod]
+        public void Profiler_CoalesceCalls()
+        {
+            //Collapsing the enter/leave events of each leaf call into a single complete event should produce the same tree
+            Test(ProfilerTestType.TwoChildren, v =>
+            {
+                var frame = v.FindFrame("TwoChildren");
+
+                frame.Verify().HasFrames("TwoChildren1", "TwoChildren2");
+            }, ProfilerSetting.CoalesceCalls);
+        }
+
+        [TestMethod]
+        public void Profiler_ILInstrumentation()
+        {
+            //Rewriting the IL of each method to call the hooks itself should produce the same tree as ELT hooks
+            Test(ProfilerTestType.TwoChildren, v =>
+            {
+                var frame = v.FindFrame("TwoChildren");
+
+                frame.Verify().HasFrames("TwoChildren1", "TwoChildren2");
+            }, ProfilerSetting.ILInstrumentation);
+        }
+
+        [TestMethod]
+        public void Profiler_PreserveNativeImages()
+        {
+            //Functions in the test host must still be JITted and hooked even though the framework continues to use its native images
+            Test(ProfilerTestType.NativeImage, v =>
+            {
+                var frame = v.FindFrame("TwoChildren");
+
+                frame.Verify().HasFrames("TwoChildren1", "TwoChildren2");
+
+                v.HasFrame("NativeImageUsed");
+            }, ProfilerSetting.ILInstrumentation, ProfilerSetting.PreserveNativeImages);
+        }
+
+        [TestMethod]
+        public void Profiler_PreserveNativeImages_WithoutILInstrumentation()
+        {
+            //ELT hooks require every function to be JITted, so native images can't be preserved
+            Test(ProfilerTestType.NativeImage, v =>
+            {
+                v.HasFrame("NativeImageNotUsed");
+            }, ProfilerSetting.PreserveNativeImages);
+        }
+
+        [TestMethod]
+        public void Profiler_CpuTime()
+        {
+            Test(ProfilerTestType.TwoChildren, v =>
+            {
+                var frame = (MethodFrame) v.FindFrame("TwoChildren");
+
+                frame.Verify().HasFrames("TwoChildren1", "TwoChildren2");
+
+                var children = frame.Children.Cast<MethodFrame>().ToArray();
+
+                //A frame's exclusive time excludes the time spent in its children, which are also included in its inclusive time
+                Assert.IsTrue(frame.InclusiveCpuCycles > 0);
+                Assert.IsTrue(frame.ExclusiveCpuCycles <= frame.InclusiveCpuCycles - children.Sum(c => c.InclusiveCpuCycles));
+
+                foreach (var child in children)
+                    Assert.IsTrue(child.ExclusiveCpuCycles <= child.InclusiveCpuCycles);
+            }, ProfilerSetting.CpuTime);
+        }
+
+        [TestMethod]
+        public void Profiler_CpuTime_CompensateHookOverhead()
+        {
+            //Removing the cost of the hooks from each frame must never cause a frame to be charged for more than it consumed
+            Test(ProfilerTestType.TwoChildren, v =>
+            {
+                var frame = (MethodFrame) v.FindFrame("TwoChildren");
+
+                frame.Verify().HasFrames("TwoChildren1", "TwoChildren2");
+
+                var children = frame.Children.Cast<MethodFrame>().ToArray();
+
+                Assert.IsTrue(frame.ExclusiveCpuCycles <= frame.InclusiveCpuCycles - children.Sum(c => c.InclusiveCpuCycles));
+            }, ProfilerSetting.CpuTime, ProfilerSetting.CompensateHookOverhead);
+        }
+
+        [TestMethod]
+        public void Profiler_PInvokeStats()
+        {
+            TestLive(ProfilerTestType.PInvoke, s =>
+            {
+                var stats = s.GetPInvokeStats();
+
+                var stat = stats.SingleOrDefault(v => v.Method.MethodName == "PInvokeSleep");
+
+                Assert.IsNotNull(stat, "Failed to find the P/Invoke statistics of PInvokeSleep");
+                Assert.AreEqual(5, stat.CallCount);
+                Assert.AreEqual(5, stat.Buckets.Sum());
+
+                //Each call sleeps for 10ms
+                Assert.IsTrue(stat.TotalTime > TimeSpan.Zero);
+                Assert.IsTrue(stat.AverageTime >= TimeSpan.FromMilliseconds(5), $"Expected an average of at least 5ms, however the average was {stat.AverageTime.TotalMilliseconds}ms");
+            }, ProfilerSetting.PInvokeStats);
+        }
+
+        [TestMethod]
+        public void Profiler_AttachDetach()
+        {
+            //Only the call made while the profiler was attached is traced, and the calls made after it detached complete normally
+            TestAttachInternal(TestType.Profiler, ProfilerTestType.Attach.ToString(), v =>
+            {
+                var frames = v.FindFrames(f => f.MethodInfo.MethodName == "TwoChildren");
+
+                Assert.AreEqual(1, frames.Length);
+
+                frames[0].Verify().HasFrames("TwoChildren1", "TwoChildren2");
+            });
+        }
+
+        [TestMethod]
+        public void Profiler_CollapseRepeatedCalls()
+        {
+            //Runs of identical calls are expanded back into individual frames
+            Test(ProfilerTestType.RepeatedChild, v =>
+            {
+                var frame = v.FindFrame("RepeatedChild");
+
+                frame.Verify().HasFrames("RepeatedChild1", "RepeatedChild1", "RepeatedChild1");
+            }, ProfilerSetting.CollapseRepeatedCalls);
+        }
+
+        [TestMethod]
+        public void Profiler_CollapseRepeatedCalls_LastOnThread()
+        {
+            //A run that is still pending when its thread exits must be written before the thread is reported as destroyed
+            Test(ProfilerTestType.RepeatedChild_LastOnThread, v =>
+            {
+                var frames = v.FindFrames(f => f.MethodInfo.MethodName == "RepeatedChild1");
+
+                Assert.AreEqual(3, frames.Length);
+            }, ProfilerSetting.CollapseRepeatedCalls);
+        }
+
+        [TestMethod]
+        public void Profiler_Suppression()
+        {
+            //A leaf function that's called frequently enough is reported as suppressed, after which its calls are no longer written
+            TestLive(ProfilerTestType.Suppression, s =>
+            {
+                var suppressed = s.GetSuppressedFunctions();
+
+                Assert.IsTrue(suppressed.Any(m => m.MethodName == "HotFunction"), $"HotFunction was not suppressed. Suppressed functions: {string.Join(", ", suppressed.Select(m => m.MethodName))}");
+
+                //The session has received every event written before the suppressed functions were listed
+                var v = new Validator(s);
+
+                var frame = v.FindFrame("Suppression_AfterSuppressed");
+
+                Assert.AreEqual(0, frame.Children.Count);
+            }, ProfilerSetting.SuppressCallRate(1000), ProfilerSetting.SuppressMaxDuration(100000));
+        }
+
+        [TestMethod]
+        public void Profiler_Suppression_Unsuppress()
+        {
+            //A suppressed function that later calls another function is unsuppressed, and its child is nested beneath it
+            TestLive(ProfilerTestType.Suppression_Unsuppress, s =>
+            {
+                var suppressed = s.GetSuppressedFunctions();
+
+                Assert.IsFalse(suppressed.Any(m => m.MethodName == "HotParent"), "HotParent was still suppressed after calling a child");
+
+                var v = new Validator(s);
+
+                var child = v.FindFrame("Suppression_Child");
+
+                Assert.AreEqual("HotParent", ((IMethodFrame)child.Parent).MethodInfo.MethodName);
+            }, ProfilerSetting.SuppressCallRate(1000), ProfilerSetting.SuppressMaxDuration(100000));
+        }
+
+        [TestMethod]
+        public void Profiler_SkipTrivialMethods()
+        {
+            //Empty methods are not hooked unless they've been whitelisted
+            Test(ProfilerTestType.TwoChildren, v =>
+            {
+                var frame = v.FindFrame("TwoChildren");
+
+                frame.Verify().HasFrames("TwoChildren2");
+            }, ProfilerSetting.SkipTrivialMethods(2), ProfilerSetting.TrivialMethodWhitelist(MatchKind.EndsWith, "ProfilerType.TwoChildren2"));
+        }
+
+        [TestMethod]
+        public void Profiler_Sampling()
+        {
+            //When sampling, the hooks only maintain the shadow stack, which is reported by the sampler instead of each call
+            Test(ProfilerTestType.TwoChildren_Loop, v =>
+            {
+                Assert.AreEqual(0, v.FindFrames(f => true).Length);
+
+                var stack = v.FindSampledStack("TwoChildren1");
+
+                Assert.IsTrue(stack.Count > 0);
+                CollectionAssert.IsSubsetOf(new[] { "TwoChildren_Loop", "TwoChildren" }, stack.Frames.Select(f => f.MethodName).ToArray());
+            }, ProfilerSetting.SampleInterval(1));
+        }
+
+        [TestMethod]
+        public void Profiler_Sampling_OffCpu()
+        {
+            //A thread that's blocked in Thread.Sleep consumes almost no cycles between samples, so nearly all of the time it spends sleeping is off-CPU
+            Test(ProfilerTestType.Sleep, v =>
+            {
+                Assert.AreEqual(0, v.FindFrames(f => true).Length);
+
+                var stack = v.FindSampledStack("Sleep", offCpu: true);
+
+                Assert.IsTrue(stack.Count > 0);
+                Assert.IsTrue(stack.OffCpuTime >= TimeSpan.FromMilliseconds(250), $"Expected the 500ms sleep to have at least 250ms of off-CPU time, however only {stack.OffCpuTime.TotalMilliseconds}ms was recorded");
+            }, ProfilerSetting.SampleInterval(1), ProfilerSetting.OffCpu);
+        }
+
+        [TestMethod]
+        public void Profiler_Continuous()
+        {
+            //In continuous mode, calls are only reported in aggregate in each periodic snapshot
+            Test(ProfilerTestType.TwoChildren_Loop, v =>
+            {
+                Assert.AreEqual(0, v.FindFrames(f => true).Length);
+
+                var snapshots = v.Session.GetContinuousSnapshots();
+
+                //Each snapshot only describes the calls made since the previous one, so a function that's called throughout the loop
+                //should appear in several snapshots
+                var deltas = snapshots
+                    .Select(s => s.Methods.SingleOrDefault(m => m.Method.MethodName == "TwoChildren1"))
+                    .Where(m => m != null)
+                    .ToArray();
+
+                Assert.IsTrue(deltas.Length > 1, $"Expected TwoChildren1 to be reported in multiple snapshots, however it was reported in {deltas.Length} of {snapshots.Length}");
+                Assert.IsTrue(deltas.All(m => m.CallCount > 0));
+
+                foreach (var snapshot in snapshots)
+                    Assert.IsTrue(snapshot.Methods.Sum(m => m.CallCount) <= snapshot.TotalCalls);
+            }, ProfilerSetting.ContinuousInterval(50));
+        }
+
+        [TestMethod]
+        public void Profiler_SlowCall()
+        {
+            //Only the subtrees of root calls that exceeded the threshold are delivered
+            Test(ProfilerTestType.SlowCall, v =>
+            {
+                var frame = v.FindFrame("SlowCall");
+
+                frame.Verify().HasFrame("SlowCall1");
+
+                Assert.AreEqual(0, v.FindFrames(f => f.MethodInfo.MethodName == "FastCall").Length);
+            }, ProfilerSetting.SlowCallThreshold(100));
+        }
+
+        [TestMethod]
+        public void Profiler_StackWalkSampling()
+        {
+            //When sampling via stack walks, no hooks are installed at all. The frames are instead discovered by walking each thread
+            Test(ProfilerTestType.TwoChildren_Loop, v =>
+            {
+                Assert.AreEqual(0, v.FindFrames(f => true).Length);
+
+                var stack = v.Session.GetSampledStacks().FirstOrDefault(s => s.Frames.Any(f => f.MethodName == "TwoChildren_Loop"));
+
+                Assert.IsNotNull(stack, "Failed to find a walked stack containing 'TwoChildren_Loop'");
+
+                //Walks report the innermost frame first, but stacks are reported outermost first
+                var names = stack.Frames.Select(f => f.MethodName).ToList();
+
+                Assert.IsTrue(names.IndexOf("ProcessProfilerTest") != -1 && names.IndexOf("ProcessProfilerTest") < names.IndexOf("TwoChildren_Loop"), $"Frames were in the wrong order: {string.Join(" -> ", names)}");
+            }, ProfilerSetting.StackWalkInterval(1));
+        }
+
+        [TestMethod]
+        public void Profiler_Coverage()
+        {
+            //When recording coverage, the hooks only record the first call to each function
+            TestLive(ProfilerTestType.TwoChildren, s =>
+            {
+                var covered = s.GetCoveredFunctions().Select(m => m.MethodName).ToArray();
+
+                CollectionAssert.IsSubsetOf(new[] { "TwoChildren", "TwoChildren1", "TwoChildren2" }, covered);
+                CollectionAssert.DoesNotContain(covered, "SingleChild1");
+            }, ProfilerSetting.Coverage);
+        }
 
         [TestMethod]
         public void Profiler_Detailed_NoArgs()
@@ -99,5 +413,8 @@ namespace Profiler.Tests
 
         internal void Test(ProfilerTestType type, Action<Validator> validate, params ProfilerSetting[] settings) =>
             TestInternal(TestType.Profiler, type.ToString(), validate, settings);
+
+        internal void TestLive(ProfilerTestType type, Action<ProfilerSession> validate, params ProfilerSetting[] settings) =>
+            TestLiveInternal(TestType.Profiler, type.ToString(), validate, settings);
     }
 }
@@ -33,5 +33,16 @@ namespace Profiler.Tests
 
             HasException(0, type, completedReason);
         }
+
+        public void HasException(string type, ExceptionStatus completedReason, ExceptionStatus alternateReason)
+        {
+            if (exceptions.Length != 1)
+                Assert.Fail($"Expected a single exception but found {exceptions.Length}");
+
+            var exception = exceptions[0];
+
+            Assert.AreEqual(type, exception.Type);
+            Assert.IsTrue(exception.Status == completedReason || exception.Status == alternateReason, $"Expected exception status to be {completedReason} or {alternateReason} but was {exception.Status}");
+        }
     }
 }
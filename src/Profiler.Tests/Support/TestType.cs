@@ -217,13 +217,23 @@ namespace Profiler.Tests
         NoArgs,
         SingleChild,
         TwoChildren,
+        TwoChildren_Loop,
+        Sleep,
+        RepeatedChild,
+        RepeatedChild_LastOnThread,
+        SlowCall,
+        Suppression,
+        Suppression_Unsuppress,
+        PInvoke,
+        Attach,
         Async,
 
         Thread_NameAfterCreate,
         Thread_NameBeforeCreate,
         Thread_NamedAndNeverStarted,
 
-        DynamicModule
+        DynamicModule,
+        NativeImage
     }
 
     enum ExceptionTestType
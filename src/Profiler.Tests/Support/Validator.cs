@@ -12,10 +12,23 @@ namespace Profiler.Tests
 
         public IMethodInfo[] Methods { get; }
 
-        public Validator(ThreadStack[] threadStacks, IMethodInfo[] methods)
+        /// <summary>
+        /// Gets the session the test was run under, for inspecting anything the profiler reported other than call frames.
+        /// </summary>
+        public ProfilerSession Session { get; }
+
+        public Validator(ThreadStack[] threadStacks, IMethodInfo[] methods, ProfilerSession session)
         {
             ThreadStacks = threadStacks;
             Methods = methods;
+            Session = session;
+        }
+
+        /// <summary>
+        /// Creates a validator for the frames a live session has received so far.
+        /// </summary>
+        public Validator(ProfilerSession session) : this(session.ThreadCache.Values.ToArray(), session.Methods.Values.ToArray(), session)
+        {
         }
 
         public void HasFrame(string name, string typeName = "DebugTools.TestHost.ProfilerType")
@@ -77,6 +90,18 @@ namespace Profiler.Tests
             throw new AssertFailedException($"Failed to find frame '{methodName}'");
         }
 
+        internal SampledStack FindSampledStack(string innermostMethodName, bool offCpu = false)
+        {
+            var stacks = Session.GetSampledStacks(offCpu);
+
+            var match = stacks.FirstOrDefault(s => s.Frames.Length > 0 && s.Frames[s.Frames.Length - 1].MethodName == innermostMethodName);
+
+            if (match == null)
+                Assert.Fail($"Failed to find a{(offCpu ? "n off-CPU" : string.Empty)} sampled stack ending in '{innermostMethodName}'. Sampled stacks: {string.Join(", ", stacks.Select(s => s.ToString()))}");
+
+            return match;
+        }
+
         internal ThreadStack FindThread(string name)
         {
             var match = ThreadStacks.SingleOrDefault(t => t.Root.ThreadName == name);
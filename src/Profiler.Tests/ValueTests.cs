@@ -929,6 +929,33 @@ namespace Profiler.Tests
                     .HasFieldValue(2, 2)
             ));
 
+        #endregion
+        #region Value Predicate
+
+        [TestMethod]
+        public void Value_Predicate_Int32_Match() =>
+            Test(ValueTestType.Int32Arg, v => v.HasValue<int>(1), ProfilerSetting.ValuePredicate("Int32Arg", "a", ValuePredicateKind.Equals, 1));
+
+        [TestMethod]
+        public void Value_Predicate_String_Match() =>
+            Test(ValueTestType.StringArg, v => v.HasValue("foo"), ProfilerSetting.ValuePredicate("StringArg", "a", ValuePredicateKind.Contains, "oo"));
+
+        [TestMethod]
+        public void Value_Predicate_String_Equals_IgnoresCase() =>
+            Test(ValueTestType.StringArg, v => v.HasValue("foo"), ProfilerSetting.ValuePredicate("StringArg", "a", ValuePredicateKind.Equals, "FOO"));
+
+        [TestMethod]
+        public void Value_Predicate_NoMatch()
+        {
+            TestInternal(
+                TestType.Value,
+                ValueTestType.Int32Arg.ToString(),
+                v => Assert.IsNotInstanceOfType(v.FindFrame(ValueTestType.Int32Arg.ToString()), typeof(IMethodFrameDetailed)),
+                ProfilerSetting.Detailed,
+                ProfilerSetting.ValuePredicate("Int32Arg", "a", ValuePredicateKind.Equals, 2)
+            );
+        }
+
         #endregion
 
         internal void Test(ValueTestType type, Action<FrameVerifier> validate, params ProfilerSetting[] settings)
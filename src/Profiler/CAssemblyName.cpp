@@ -38,7 +38,7 @@ CAssemblyName::CAssemblyName(
     _In_ const BYTE* pbPublicKeyOrToken,
     _In_ ULONG cbPublicKeyOrToken)
 {
-    m_szShortName = _wcsdup(g_szAssemblyName);;
+    m_szShortName = _wcsdup(GetThreadContext()->szAssemblyName);;
 
     m_Major = asmMetaData.usMajorVersion;
     m_Minor = asmMetaData.usMinorVersion;
@@ -81,10 +81,12 @@ LPWSTR CAssemblyName::GetPublicKey(
 LPWSTR CAssemblyName::GetName(
     _In_ ULONG chName) const
 {
+    CThreadContext* pContext = GetThreadContext();
+
     chName--; //Ignore the null terminator
 
     chName += swprintf_s(
-        g_szAssemblyName + chName,
+        pContext->szAssemblyName + chName,
         NAME_BUFFER_SIZE - chName,
         L", Version=%d.%d.%d.%d, Culture=",
         m_Major,
@@ -94,14 +96,14 @@ LPWSTR CAssemblyName::GetName(
     );
 
     chName += swprintf_s(
-        g_szAssemblyName + chName,
+        pContext->szAssemblyName + chName,
         NAME_BUFFER_SIZE - chName,
         L"%s",
         m_szLocale == nullptr ? L"neutral" : m_szLocale
     );
 
     chName += swprintf_s(
-        g_szAssemblyName + chName,
+        pContext->szAssemblyName + chName,
         NAME_BUFFER_SIZE - chName,
         L", PublicKeyToken="
     );
@@ -109,7 +111,7 @@ LPWSTR CAssemblyName::GetName(
     if (m_szPublicKey)
     {
         chName += swprintf_s(
-            g_szAssemblyName + chName,
+            pContext->szAssemblyName + chName,
             NAME_BUFFER_SIZE - chName,
             L"%s",
             m_szPublicKey
@@ -118,13 +120,13 @@ LPWSTR CAssemblyName::GetName(
     else
     {
         chName += swprintf_s(
-            g_szAssemblyName + chName,
+            pContext->szAssemblyName + chName,
             NAME_BUFFER_SIZE - chName,
             L"null"
         );
     }
 
-    return _wcsdup(g_szAssemblyName);
+    return _wcsdup(pContext->szAssemblyName);
 }
 
 BOOL CAssemblyName::IsMatch(CAssemblyName* pOther, BOOL nameOnly)
@@ -0,0 +1,233 @@
+#include "pch.h"
+#include "CCallCoalescer.h"
+#include "CThreadContext.h"
+#include "CFlightRecorder.h"
+
+BOOL g_CoalesceCalls = FALSE;
+
+LONGLONG CCallCoalescer::s_Frequency = 0;
+BOOL CCallCoalescer::s_CollapseRepeatedCalls = FALSE;
+
+#define TICKS_PER_SECOND 10000000
+
+void CCallCoalescer::Initialize()
+{
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+
+    s_Frequency = frequency.QuadPart;
+
+    s_CollapseRepeatedCalls = GetBoolEnv("DEBUGTOOLS_COLLAPSE_REPEATED_CALLS");
+
+    //Runs of repeated calls are built from the complete calls the coalescer produces
+    g_CoalesceCalls = GetBoolEnv("DEBUGTOOLS_COALESCE_CALLS") || s_CollapseRepeatedCalls;
+}
+
+ULONG CCallCoalescer::Write(
+    _In_ REGHANDLE RegHandle,
+    _In_ PCEVENT_DESCRIPTOR EventDescriptor,
+    _In_opt_ LPCGUID ActivityId,
+    _In_opt_ LPCGUID RelatedActivityId,
+    _In_range_(0, MAX_EVENT_DATA_DESCRIPTORS) ULONG UserDataCount,
+    _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData)
+{
+    CThreadContext* pContext = GetThreadContext();
+
+    CLock coalescerLock(&pContext->CoalescerMutex, true);
+
+    PendingCallEnter* pPending = &pContext->PendingEnter;
+
+    switch (EventDescriptor->Id)
+    {
+    case CallEnterEvent_value:
+    {
+        //If this enter is followed by its leave, it may continue the current run, so we only flush the run
+        //if the enter we were already holding onto turned out to be a parent frame
+        if (pPending->IsPending)
+            Flush(RegHandle, pContext);
+
+        //Frames that had an error recorded against them are always written as is
+        if (*(HRESULT*)UserData[3].Ptr != S_OK)
+            break;
+
+        LARGE_INTEGER qpc;
+        QueryPerformanceCounter(&qpc);
+
+        pPending->IsPending = TRUE;
+        pPending->FunctionID = *(ULONGLONG*)UserData[1].Ptr;
+        pPending->Sequence = *(ULONGLONG*)UserData[2].Ptr;
+        pPending->QPC = qpc.QuadPart;
+
+        return ERROR_SUCCESS;
+    }
+
+    case CallLeaveEvent_value:
+    {
+        if (!pPending->IsPending)
+            break;
+
+        ULONGLONG functionId = *(ULONGLONG*)UserData[1].Ptr;
+        ULONGLONG sequence = *(ULONGLONG*)UserData[2].Ptr;
+        HRESULT hr = *(HRESULT*)UserData[3].Ptr;
+
+        if (functionId != pPending->FunctionID || sequence != pPending->Sequence + 1 || hr != S_OK)
+            break;
+
+        LARGE_INTEGER qpc;
+        QueryPerformanceCounter(&qpc);
+
+        pPending->IsPending = FALSE;
+
+        //Durations are reported in 100ns units so that the client doesn't need to know our QPC frequency
+        ULONGLONG duration = (ULONGLONG)(qpc.QuadPart - pPending->QPC) * TICKS_PER_SECOND / s_Frequency;
+
+        return Complete(RegHandle, pContext, pPending, duration);
+    }
+    }
+
+    //Any other event must be preceded by the calls we were holding onto
+    Flush(RegHandle, pContext);
+
+    return EventWriteTransferCore(RegHandle, EventDescriptor, ActivityId, RelatedActivityId, UserDataCount, UserData);
+}
+
+void CCallCoalescer::FlushThread(_In_ CThreadContext* pContext)
+{
+    CLock coalescerLock(&pContext->CoalescerMutex, true);
+
+    Flush(DebugToolsProfilerHandle, pContext);
+}
+
+ULONG CCallCoalescer::Flush(_In_ REGHANDLE RegHandle, _In_ CThreadContext* pContext)
+{
+    //Any run we're holding onto occurred prior to the enter we're holding onto
+    FlushRun(RegHandle, pContext);
+
+    PendingCallEnter* pPending = &pContext->PendingEnter;
+
+    if (!pPending->IsPending)
+        return ERROR_SUCCESS;
+
+    pPending->IsPending = FALSE;
+
+    HRESULT hr = S_OK;
+
+    EVENT_DATA_DESCRIPTOR EventData[4];
+    EventDataDescCreateTraits(&EventData[0]);
+    EventDataDescCreate(&EventData[1], &pPending->FunctionID, sizeof(ULONGLONG));
+    EventDataDescCreate(&EventData[2], &pPending->Sequence, sizeof(ULONGLONG));
+    EventDataDescCreate(&EventData[3], &hr, sizeof(HRESULT));
+
+    return WriteHeld(RegHandle, pContext, &CallEnterEvent, 4, EventData);
+}
+
+ULONG CCallCoalescer::FlushRun(_In_ REGHANDLE RegHandle, _In_ CThreadContext* pContext)
+{
+    PendingCallRun* pRun = &pContext->PendingRun;
+
+    if (pRun->Count == 0)
+        return ERROR_SUCCESS;
+
+    ULONG count = pRun->Count;
+    pRun->Count = 0;
+
+    //There's no point describing a run of a single call
+    if (count == 1)
+        return WriteComplete(RegHandle, pContext, pRun->FunctionID, pRun->Sequence, pRun->TotalDuration);
+
+    EVENT_DATA_DESCRIPTOR EventData[7];
+    EventDataDescCreateTraits(&EventData[0]);
+    EventDataDescCreate(&EventData[1], &pRun->FunctionID, sizeof(ULONGLONG));
+    EventDataDescCreate(&EventData[2], &pRun->Sequence, sizeof(ULONGLONG));
+    EventDataDescCreate(&EventData[3], &count, sizeof(ULONG));
+    EventDataDescCreate(&EventData[4], &pRun->TotalDuration, sizeof(ULONGLONG));
+    EventDataDescCreate(&EventData[5], &pRun->MinDuration, sizeof(ULONGLONG));
+    EventDataDescCreate(&EventData[6], &pRun->MaxDuration, sizeof(ULONGLONG));
+
+    return WriteHeld(RegHandle, pContext, &CallRepeatedEvent, 7, EventData);
+}
+
+ULONG CCallCoalescer::Complete(
+    _In_ REGHANDLE RegHandle,
+    _In_ CThreadContext* pContext,
+    _In_ PendingCallEnter* pEnter,
+    _In_ ULONGLONG duration)
+{
+    if (!s_CollapseRepeatedCalls)
+        return WriteComplete(RegHandle, pContext, pEnter->FunctionID, pEnter->Sequence, duration);
+
+    PendingCallRun* pRun = &pContext->PendingRun;
+
+    //Each call in the run consumes a sequence for its enter and its leave. As any event other than the enter/leave
+    //of another leaf call flushes the run, a run can only ever contain calls made by the same parent frame
+    if (pRun->Count > 0 && pRun->Count < MAXDWORD && pRun->FunctionID == pEnter->FunctionID && pRun->Sequence + pRun->Count * 2 == pEnter->Sequence)
+    {
+        pRun->Count++;
+        pRun->TotalDuration += duration;
+
+        if (duration < pRun->MinDuration)
+            pRun->MinDuration = duration;
+
+        if (duration > pRun->MaxDuration)
+            pRun->MaxDuration = duration;
+
+        return ERROR_SUCCESS;
+    }
+
+    FlushRun(RegHandle, pContext);
+
+    pRun->Count = 1;
+    pRun->FunctionID = pEnter->FunctionID;
+    pRun->Sequence = pEnter->Sequence;
+    pRun->TotalDuration = duration;
+    pRun->MinDuration = duration;
+    pRun->MaxDuration = duration;
+
+    return ERROR_SUCCESS;
+}
+
+ULONG CCallCoalescer::WriteComplete(
+    _In_ REGHANDLE RegHandle,
+    _In_ CThreadContext* pContext,
+    _In_ ULONGLONG functionId,
+    _In_ ULONGLONG sequence,
+    _In_ ULONGLONG duration)
+{
+    HRESULT hr = S_OK;
+
+    EVENT_DATA_DESCRIPTOR EventData[5];
+    EventDataDescCreateTraits(&EventData[0]);
+    EventDataDescCreate(&EventData[1], &functionId, sizeof(ULONGLONG));
+    EventDataDescCreate(&EventData[2], &sequence, sizeof(ULONGLONG));
+    EventDataDescCreate(&EventData[3], &hr, sizeof(HRESULT));
+    EventDataDescCreate(&EventData[4], &duration, sizeof(ULONGLONG));
+
+    return WriteHeld(RegHandle, pContext, &CallCompleteEvent, 5, EventData);
+}
+
+/// <summary>
+/// Writes an event that was held back on behalf of the thread it belongs to. Held events are normally flushed by their own thread,
+/// however when the profiler shuts down the events of every thread are flushed by the thread that is shutting it down.
+/// </summary>
+ULONG CCallCoalescer::WriteHeld(
+    _In_ REGHANDLE RegHandle,
+    _In_ CThreadContext* pContext,
+    _In_ PCEVENT_DESCRIPTOR EventDescriptor,
+    _In_range_(0, MAX_EVENT_DATA_DESCRIPTORS) ULONG UserDataCount,
+    _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData)
+{
+    if (pContext->ThreadId == GetCurrentThreadId())
+        return EventWriteTransferCore(RegHandle, EventDescriptor, NULL, NULL, UserDataCount, UserData);
+
+    //ETW and the flight recorder always attribute events to the thread that writes them, which would cause the client to
+    //place the events on the wrong stack. Only the memory mapped file transport lets us specify which thread an event belongs to
+    if (g_IsETW || g_FlightRecorderEnabled)
+        return ERROR_SUCCESS;
+
+    MMFRecord record = CreateMMFRecord(EventDescriptor, UserDataCount, UserData);
+    ((MMFEventHeader*)record.Ptr)->ThreadId = pContext->ThreadId;
+
+    EnqueueMMFRecord(record);
+
+    return ERROR_SUCCESS;
+}
\ No newline at end of file
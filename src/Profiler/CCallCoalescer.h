@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Events.h"
+
+extern BOOL g_CoalesceCalls;
+
+struct CThreadContext;
+
+/// <summary>
+/// Stores a CallEnterEvent that has been held back from being written in case the next event on the thread is its matching CallLeaveEvent.
+/// </summary>
+typedef struct PendingCallEnter {
+    BOOL IsPending;
+    ULONGLONG FunctionID;
+    ULONGLONG Sequence;
+    LONGLONG QPC;
+} PendingCallEnter;
+
+/// <summary>
+/// Stores a run of consecutive identical leaf calls that have been collapsed into a single record, pending a call that breaks the run.
+/// </summary>
+typedef struct PendingCallRun {
+    ULONG Count;
+    ULONGLONG FunctionID;
+    ULONGLONG Sequence;
+    ULONGLONG TotalDuration;
+    ULONGLONG MinDuration;
+    ULONGLONG MaxDuration;
+} PendingCallRun;
+
+/// <summary>
+/// Sits between the event write macros and the transport, merging sequences of call events on each thread into fewer events where doing so loses no information.<para/>
+/// When a plain CallEnterEvent is written it is held back. If the next event on the thread is the matching CallLeaveEvent, a single CallCompleteEvent is written
+/// in place of the pair. Otherwise, the CallEnterEvent is written as is, prior to whatever event caused it to be flushed.<para/>
+/// When repeated calls are being collapsed, consecutive complete calls to the same function are further accumulated into a run,
+/// which is written as a single CallRepeatedEvent once a different event is written on the thread.
+/// </summary>
+class CCallCoalescer
+{
+public:
+    static void Initialize();
+
+    static ULONG Write(
+        _In_ REGHANDLE RegHandle,
+        _In_ PCEVENT_DESCRIPTOR EventDescriptor,
+        _In_opt_ LPCGUID ActivityId,
+        _In_opt_ LPCGUID RelatedActivityId,
+        _In_range_(0, MAX_EVENT_DATA_DESCRIPTORS) ULONG UserDataCount,
+        _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData);
+
+    /// <summary>
+    /// Writes any events that are being held back for a thread. Must be called whenever a thread may not write another event that
+    /// would cause them to be flushed, such as when it exits, when tracing is disabled or when the profiler shuts down.
+    /// May be called from any thread.
+    /// </summary>
+    static void FlushThread(_In_ CThreadContext* pContext);
+
+private:
+    static ULONG Flush(_In_ REGHANDLE RegHandle, _In_ CThreadContext* pContext);
+    static ULONG FlushRun(_In_ REGHANDLE RegHandle, _In_ CThreadContext* pContext);
+
+    static ULONG Complete(
+        _In_ REGHANDLE RegHandle,
+        _In_ CThreadContext* pContext,
+        _In_ PendingCallEnter* pEnter,
+        _In_ ULONGLONG duration);
+
+    static ULONG WriteComplete(
+        _In_ REGHANDLE RegHandle,
+        _In_ CThreadContext* pContext,
+        _In_ ULONGLONG functionId,
+        _In_ ULONGLONG sequence,
+        _In_ ULONGLONG duration);
+
+    static ULONG WriteHeld(
+        _In_ REGHANDLE RegHandle,
+        _In_ CThreadContext* pContext,
+        _In_ PCEVENT_DESCRIPTOR EventDescriptor,
+        _In_range_(0, MAX_EVENT_DATA_DESCRIPTORS) ULONG UserDataCount,
+        _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData);
+
+    static LONGLONG s_Frequency;
+    static BOOL s_CollapseRepeatedCalls;
+};
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "pch.h"
+#include "CCallStackSnapshot.h"
+#include "CValueTracer.h"
+#include "Events.h"
+
+volatile LONG CCallStackSnapshot::s_Generation = 0;
+volatile LONG CCallStackSnapshot::s_DiscardGeneration = 0;
+DWORD CCallStackSnapshot::s_Interval = 0;
+CIntervalThread CCallStackSnapshot::s_Thread;
+
+HRESULT CCallStackSnapshot::Initialize()
+{
+    HRESULT hr = S_OK;
+
+    if (!GetIntSetting("DEBUGTOOLS_SNAPSHOTINTERVAL", &s_Interval) || s_Interval == 0)
+        goto ErrExit;
+
+    IfFailGo(s_Thread.Start(TimerThreadProc, s_Interval));
+
+ErrExit:
+    return hr;
+}
+
+void CCallStackSnapshot::Shutdown()
+{
+    s_Thread.Stop();
+}
+
+/// <summary>
+/// Requests that every thread write a snapshot of its call stack prior to the next call event it writes.<para/>
+/// Threads are not interrupted to write their snapshot; a thread that never makes another call will never write one,
+/// however such a thread will also never write any other events that would need to be reconciled against its stack.
+/// </summary>
+/// <param name="discardStacks">Whether each thread's shadow stack is stale (such as when the hooks were skipped while tracing was disabled),
+/// in which case each thread discards its stack and writes an empty snapshot.</param>
+void CCallStackSnapshot::Request(BOOL discardStacks)
+{
+    LONG generation = InterlockedIncrement(&s_Generation);
+
+    if (discardStacks)
+        s_DiscardGeneration = generation;
+}
+
+void CCallStackSnapshot::Write(_In_ CThreadContext* pContext)
+{
+    HRESULT hr = S_OK;
+
+    //If the hooks were skipped since this thread last wrote a snapshot, its shadow stack no longer reflects the frames it's in. Leaves of frames
+    //that are no longer on the stack are ignored, the same as the leaves of frames that were entered before tracing started
+    if (pContext->CallStackSnapshotGeneration < s_DiscardGeneration)
+        pContext->CallStack.clear();
+
+    pContext->CallStackSnapshotGeneration = s_Generation;
+
+    //Snapshots are always written before the value tracer starts writing to the value buffer, so it's safe to borrow it here
+    ULONG length = SerializeFrames(pContext->CallStack.Frames(), pContext->ValueBuffer);
+
+    ValidateETW(EventWriteCallStackSnapshotEvent(pContext->Sequence, length, pContext->ValueBuffer));
+}
+
+/// <summary>
+/// Serializes the non-suppressed frames of a shadow stack into a buffer of at least VALUE_BUFFER_SIZE bytes.<para/>
+/// Each frame is serialized as its FunctionID followed by its FrameKind, from the outermost frame to the innermost.
+/// </summary>
+/// <returns>The number of bytes that were written to the buffer.</returns>
+ULONG CCallStackSnapshot::SerializeFrames(
+    _In_ const std::deque<Frame>& frames,
+    _Out_ BYTE* buffer)
+{
+    const size_t frameSize = sizeof(UINT64) + sizeof(INT32);
+    const size_t maxFrames = VALUE_BUFFER_SIZE / frameSize;
+
+    //If the stack is too deep to fit in a single event, drop the outermost frames. The client already copes with
+    //leaving frames it never saw, but would be unable to match any frames that were missing from the middle of the stack
+    size_t start = frames.size() > maxFrames ? frames.size() - maxFrames : 0;
+
+    BYTE* ptr = buffer;
+
+    for (size_t i = start; i < frames.size(); i++)
+    {
+        //The client never saw suppressed frames get entered, and won't see them get left either
+        if (frames[i].Suppressed)
+            continue;
+
+        UINT64 functionId = frames[i].FunctionId;
+        INT32 kind = (INT32)frames[i].Kind;
+
+        memcpy(ptr, &functionId, sizeof(UINT64));
+        ptr += sizeof(UINT64);
+
+        memcpy(ptr, &kind, sizeof(INT32));
+        ptr += sizeof(INT32);
+    }
+
+    return (ULONG)(ptr - buffer);
+}
+
+DWORD WINAPI CCallStackSnapshot::TimerThreadProc(LPVOID lpParameter)
+{
+    while (s_Thread.Wait())
+    {
+        if (g_TracingEnabled)
+            Request();
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <deque>
+#include "CIntervalThread.h"
+
+struct CThreadContext;
+struct Frame;
+
+/// <summary>
+/// Writes the contents of a thread's shadow stack (CThreadContext::CallStack) so that a client that has not seen every call on the thread
+/// (such as when tracing was enabled mid-run, or when the flight recorder has been dumped) can reconstruct the frames that are currently active.
+/// </summary>
+class CCallStackSnapshot
+{
+public:
+    static HRESULT Initialize();
+    static void Shutdown();
+
+    static void Request(BOOL discardStacks = FALSE);
+    static void Write(_In_ CThreadContext* pContext);
+
+    static ULONG SerializeFrames(
+        _In_ const std::deque<Frame>& frames,
+        _Out_ BYTE* buffer);
+
+    //Incremented whenever every thread should write a snapshot prior to its next call event.
+    //Each thread compares this against CThreadContext::CallStackSnapshotGeneration to determine whether it needs to write a snapshot.
+    static volatile LONG s_Generation;
+
+    //The generation of the last request whose threads must discard their shadow stacks before writing a snapshot
+    static volatile LONG s_DiscardGeneration;
+
+private:
+    static DWORD WINAPI TimerThreadProc(LPVOID lpParameter);
+
+    static DWORD s_Interval;
+    static CIntervalThread s_Thread;
+};
+
+#define CHECK_CALLSTACK_SNAPSHOT(CONTEXT) \
+    do { \
+        if (g_TracingEnabled && (CONTEXT)->CallStackSnapshotGeneration != CCallStackSnapshot::s_Generation) \
+            CCallStackSnapshot::Write(CONTEXT); \
+    } while(0)
\ No newline at end of file
@@ -0,0 +1,274 @@
+#include "pch.h"
+#include "CCallSuppressor.h"
+#include "CSampler.h"
+#include "CValueTracer.h"
+#include "Events.h"
+#include <algorithm>
+
+BOOL g_SuppressionEnabled = FALSE;
+
+LONGLONG CCallSuppressor::s_Frequency = 0;
+LONG64 CCallSuppressor::s_CallRate = 0;
+LONG64 CCallSuppressor::s_MaxDuration = 0;
+
+std::vector<CFunctionRecord*> CCallSuppressor::s_Suppressed;
+std::shared_mutex CCallSuppressor::s_SuppressedMutex;
+
+#define DEFAULT_MAX_DURATION_NS 1000
+#define NS_PER_SECOND 1000000000
+
+HRESULT CCallSuppressor::Initialize()
+{
+    HRESULT hr = S_OK;
+    LONG64 maxDurationNs = DEFAULT_MAX_DURATION_NS;
+    LARGE_INTEGER frequency;
+
+    if (!GetIntSetting("DEBUGTOOLS_SUPPRESS_CALLRATE", &s_CallRate))
+        goto ErrExit;
+
+    if (s_CallRate <= 0)
+    {
+        hr = E_INVALIDARG;
+        goto ErrExit;
+    }
+
+    GetIntSetting("DEBUGTOOLS_SUPPRESS_MAXDURATION", &maxDurationNs);
+
+    QueryPerformanceFrequency(&frequency);
+
+    s_Frequency = frequency.QuadPart;
+    s_MaxDuration = maxDurationNs * s_Frequency / NS_PER_SECOND;
+
+    g_SuppressionEnabled = TRUE;
+
+ErrExit:
+    return hr;
+}
+
+/// <summary>
+/// Records that a hooked function is being entered. If the function has been suppressed, its frame is pushed onto the shadow stack
+/// without consuming a sequence number, and the hook should return without writing any events.
+/// </summary>
+/// <returns>TRUE if the function has been suppressed, otherwise FALSE.</returns>
+BOOL CCallSuppressor::Enter(_In_ CThreadContext* pContext, _In_ CFunctionRecord* pRecord)
+{
+    if (!pRecord->m_Suppressed)
+        return FALSE;
+
+    if (!pContext->CallStack.empty())
+    {
+        if (pContext->CallStack.top().Suppressed)
+            Unsuppress(pContext);
+
+        pContext->CallStack.top().HasChildren = TRUE;
+    }
+
+    pContext->CallStack.emplace(pRecord->m_FunctionId, FrameKind::Managed, pContext->CallStack.Hash(), TRUE);
+
+    return TRUE;
+}
+
+/// <summary>
+/// Records that a hooked function is being left. If the function's frame was suppressed when it was entered, the frame is popped
+/// from the shadow stack and the hook should return without writing any events. Otherwise, the duration of the call is recorded.
+/// </summary>
+/// <returns>TRUE if the frame being left was suppressed, otherwise FALSE.</returns>
+BOOL CCallSuppressor::Leave(_In_ CThreadContext* pContext, _In_ CFunctionRecord* pRecord)
+{
+    //If the frame doesn't match, let LEAVE_FUNCTION report the error
+    if (pContext->CallStack.empty())
+        return FALSE;
+
+    Frame& top = pContext->CallStack.top();
+
+    if (top.FunctionId != pRecord->m_FunctionId)
+        return FALSE;
+
+    if (top.Suppressed)
+    {
+        pContext->CallStack.pop();
+        return TRUE;
+    }
+
+    RecordCall(pContext, pRecord, top.EnterQPC, top.HasChildren);
+
+    return FALSE;
+}
+
+/// <summary>
+/// Pops the frame at the top of the shadow stack if it is a suppressed frame for the specified function. Used when unwinding frames during exception handling.
+/// </summary>
+/// <returns>TRUE if a suppressed frame was popped, otherwise FALSE.</returns>
+BOOL CCallSuppressor::LeaveSuppressed(_In_ CThreadContext* pContext, _In_ FunctionID functionId)
+{
+    if (pContext->CallStack.empty())
+        return FALSE;
+
+    Frame& top = pContext->CallStack.top();
+
+    if (!top.Suppressed || top.FunctionId != functionId)
+        return FALSE;
+
+    pContext->CallStack.pop();
+
+    return TRUE;
+}
+
+/// <summary>
+/// Unsuppresses the function of the suppressed frame at the top of the shadow stack, which is about to have a child frame entered beneath it.
+/// As no events were written when the frame was entered, it is replaced with a frame that is entered normally, so that the client
+/// sees the child nested under it rather than under its parent.
+/// </summary>
+void CCallSuppressor::Unsuppress(_In_ CThreadContext* pContext)
+{
+    HRESULT hr = S_OK;
+    FunctionID functionId = pContext->CallStack.top().FunctionId;
+
+    //Lock scope
+    {
+        CLock suppressedLock(&s_SuppressedMutex, true);
+
+        //Another thread may have already unsuppressed the function
+        auto match = std::find_if(s_Suppressed.begin(), s_Suppressed.end(), [functionId](CFunctionRecord* pRecord) { return pRecord->m_FunctionId == functionId; });
+
+        if (match != s_Suppressed.end())
+        {
+            (*match)->m_HasChildren = TRUE;
+            (*match)->m_Suppressed = FALSE;
+
+            s_Suppressed.erase(match);
+        }
+    }
+
+    LogShouldHook(L"Unsuppressing " FORMAT_PTR "\n", functionId);
+
+    pContext->CallStack.pop();
+
+    //The frame beneath a suppressed frame is never itself suppressed, so this won't try to unsuppress it
+    ENTER_FUNCTION_EX(pContext, functionId, FrameKind::Managed, TRUE);
+
+    //Call events aren't written in sampling or continuous profiling mode
+    if (g_TracingEnabled && !g_SamplingEnabled && !g_ContinuousEnabled)
+        ValidateETW(EventWriteCallEnterEvent(functionId, pContext->Sequence, S_OK));
+}
+
+void CCallSuppressor::RecordCall(_In_ CThreadContext* pContext, _In_ CFunctionRecord* pRecord, _In_ LONGLONG enterQPC, _In_ BOOL hasChildren)
+{
+    LARGE_INTEGER qpc;
+    QueryPerformanceCounter(&qpc);
+
+    //Only leaf functions are suppressed, as suppressing a function that has children would cause its children to appear under the wrong parent
+    if (hasChildren && !pRecord->m_HasChildren)
+        pRecord->m_HasChildren = TRUE;
+
+    //Calls are accumulated by the thread that made them, so that the record is only modified once every SUPPRESSOR_FOLD_CALLS calls.
+    //Records are at least pointer aligned, so the low bits don't contribute to the slot
+    PendingSuppressorCalls& pending = pContext->SuppressorCalls[((UINT_PTR)pRecord / sizeof(void*)) % PENDING_SUPPRESSOR_CALLS_SIZE];
+
+    if (pending.pRecord != pRecord)
+    {
+        if (pending.CallCount)
+            FoldCalls(pending, qpc.QuadPart);
+
+        pending.pRecord = pRecord;
+    }
+
+    pending.CallCount++;
+    pending.TotalDuration += qpc.QuadPart - enterQPC;
+
+    if (pending.CallCount >= SUPPRESSOR_FOLD_CALLS)
+        FoldCalls(pending, qpc.QuadPart);
+}
+
+void CCallSuppressor::FoldCalls(_In_ PendingSuppressorCalls& pending, _In_ LONGLONG qpc)
+{
+    CFunctionRecord* pRecord = pending.pRecord;
+
+    LONG64 callCount = InterlockedAdd64(&pRecord->m_CallCount, pending.CallCount);
+    LONG64 totalDuration = InterlockedAdd64(&pRecord->m_TotalDuration, pending.TotalDuration);
+
+    pending.CallCount = 0;
+    pending.TotalDuration = 0;
+
+    //Each measurement window lasts one second
+    LONG64 windowStart = pRecord->m_WindowStart;
+    LONG64 elapsed = qpc - windowStart;
+
+    if (elapsed < s_Frequency)
+        return;
+
+    //Only a single thread gets to evaluate each window
+    if (InterlockedCompareExchange64(&pRecord->m_WindowStart, qpc, windowStart) != windowStart)
+        return;
+
+    LONG64 windowCalls = callCount - pRecord->m_WindowCallCount;
+    LONG64 windowDuration = totalDuration - pRecord->m_WindowDuration;
+
+    pRecord->m_WindowCallCount = callCount;
+    pRecord->m_WindowDuration = totalDuration;
+
+    if (pRecord->m_HasChildren || windowCalls <= 0)
+        return;
+
+    LONG64 callRate = windowCalls * s_Frequency / elapsed;
+    LONG64 averageDuration = windowDuration / windowCalls;
+
+    if (callRate >= s_CallRate && averageDuration <= s_MaxDuration)
+        Suppress(pRecord, callCount, callRate, averageDuration);
+}
+
+void CCallSuppressor::Suppress(_In_ CFunctionRecord* pRecord, _In_ LONG64 callCount, _In_ LONG64 callRate, _In_ LONG64 averageDuration)
+{
+    HRESULT hr = S_OK;
+
+    //Lock scope
+    {
+        CLock suppressedLock(&s_SuppressedMutex, true);
+
+        if (pRecord->m_Suppressed)
+            return;
+
+        s_Suppressed.push_back(pRecord);
+
+        //Any frames of this function that are currently active will still be left normally
+        pRecord->m_Suppressed = TRUE;
+    }
+
+    LogShouldHook(L"Suppressing " FORMAT_PTR " (%I64d calls/sec)\n", pRecord->m_FunctionId, callRate);
+
+    ValidateETW(EventWriteFunctionSuppressedEvent(
+        pRecord->m_FunctionId,
+        callCount,
+        callRate,
+        averageDuration * NS_PER_SECOND / s_Frequency
+    ));
+}
+
+/// <summary>
+/// Writes a SuppressedFunctionsEvent containing the FunctionIDs of all functions that have been suppressed so far.
+/// </summary>
+void CCallSuppressor::WriteSuppressedFunctions()
+{
+    HRESULT hr = S_OK;
+    CThreadContext* pContext = GetThreadContext();
+
+    //This is only ever called from the pipe thread, which doesn't otherwise use its value buffer at the same time
+    BYTE* ptr = pContext->ValueBuffer;
+
+    //Lock scope
+    {
+        CLock suppressedLock(&s_SuppressedMutex);
+
+        size_t maxFunctions = VALUE_BUFFER_SIZE / sizeof(UINT64);
+
+        for (size_t i = 0; i < s_Suppressed.size() && i < maxFunctions; i++)
+        {
+            UINT64 functionId = s_Suppressed[i]->m_FunctionId;
+
+            memcpy(ptr, &functionId, sizeof(UINT64));
+            ptr += sizeof(UINT64);
+        }
+    }
+
+    ValidateETW(EventWriteSuppressedFunctionsEvent((ULONG)(ptr - pContext->ValueBuffer), pContext->ValueBuffer));
+}
\ No newline at end of file
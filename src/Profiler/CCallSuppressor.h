@@ -0,0 +1,63 @@
+#pragma once
+
+#include "CFunctionRecord.h"
+#include <vector>
+
+extern BOOL g_SuppressionEnabled;
+
+struct CThreadContext;
+
+//The number of functions each thread can accumulate calls against before folding them into their records
+#define PENDING_SUPPRESSOR_CALLS_SIZE 64
+
+//The number of calls a thread accumulates against a function before folding them into its record
+#define SUPPRESSOR_FOLD_CALLS 128
+
+/// <summary>
+/// Stores the calls a thread has made to a function that haven't yet been added to the function's <see cref="CFunctionRecord"/>.
+/// </summary>
+struct PendingSuppressorCalls
+{
+    CFunctionRecord* pRecord;
+    LONG64 CallCount;
+    LONG64 TotalDuration;
+};
+
+/// <summary>
+/// Stops writing call events for tiny functions that are called so frequently they dominate the trace.<para/>
+/// The duration of each call to a hooked function is measured and accumulated by the calling thread, which periodically folds the calls
+/// it has made into the function's <see cref="CFunctionRecord"/>, so that threads calling the same hot function don't contend on its record. At the end of each
+/// measurement window, if a leaf function was called at least as often as the configured call rate, and its calls took no longer than the configured
+/// duration on average, the function is suppressed. A single FunctionSuppressedEvent is written describing the function, after which its frames are still
+/// tracked on the shadow stack, but no longer consume sequence numbers or produce any events.<para/>
+/// If a suppressed frame turns out to call another function, the function is unsuppressed, and the frame is entered normally before its child is.
+/// </summary>
+class CCallSuppressor
+{
+public:
+    static HRESULT Initialize();
+
+    static BOOL Enter(_In_ CThreadContext* pContext, _In_ CFunctionRecord* pRecord);
+    static BOOL Leave(_In_ CThreadContext* pContext, _In_ CFunctionRecord* pRecord);
+    static BOOL LeaveSuppressed(_In_ CThreadContext* pContext, _In_ FunctionID functionId);
+
+    static void Unsuppress(_In_ CThreadContext* pContext);
+
+    static void WriteSuppressedFunctions();
+
+private:
+    static void RecordCall(_In_ CThreadContext* pContext, _In_ CFunctionRecord* pRecord, _In_ LONGLONG enterQPC, _In_ BOOL hasChildren);
+    static void FoldCalls(_In_ PendingSuppressorCalls& pending, _In_ LONGLONG qpc);
+    static void Suppress(_In_ CFunctionRecord* pRecord, _In_ LONG64 callCount, _In_ LONG64 callRate, _In_ LONG64 averageDuration);
+
+    static LONGLONG s_Frequency;
+
+    //The number of calls per second a function must reach before it can be suppressed
+    static LONG64 s_CallRate;
+
+    //The maximum average duration (in QPC ticks) of a function that can be suppressed
+    static LONG64 s_MaxDuration;
+
+    static std::vector<CFunctionRecord*> s_Suppressed;
+    static std::shared_mutex s_SuppressedMutex;
+};
\ No newline at end of file
@@ -2,6 +2,10 @@
 #include "CCommunication.h"
 #include "CStaticTracer.h"
 #include "CCorProfilerCallback.h"
+#include "CFlightRecorder.h"
+#include "CCallSuppressor.h"
+#include "CCoverage.h"
+#include "CPInvokeStats.h"
 
 #define MESSAGE_DATA_SIZE 1000
 
@@ -11,7 +15,12 @@ bool g_TracingEnabled = FALSE;
 enum class MessageType
 {
     EnableTracing,
-    GetStaticField
+    GetStaticField,
+    DumpFlightRecorder,
+    GetSuppressedFunctions,
+    Detach,
+    GetCoveredFunctions,
+    GetPInvokeStats
 };
 
 typedef struct _Message {
@@ -56,13 +65,37 @@ DWORD WINAPI PipeThreadProc(LPVOID lpParameter)
             switch (message->Type)
             {
             case MessageType::EnableTracing:
-                g_TracingEnabled = *(bool*)message->Data;
+                g_pProfiler->SetTracingEnabled(*(bool*)message->Data);
                 break;
 
             case MessageType::GetStaticField:
                 CStaticTracer::Trace((LPWSTR)message->Data);
                 break;
 
+            case MessageType::DumpFlightRecorder:
+                if (g_FlightRecorderEnabled)
+                    CFlightRecorder::Dump(FlightRecorderDumpReason::Command);
+                break;
+
+            case MessageType::GetSuppressedFunctions:
+                CCallSuppressor::WriteSuppressedFunctions();
+                break;
+
+            case MessageType::GetCoveredFunctions:
+                //Always respond, so that a client that requests coverage when it isn't enabled isn't left waiting
+                CCoverage::WriteCoveredFunctions();
+                break;
+
+            case MessageType::GetPInvokeStats:
+                CPInvokeStats::WritePInvokeStats();
+                break;
+
+            case MessageType::Detach:
+                //Once the runtime begins detaching there's nothing left for the client to talk to
+                if (SUCCEEDED(g_pProfiler->Detach()))
+                    return 0;
+                break;
+
             default:
                 dprintf(L"Don't know how to handle MessageType %d\n", message->Type);
                 break;
@@ -0,0 +1,164 @@
+#include "pch.h"
+#include "CContinuousProfiler.h"
+#include "CCorProfilerCallback.h"
+#include "CHookCalibrator.h"
+#include "CValueTracer.h"
+#include "Events.h"
+#include <algorithm>
+
+BOOL g_ContinuousEnabled = FALSE;
+
+DWORD CContinuousProfiler::s_Interval = 0;
+LONGLONG CContinuousProfiler::s_Frequency = 0;
+CIntervalThread CContinuousProfiler::s_Thread;
+
+#define NS_PER_SECOND 1000000000
+
+HRESULT CContinuousProfiler::Initialize()
+{
+    HRESULT hr = S_OK;
+    LARGE_INTEGER frequency;
+
+    if (!GetIntSetting("DEBUGTOOLS_CONTINUOUS_INTERVAL", &s_Interval) || s_Interval == 0)
+        goto ErrExit;
+
+    QueryPerformanceFrequency(&frequency);
+    s_Frequency = frequency.QuadPart;
+
+    g_ContinuousEnabled = TRUE;
+
+    IfFailGo(s_Thread.Start(SnapshotThreadProc, s_Interval));
+
+ErrExit:
+    return hr;
+}
+
+void CContinuousProfiler::Shutdown()
+{
+    s_Thread.Stop();
+}
+
+/// <summary>
+/// Accumulates the duration of a frame that has just been popped from the shadow stack against its function.
+/// Frames that aren't left via a hook (such as unmanaged transitions and frames unwound by exceptions) have no record to accumulate against.
+/// </summary>
+void CContinuousProfiler::Leave(_In_ CThreadContext* pContext, _In_ const Frame& frame, _In_opt_ CFunctionRecord* pRecord)
+{
+    //Frames that were pushed without recording when they were entered (such as suppressed frames) can't be measured
+    if (frame.EnterQPC == 0)
+        return;
+
+    LARGE_INTEGER qpc;
+    QueryPerformanceCounter(&qpc);
+
+    LONG64 inclusiveDuration = qpc.QuadPart - frame.EnterQPC;
+
+    //Remove the cost of the hooks that ran for each call beneath the frame, the same as CCpuTime::Leave does for cycles
+    LONG64 overhead = (LONG64)(frame.DescendantCalls * CHookCalibrator::s_CompensatedQPC / HOOK_OVERHEAD_QPC_SCALE);
+    inclusiveDuration = inclusiveDuration > overhead ? inclusiveDuration - overhead : 0;
+
+    LONG64 exclusiveDuration = inclusiveDuration - frame.ChildDuration;
+
+    //QPC is consistent across processors, however be defensive in case the thread's frames were unbalanced
+    if (exclusiveDuration < 0)
+        exclusiveDuration = 0;
+
+    if (!pContext->CallStack.empty())
+    {
+        Frame& parent = pContext->CallStack.top();
+
+        parent.ChildDuration += inclusiveDuration;
+        parent.DescendantCalls += frame.DescendantCalls + 1;
+    }
+
+    if (pRecord)
+    {
+        InterlockedIncrement64(&pRecord->m_AggregateCallCount);
+        InterlockedAdd64(&pRecord->m_AggregateInclusiveDuration, inclusiveDuration);
+        InterlockedAdd64(&pRecord->m_AggregateExclusiveDuration, exclusiveDuration);
+    }
+}
+
+DWORD WINAPI CContinuousProfiler::SnapshotThreadProc(LPVOID lpParameter)
+{
+    std::vector<FunctionAggregate> functions;
+
+    while (s_Thread.Wait())
+    {
+        if (g_TracingEnabled)
+            WriteSnapshot(functions);
+    }
+
+    return 0;
+}
+
+/// <summary>
+/// Writes a ContinuousSnapshotEvent describing the functions that were called the most, and that took the most time, since the previous snapshot.
+/// </summary>
+void CContinuousProfiler::WriteSnapshot(_Inout_ std::vector<FunctionAggregate>& functions)
+{
+    HRESULT hr = S_OK;
+    UINT64 totalCalls = 0;
+
+    functions.clear();
+
+    g_pProfiler->ForEachFunctionRecord([&](CFunctionRecord* pRecord)
+    {
+        //Only the snapshot thread modifies the reported values, so they don't need to be read atomically
+        LONG64 callCount = pRecord->m_AggregateCallCount;
+
+        if (callCount == pRecord->m_ReportedCallCount)
+            return;
+
+        LONG64 inclusiveDuration = pRecord->m_AggregateInclusiveDuration;
+        LONG64 exclusiveDuration = pRecord->m_AggregateExclusiveDuration;
+
+        functions.push_back({
+            pRecord->m_FunctionId,
+            (UINT64)(callCount - pRecord->m_ReportedCallCount),
+            (UINT64)(inclusiveDuration - pRecord->m_ReportedInclusiveDuration),
+            (UINT64)(exclusiveDuration - pRecord->m_ReportedExclusiveDuration)
+        });
+
+        totalCalls += callCount - pRecord->m_ReportedCallCount;
+
+        pRecord->m_ReportedCallCount = callCount;
+        pRecord->m_ReportedInclusiveDuration = inclusiveDuration;
+        pRecord->m_ReportedExclusiveDuration = exclusiveDuration;
+    });
+
+    if (functions.size() > CONTINUOUS_TOP_FUNCTIONS * 2)
+    {
+        //Move the functions that took the most time to the front, and then the functions that were called the most
+        //out of those that remain directly after them
+        std::partial_sort(functions.begin(), functions.begin() + CONTINUOUS_TOP_FUNCTIONS, functions.end(), [](const FunctionAggregate& a, const FunctionAggregate& b)
+        {
+            return a.ExclusiveDuration > b.ExclusiveDuration;
+        });
+
+        std::partial_sort(functions.begin() + CONTINUOUS_TOP_FUNCTIONS, functions.begin() + CONTINUOUS_TOP_FUNCTIONS * 2, functions.end(), [](const FunctionAggregate& a, const FunctionAggregate& b)
+        {
+            return a.CallCount > b.CallCount;
+        });
+
+        functions.resize(CONTINUOUS_TOP_FUNCTIONS * 2);
+    }
+
+    for (FunctionAggregate& function : functions)
+    {
+        function.InclusiveDuration = QPCToNanoseconds(function.InclusiveDuration);
+        function.ExclusiveDuration = QPCToNanoseconds(function.ExclusiveDuration);
+    }
+
+    ValidateETW(EventWriteContinuousSnapshotEvent(
+        totalCalls,
+        (ULONG)(functions.size() * sizeof(FunctionAggregate)),
+        (const BYTE*)functions.data()
+    ));
+}
+
+UINT64 CContinuousProfiler::QPCToNanoseconds(_In_ LONG64 qpc)
+{
+    //Split the conversion so that long durations don't overflow
+    return (qpc / s_Frequency) * NS_PER_SECOND + (qpc % s_Frequency) * NS_PER_SECOND / s_Frequency;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include "CIntervalThread.h"
+#include "CThreadContext.h"
+#include "CFunctionRecord.h"
+
+extern BOOL g_ContinuousEnabled;
+
+//The number of functions included in each snapshot by exclusive duration, and separately by call count. This bounds the size
+//of each snapshot to a few KB regardless of how many functions were called during the interval
+#define CONTINUOUS_TOP_FUNCTIONS 64
+
+typedef struct FunctionAggregate {
+    UINT64 FunctionId;
+    UINT64 CallCount;
+    UINT64 InclusiveDuration;
+    UINT64 ExclusiveDuration;
+} FunctionAggregate;
+
+/// <summary>
+/// Profiles a process continuously at a fixed, low bandwidth, without writing any per-call events.<para/>
+/// The hooks only maintain the shadow stack, and when each frame is left, its duration is accumulated in its <see cref="CFunctionRecord"/>.
+/// At each interval, a background thread computes how much each function's counters have changed since the previous interval and writes a single
+/// ContinuousSnapshotEvent containing the functions that were called the most, and that took the most time, during the interval.
+/// </summary>
+class CContinuousProfiler
+{
+public:
+    static HRESULT Initialize();
+    static void Shutdown();
+
+    static void Leave(_In_ CThreadContext* pContext, _In_ const Frame& frame, _In_opt_ CFunctionRecord* pRecord);
+
+private:
+    static DWORD WINAPI SnapshotThreadProc(LPVOID lpParameter);
+
+    static void WriteSnapshot(_Inout_ std::vector<FunctionAggregate>& functions);
+
+    static UINT64 QPCToNanoseconds(_In_ LONG64 qpc);
+
+    static DWORD s_Interval;
+    static LONGLONG s_Frequency;
+    static CIntervalThread s_Thread;
+};
\ No newline at end of file
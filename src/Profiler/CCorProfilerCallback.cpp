@@ -1,19 +1,23 @@
 #include "pch.h"
 #include "CCorProfilerCallback.h"
 #include "CExceptionInfo.h"
+#include "CILRewriter.h"
+#include "CFlightRecorder.h"
+#include "CCallStackSnapshot.h"
+#include "CCallCoalescer.h"
+#include "CContinuousProfiler.h"
+#include "CCoverage.h"
+#include "CCpuTime.h"
+#include "CHookCalibrator.h"
+#include "CPInvokeStats.h"
+#include "CSlowCallCapture.h"
+#include "CSampler.h"
+#include "CStackWalkSampler.h"
 #include "CSigReader.h"
 #include "Hooks\Hooks.h"
 #include <bcrypt.h>
 #include <strsafe.h>
 
-//Thread local buffers (to avoid reallocating with each RecordFunction invocation that is made)
-
-thread_local WCHAR g_szMethodName[NAME_BUFFER_SIZE];
-thread_local WCHAR g_szTypeName[NAME_BUFFER_SIZE];
-thread_local WCHAR g_szModuleName[NAME_BUFFER_SIZE];
-thread_local WCHAR g_szAssemblyName[NAME_BUFFER_SIZE];
-thread_local WCHAR g_szFieldName[NAME_BUFFER_SIZE];
-
 ULONG g_NextUniqueModuleID = 0;
 ULONG g_ThreadSequence = 0;
 
@@ -82,36 +86,37 @@ HRESULT CCorProfilerCallback::QueryInterface(REFIID riid, void** ppvObject)
 HRESULT CCorProfilerCallback::UnmanagedToManagedTransition(FunctionID functionId, COR_PRF_TRANSITION_REASON reason)
 {
     HRESULT hr = S_OK;
+    CThreadContext* pContext = GetThreadContext();
 
-    EnsureTransitionMethodRecorded(functionId);
+    EnsureTransitionMethodRecorded(pContext, functionId);
 
-    if (!g_ExceptionQueue.empty())
+    if (pContext->ExceptionsPending)
     {
-        ULONG oldSequence = g_Sequence;
+        ULONG oldSequence = pContext->Sequence;
 
         m_ExceptionManager.UnmanagedToManagedTransition(functionId, reason);
 
         //If LEAVE_FUNCTION was called, an ExceptionFrameUnwindEvent was executed, and both the profiler and the controller know
         //that the frame has been left. As such, there's nothing more we need to do here
-        if (oldSequence != g_Sequence)
+        if (oldSequence != pContext->Sequence)
             goto ErrExit;
     }
 
     if (reason == COR_PRF_TRANSITION_CALL)
     {
-        ENTER_FUNCTION(functionId, FrameKind::U2M);
+        ENTER_FUNCTION(pContext, functionId, FrameKind::U2M);
         LogCall(L"U2M Call", functionId);
     }
     else
     {
-        LEAVE_FUNCTION(functionId);
+        LEAVE_FUNCTION(pContext, functionId);
         LogCall(L"U2M Return", functionId);
     }
 
-    if (!g_TracingEnabled)
+    if (!g_TracingEnabled || g_SamplingEnabled || g_ContinuousEnabled)
         return hr;
 
-    ValidateETW(EventWriteUnmanagedToManagedEvent(functionId, g_Sequence, reason));
+    ValidateETW(EventWriteUnmanagedToManagedEvent(functionId, pContext->Sequence, reason));
 
 ErrExit:
     return hr;
@@ -120,36 +125,43 @@ ErrExit:
 HRESULT CCorProfilerCallback::ManagedToUnmanagedTransition(FunctionID functionId, COR_PRF_TRANSITION_REASON reason)
 {
     HRESULT hr = S_OK;
+    CThreadContext* pContext = GetThreadContext();
 
-    EnsureTransitionMethodRecorded(functionId);
+    EnsureTransitionMethodRecorded(pContext, functionId);
 
-    if (!g_ExceptionQueue.empty())
+    if (pContext->ExceptionsPending)
     {
-        ULONG oldSequence = g_Sequence;
+        ULONG oldSequence = pContext->Sequence;
 
         m_ExceptionManager.ManagedToUnmanagedTransition(functionId, reason);
 
         //If LEAVE_FUNCTION was called, an ExceptionFrameUnwindEvent was executed, and both the profiler and the controller know
         //that the frame has been left. As such, there's nothing more we need to do here
-        if (oldSequence != g_Sequence)
+        if (oldSequence != pContext->Sequence)
             goto ErrExit;
     }
 
     if (reason == COR_PRF_TRANSITION_CALL)
     {
-        ENTER_FUNCTION(functionId, FrameKind::M2U);
+        ENTER_FUNCTION(pContext, functionId, FrameKind::M2U);
         LogCall(L"M2U Call", functionId);
+
+        if (g_PInvokeStatsEnabled)
+            CPInvokeStats::Call(pContext->CallStack.top());
     }
     else
     {
-        LEAVE_FUNCTION(functionId);
+        if (g_PInvokeStatsEnabled)
+            CPInvokeStats::Return(pContext, functionId);
+
+        LEAVE_FUNCTION(pContext, functionId);
         LogCall(L"M2U Return", functionId);
     }
 
-    if (!g_TracingEnabled)
+    if (!g_TracingEnabled || g_SamplingEnabled || g_ContinuousEnabled)
         return hr;
 
-    ValidateETW(EventWriteManagedToUnmanagedEvent(functionId, g_Sequence, reason));
+    ValidateETW(EventWriteManagedToUnmanagedEvent(functionId, pContext->Sequence, reason));
 
 ErrExit:
     return hr;
@@ -216,6 +228,7 @@ HRESULT CCorProfilerCallback::ModuleAttachedToAssembly(ModuleID moduleId, Assemb
     //This method only executes in detailed profiling mode and the hrStatus passed to ModuleLoadFinished SUCCEEDED()
 
     HRESULT hr = S_OK;
+    CThreadContext* pContext = GetThreadContext();
     CAssemblyInfo* pAssemblyInfo = nullptr;
     CAssemblyName* pAssemblyName = nullptr;
     IMetaDataImport2* pMDI = nullptr;
@@ -262,7 +275,7 @@ HRESULT CCorProfilerCallback::ModuleAttachedToAssembly(ModuleID moduleId, Assemb
             &pbPublicKey,
             &cbPublicKey,
             NULL,
-            g_szAssemblyName,
+            pContext->szAssemblyName,
             NAME_BUFFER_SIZE,
             &chName,
             &asmMetaData,
@@ -303,8 +316,8 @@ ErrExit:
 
         pAssemblyInfo->AddModule(pModuleInfo);
 
-        IfFailGo(m_pInfo->GetModuleInfo(moduleId, NULL, NAME_BUFFER_SIZE, NULL, g_szModuleName, NULL));
-        ValidateETW(EventWriteModuleLoadedEvent(pModuleInfo->m_UniqueModuleID, g_szModuleName));
+        IfFailGo(m_pInfo->GetModuleInfo(moduleId, NULL, NAME_BUFFER_SIZE, NULL, pContext->szModuleName, NULL));
+        ValidateETW(EventWriteModuleLoadedEvent(pModuleInfo->m_UniqueModuleID, pContext->szModuleName));
     }
     else
     {
@@ -466,12 +479,25 @@ HRESULT CCorProfilerCallback::Initialize(IUnknown* pICorProfilerInfoUnk)
             ::Sleep(100);
     }    
 
-    m_Detailed = GetBoolEnv("DEBUGTOOLS_DETAILED");
+    //Detailed mode relies on ELT hooks, which can only be installed on startup
+    m_Detailed = GetBoolEnv("DEBUGTOOLS_DETAILED") && !m_Attached;
+
+    //Detailed mode relies on the COR_PRF_ELT_INFO passed to the ELT hooks to read argument and return values
+    m_ILInstrumentation = GetBoolEnv("DEBUGTOOLS_ILINSTRUMENTATION") && !m_Detailed;
+
+    //ELT hooks require COR_PRF_MONITOR_ENTERLEAVE, which (along with the COR_PRF_MONITOR_CODE_TRANSITIONS we monitor alongside it) causes the CLR
+    //to reject every native image that wasn't generated for profiling. Native images can only be preserved when we're rewriting IL ourselves
+    m_PreserveNativeImages = GetBoolEnv("DEBUGTOOLS_PRESERVE_NATIVE_IMAGES") && m_ILInstrumentation;
+
     g_TracingEnabled = GetBoolEnv("DEBUGTOOLS_TRACESTART");
     g_IsETW = !GetBoolEnv("DEBUGTOOLS_SYNCHRONOUS_TRANSFERS");
 
     GetMatchItems(L"DEBUGTOOLS_MODULEBLACKLIST", m_ModuleBlacklist);
     GetMatchItems(L"DEBUGTOOLS_MODULEWHITELIST", m_ModuleWhitelist);
+    GetMatchItems(L"DEBUGTOOLS_TRIVIALWHITELIST", m_TrivialWhitelist);
+    GetMatchItems(L"DEBUGTOOLS_SLOW_CALL_TRIGGERS", m_SlowCallTriggers);
+
+    m_MaxTrivialILSize = GetTrivialILSize();
 
     GetDefaultBlacklistItems(m_ModuleBlacklist);
 
@@ -480,26 +506,99 @@ HRESULT CCorProfilerCallback::Initialize(IUnknown* pICorProfilerInfoUnk)
     g_pProfiler = this;
 
     BindLifetimeToParentProcess();
+    IfFailGo(CFlightRecorder::Initialize());
+    IfFailGo(CCallStackSnapshot::Initialize());
+    CCallCoalescer::Initialize();
+    IfFailGo(CCallSuppressor::Initialize());
+    IfFailGo(CSampler::Initialize());
+    IfFailGo(CCoverage::Initialize());
+    IfFailGo(CCpuTime::Initialize());
+    IfFailGo(CPInvokeStats::Initialize());
+    IfFailGo(CSlowCallCapture::Initialize());
+
+    //Coverage and sampling don't time each frame, so there would be nothing for the continuous profiler to report
+    if (!g_CoverageEnabled && !g_SamplingEnabled)
+        IfFailGo(CContinuousProfiler::Initialize());
+
+    //Coverage only needs to know whether each function was entered, which the WithInfo hooks would only slow down
+    if (g_CoverageEnabled)
+        m_Detailed = FALSE;
+
+    //CPU time is reported per frame, so is only meaningful when each call is written. The CallCpuTimeEvent written prior to each
+    //CallLeaveEvent would prevent the coalescer from merging the call anyway
+    if (g_CoverageEnabled || g_SamplingEnabled)
+        g_CpuTimeEnabled = FALSE;
+    else if (g_CpuTimeEnabled)
+        g_CoalesceCalls = FALSE;
+
+    //Continuous profiling doesn't write any per-frame events, and suppressed frames wouldn't contribute to the aggregates
+    if (g_ContinuousEnabled)
+    {
+        m_Detailed = FALSE;
+        g_CpuTimeEnabled = FALSE;
+        g_SuppressionEnabled = FALSE;
+    }
+
+    //Each of these modes already decides which call events are transferred. Otherwise, the coalescer would hold back the events
+    //that close a captured call until after its capture had been completed
+    if (g_FlightRecorderEnabled || g_CoverageEnabled || g_SamplingEnabled || g_ContinuousEnabled)
+        g_SlowCallCaptureEnabled = FALSE;
+    else if (g_SlowCallCaptureEnabled)
+        g_CoalesceCalls = FALSE;
+
     IfFailGo(m_Communication.Initialize());
 
     IfFailGo(pICorProfilerInfoUnk->QueryInterface(&m_pInfo));
+    IfFailGo(CStackWalkSampler::Initialize(m_pInfo));
 
-    IfFailGo(m_pInfo->SetFunctionIDMapper2(RecordFunction, nullptr));
+    //When attaching, the only way to hook functions is to instrument them
+    if (m_Attached && !g_StackWalkSamplingEnabled)
+        m_ILInstrumentation = TRUE;
+
+    //The hooks can only be skipped while tracing is disabled when nothing else relies on them in the meantime
+    m_UnhookWhenNotTracing = GetBoolEnv("DEBUGTOOLS_UNHOOK_WHEN_NOT_TRACING") && !m_Detailed && !g_CoverageEnabled && !g_SamplingEnabled &&
+        !g_ContinuousEnabled && !g_CpuTimeEnabled && !g_SuppressionEnabled && !g_PInvokeStatsEnabled && !g_SlowCallCaptureEnabled;
+
+    g_HooksDisabled = m_UnhookWhenNotTracing && !g_TracingEnabled;
+
+    //When sampling via stack walks, functions are recorded as they're observed on a stack rather than as they're JITted,
+    //and no hooks are installed
+    if (!g_StackWalkSamplingEnabled && !m_ILInstrumentation)
+        IfFailGo(m_pInfo->SetFunctionIDMapper2(RecordFunction, nullptr));
 
     IfFailGo(SetEventMask());
     
-    if (m_Detailed)
+    if (!g_StackWalkSamplingEnabled)
     {
-        IfFailGo(CValueTracer::Initialize(m_pInfo));
+        //The stubs are called from the rewritten IL of each method as it's JITted
+        if (m_ILInstrumentation)
+            SelectHookStubs();
+        else if (m_Detailed)
+        {
+            IfFailGo(CValueTracer::Initialize(m_pInfo));
 
-        IfFailGo(HRESULT_FROM_NT(BCryptCreateHash(BCRYPT_SHA1_ALG_HANDLE, &m_hHash, NULL, 0, NULL, 0, NULL)));
-        IfFailGo(InstallHooksWithInfo());
+            IfFailGo(HRESULT_FROM_NT(BCryptCreateHash(BCRYPT_SHA1_ALG_HANDLE, &m_hHash, NULL, 0, NULL, 0, NULL)));
+            IfFailGo(InstallHooksWithInfo());
+        }
+        else
+            IfFailGo(InstallHooks());
+    }
+
+    //Coverage stubs don't time anything, the WithInfo hooks can only be given their ELT info by the CLR, and the sampler could observe the
+    //calibration record on this thread's stack. The events written by the hooks being calibrated must never reach the client, so the hooks
+    //must be calibrated before the provider is registered
+    if (!g_StackWalkSamplingEnabled && !m_Detailed && !g_CoverageEnabled && !g_SamplingEnabled)
+    {
+        if (m_ILInstrumentation)
+            CHookCalibrator::Calibrate((FunctionEnter3*)g_pEnterStub, (FunctionLeave3*)g_pLeaveStub);
+        else
+            CHookCalibrator::Calibrate((FunctionEnter3*)EnterNaked, (FunctionLeave3*)LeaveNaked);
     }
-    else
-        IfFailGo(InstallHooks());
 
     IfFailWin32Go(EventRegisterDebugToolsProfiler());
 
+    CHookCalibrator::WriteHookOverhead();
+
 ErrExit:
     return hr;
 }
@@ -514,6 +613,23 @@ ErrExit:
 HRESULT CCorProfilerCallback::Shutdown()
 {
     HRESULT hr = S_OK;
+
+    //Background threads must not write any more events once the provider has been unregistered
+    StopBackgroundThreads();
+
+    //Report any functions that were covered while tracing was disabled
+    if (g_CoverageEnabled)
+        CCoverage::WriteCoveredFunctions();
+
+    //Report the latency of each unmanaged function over the lifetime of the process
+    if (g_PInvokeStatsEnabled)
+        CPInvokeStats::WritePInvokeStats();
+
+    //Threads that are still alive may be holding onto the events of calls they made prior to the runtime shutting down. Each thread's
+    //held events are protected by its CoalescerMutex, so this can't race with a thread that's still writing events
+    if (g_CoalesceCalls)
+        CThreadContext::ForEach([](CThreadContext* pContext) { CCallCoalescer::FlushThread(pContext); });
+
     ValidateETW(EventWriteShutdownEvent());
     ValidateETW(EventUnregisterDebugToolsProfiler());
     return hr;
@@ -530,6 +646,9 @@ HRESULT CCorProfilerCallback::ThreadCreated(ThreadID threadId)
 
     LogThread(L"ThreadCreated " FORMAT_PTR "\n", threadId);
 
+    if (g_StackWalkSamplingEnabled)
+        CStackWalkSampler::ThreadCreated(threadId);
+
     ULONG threadSequence = GetThreadSequence(threadId);
 
     DWORD win32ThreadId;
@@ -552,17 +671,79 @@ HRESULT CCorProfilerCallback::ThreadDestroyed(ThreadID threadId)
 
     LogThread(L"ThreadDestroyed " FORMAT_PTR "\n", threadId);
 
+    if (g_StackWalkSamplingEnabled)
+        CStackWalkSampler::ThreadDestroyed(threadId);
+
     ULONG threadSequence = GetThreadSequence(threadId);
 
     DWORD win32ThreadId;
     IfFailGo(m_pInfo->GetThreadInfo(threadId, &win32ThreadId));
 
+    //The thread won't write any more events that would cause the events it's holding onto to be flushed, so they must be written
+    //before the thread is reported as destroyed. This can't be deferred until the thread detaches from the profiler, as the loader
+    //lock is held at that point. ThreadDestroyed isn't always called on the thread being destroyed, in which case that thread has
+    //already stopped running managed code
+    if (g_CoalesceCalls || g_SlowCallCaptureEnabled)
+    {
+        CThreadContext::ForThread(win32ThreadId, [](CThreadContext* pContext)
+        {
+            if (g_CoalesceCalls)
+                CCallCoalescer::FlushThread(pContext);
+
+            if (g_SlowCallCaptureEnabled)
+                CSlowCallCapture::Flush(pContext);
+        });
+    }
+
     ValidateETW(EventWriteThreadDestroyEvent(threadSequence, win32ThreadId));
 
 ErrExit:
     return hr;
 }
 
+/// <summary>
+/// Notifies the profiler that the JIT has started compiling a function. When IL instrumentation is enabled, the IL of the function is rewritten
+/// before the JIT sees it.
+/// </summary>
+/// <param name="functionId">The ID of the function that is being JITted.</param>
+/// <param name="fIsSafeToBlock">Whether blocking will affect the runtime.</param>
+/// <returns>A HRESULT that indicates whether the profiler encountered an error processing the event.</returns>
+HRESULT CCorProfilerCallback::JITCompilationStarted(FunctionID functionId, BOOL fIsSafeToBlock)
+{
+    if (!m_ILInstrumentation)
+        return S_OK;
+
+    //If the function can't be instrumented, it simply won't be traced
+    InstrumentFunction(functionId);
+
+    return S_OK;
+}
+
+/// <summary>
+/// Notifies the profiler that the runtime is about to use precompiled (NGEN or ReadyToRun) code for a function. When native images are being preserved,
+/// functions belonging to modules that should be hooked are forced to be JITted so that they can be instrumented.
+/// </summary>
+/// <param name="functionId">The ID of the function whose precompiled code was found.</param>
+/// <param name="pbUseCachedFunction">Receives whether the runtime should use the precompiled code.</param>
+/// <returns>A HRESULT that indicates whether the profiler encountered an error processing the event.</returns>
+HRESULT CCorProfilerCallback::JITCachedFunctionSearchStarted(FunctionID functionId, BOOL* pbUseCachedFunction)
+{
+    HRESULT hr = S_OK;
+    ModuleID moduleId;
+
+    *pbUseCachedFunction = TRUE;
+
+    IfFailGo(m_pInfo->GetFunctionInfo(functionId, NULL, &moduleId, NULL));
+    IfFailGo(m_pInfo->GetModuleInfo(moduleId, NULL, NAME_BUFFER_SIZE, NULL, GetThreadContext()->szModuleName, NULL));
+
+    //ShouldHook() only considers the module, so this may still JIT functions that RecordFunction later decides are trivial
+    if (ShouldHook())
+        *pbUseCachedFunction = FALSE;
+
+ErrExit:
+    return hr;
+}
+
 #pragma endregion
 #pragma region ICorProfilerCallback2
 
@@ -589,6 +770,81 @@ ErrExit:
     return hr;
 }
 
+#pragma endregion
+#pragma region ICorProfilerCallback3
+
+/// <summary>
+/// Initializes the profiler after it has been attached to a process that is already running.
+/// </summary>
+/// <param name="pCorProfilerInfoUnk">A clr!ProfToEEInterfaceImpl object that should be queried to retrieve an ICorProfilerInfo* interface.</param>
+/// <param name="pvClientData">A block of NAME=VALUE strings specifying the settings the profiler should use. Each string is null terminated,
+/// with the block ending in an additional null terminator.</param>
+/// <param name="cbClientData">The size of the block pointed to by pvClientData.</param>
+/// <returns>A HRESULT that indicates success or failure. In the event of failure the profiler and its DLL will be unloaded.</returns>
+HRESULT CCorProfilerCallback::InitializeForAttach(IUnknown* pCorProfilerInfoUnk, void* pvClientData, UINT cbClientData)
+{
+    //When the profiler is attached, the settings can't be passed via the environment of the target process. The client
+    //passes them in the same format instead, so that they can be read exactly as they would be on startup
+    CSettings::LoadClientData(pvClientData, cbClientData);
+
+    m_Attached = TRUE;
+
+    //Functions that were instrumented while we were attached will continue to call into us even after we've detached,
+    //and the runtime doesn't guarantee those frames are gone by the time we're unloaded. Prevent the DLL from ever being unloaded
+    HMODULE hModule;
+    GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_PIN, (LPCWSTR)&CCorProfilerCallback::RecordFunction, &hModule);
+
+    return Initialize(pCorProfilerInfoUnk);
+}
+
+/// <summary>
+/// Notifies the profiler that it has been attached and that it may now safely enumerate existing threads and JITted functions.
+/// </summary>
+/// <returns>A HRESULT that indicates whether the profiler encountered an error processing the event.</returns>
+HRESULT CCorProfilerCallback::ProfilerAttachComplete()
+{
+    HRESULT hr = S_OK;
+    ICorProfilerThreadEnum* pThreadEnum = nullptr;
+    ThreadID threadId;
+    ULONG fetched;
+
+    //We won't receive ThreadCreated notifications for any threads that existed before we were attached
+    IfFailGo(m_pInfo->EnumThreads(&pThreadEnum));
+
+    while (pThreadEnum->Next(1, &threadId, &fetched) == S_OK)
+        ThreadCreated(threadId);
+
+ErrExit:
+    if (pThreadEnum)
+        pThreadEnum->Release();
+
+    return hr;
+}
+
+/// <summary>
+/// Notifies the profiler that it is about to be unloaded after a call to <see cref="Detach"/>.
+/// </summary>
+/// <returns>A HRESULT that indicates whether the profiler encountered an error processing the event.</returns>
+HRESULT CCorProfilerCallback::ProfilerDetachSucceeded()
+{
+    HRESULT hr = Shutdown();
+
+    //Instrumented methods embed their function record in their IL and will continue to call the stubs, however the stubs no longer look at the
+    //record they're given, and any thread that was already past that check has long since left the stub by the time the CLR has waited for
+    //DETACH_TIMEOUT to expire
+    //Lock scope
+    {
+        CLock methodLock(&m_MethodMutex, true);
+
+        for (auto& kv : m_FunctionRecordMap)
+            delete kv.second;
+
+        m_FunctionRecordMap.clear();
+    }
+
+    return hr;
+}
+
 #pragma endregion
 #pragma region CCorProfilerCallback
 
@@ -618,18 +874,29 @@ CCorProfilerCallback::~CCorProfilerCallback()
     for (auto const& kv : m_ArrayTypeMap)
         delete kv.second;
 
+    for (auto const& kv : m_FunctionRecordMap)
+        delete kv.second;
+
     if (m_pInfo)
         m_pInfo->Release();
 
     if (m_hHash)
         BCryptDestroyHash(m_hHash);
 
+    //Don't create a context for the thread the profiler is being destroyed on if it never had one
+    CThreadContext* pContext = g_pThreadContext;
+
+    if (pContext)
+    {
 #if _DEBUG
-    _ASSERTE(g_ExceptionQueue.empty());
+        _ASSERTE(pContext->ExceptionQueue.empty());
 #endif
 
-    for (auto const& kv : g_ExceptionQueue)
-        delete kv;
+        for (auto const& kv : pContext->ExceptionQueue)
+            delete kv;
+
+        pContext->ExceptionQueue.clear();
+    }
 
 #if _DEBUG && DEBUG_UNKNOWN
     _ASSERTE(g_UnknownMap->size() == 1); //+1 for CSigType Sentinel which is a static member
@@ -648,7 +915,7 @@ void CCorProfilerCallback::GetMatchItems(
         return; } while(0)
 
     WCHAR szBuffer[MATCH_BUFFER_SIZE];
-    int length = GetEnvironmentVariable(envVar, szBuffer, MATCH_BUFFER_SIZE);
+    int length = GetSetting(envVar, szBuffer, MATCH_BUFFER_SIZE);
 
     if (length == 0 || length >= MATCH_BUFFER_SIZE)
         return;
@@ -747,6 +1014,7 @@ void CCorProfilerCallback::GetDefaultBlacklistItems(
 UINT_PTR __stdcall CCorProfilerCallback::RecordFunction(FunctionID funcId, void* clientData, BOOL* pbHookFunction)
 {
     HRESULT hr = S_OK;
+    CThreadContext* pContext = GetThreadContext();
 
     ICorProfilerInfo4* pInfo = g_pProfiler->m_pInfo;
     IMetaDataImport2* pMDI = nullptr;
@@ -760,6 +1028,7 @@ UINT_PTR __stdcall CCorProfilerCallback::RecordFunction(FunctionID funcId, void*
 
     CSigMethodDef* method = nullptr;
     BOOL methodSaved = FALSE;
+    CFunctionRecord* pRecord = nullptr;
 
     *pbHookFunction = FALSE;
 
@@ -782,7 +1051,7 @@ UINT_PTR __stdcall CCorProfilerCallback::RecordFunction(FunctionID funcId, void*
     ));
 
     //Get the module name
-    IfFailGo(pInfo->GetModuleInfo(moduleId, NULL, NAME_BUFFER_SIZE, NULL, g_szModuleName, NULL));
+    IfFailGo(pInfo->GetModuleInfo(moduleId, NULL, NAME_BUFFER_SIZE, NULL, pContext->szModuleName, NULL));
 
     if (!ShouldHook())
     {
@@ -791,13 +1060,21 @@ UINT_PTR __stdcall CCorProfilerCallback::RecordFunction(FunctionID funcId, void*
         goto ErrExit;
     }
 
+    //Leaving trivial functions unhooked allows the JIT to inline them again
+    if (g_pProfiler->m_MaxTrivialILSize && IsTrivialFunction(moduleId, methodDef, pMDI))
+    {
+        LogShouldHook(L"Not tracing trivial function " FORMAT_PTR "\n", funcId);
+        *pbHookFunction = FALSE;
+        goto ErrExit;
+    }
+
     if (g_pProfiler->m_Detailed)
     {
         //Get the method name, mdTypeDef and sigblob
         IfFailGo(pMDI->GetMethodProps(
             methodDef,
             &typeDef,
-            g_szMethodName,
+            pContext->szMethodName,
             NAME_BUFFER_SIZE,
             NULL,
             NULL,
@@ -809,16 +1086,19 @@ UINT_PTR __stdcall CCorProfilerCallback::RecordFunction(FunctionID funcId, void*
 
         CSigReader reader(methodDef, pMDI, pSigBlob);
 
-        IfFailGo(reader.ParseMethod(g_szMethodName, TRUE, (CSigMethod**)&method));
+        IfFailGo(reader.ParseMethod(pContext->szMethodName, TRUE, (CSigMethod**)&method));
 
         method->m_ModuleID = moduleId;
 
+        IfFailGo(CValueTracer::BindValuePredicates(pMDI, methodDef, method));
+
         //Lock scope
         {
             CLock methodMutex(&g_pProfiler->m_MethodMutex, true);
 
             g_pProfiler->m_MethodInfoMap[funcId] = method;
             g_pProfiler->m_HookedMethodMap.insert(funcId);
+            pRecord = g_pProfiler->GetOrCreateFunctionRecordNoLock(funcId);
 
             methodSaved = TRUE;
         }
@@ -829,7 +1109,7 @@ UINT_PTR __stdcall CCorProfilerCallback::RecordFunction(FunctionID funcId, void*
         IfFailGo(pMDI->GetMethodProps(
             methodDef,
             &typeDef,
-            g_szMethodName,
+            pContext->szMethodName,
             NAME_BUFFER_SIZE,
             NULL,
             NULL,
@@ -841,20 +1121,36 @@ UINT_PTR __stdcall CCorProfilerCallback::RecordFunction(FunctionID funcId, void*
 
         CLock methodMutex(&g_pProfiler->m_MethodMutex, true);
         g_pProfiler->m_HookedMethodMap.insert(funcId);
+        pRecord = g_pProfiler->GetOrCreateFunctionRecordNoLock(funcId);
     }
 
     //Get the type name
-    IfFailGo(pMDI->GetTypeDefProps(typeDef, g_szTypeName, NAME_BUFFER_SIZE, NULL, NULL, NULL));
+    IfFailGo(pMDI->GetTypeDefProps(typeDef, pContext->szTypeName, NAME_BUFFER_SIZE, NULL, NULL, NULL));
+
+    if (g_SlowCallCaptureEnabled && pRecord && !g_pProfiler->m_SlowCallTriggers.empty())
+    {
+        WCHAR szFullName[NAME_BUFFER_SIZE * 2];
+        swprintf_s(szFullName, L"%s.%s", pContext->szTypeName, pContext->szMethodName);
+
+        for (size_t i = 0; i < g_pProfiler->m_SlowCallTriggers.size(); i++)
+        {
+            if (g_pProfiler->m_SlowCallTriggers[i].IsMatch(szFullName))
+            {
+                pRecord->m_SlowCallTrigger = TRUE;
+                break;
+            }
+        }
+    }
 
     //Write the event
 
-    LogShouldHook(L"Tracing %s " FORMAT_PTR "\n", g_szMethodName, funcId);
+    LogShouldHook(L"Tracing %s " FORMAT_PTR "\n", pContext->szMethodName, funcId);
     *pbHookFunction = true;
 
     if (g_pProfiler->m_Detailed)
-        ValidateETW(EventWriteMethodInfoDetailedEvent(funcId, g_szMethodName, g_szTypeName, g_szModuleName, methodDef));
+        ValidateETW(EventWriteMethodInfoDetailedEvent(funcId, pContext->szMethodName, pContext->szTypeName, pContext->szModuleName, methodDef));
     else
-        ValidateETW(EventWriteMethodInfoEvent(funcId, g_szMethodName, g_szTypeName, g_szModuleName));
+        ValidateETW(EventWriteMethodInfoEvent(funcId, pContext->szMethodName, pContext->szTypeName, pContext->szModuleName));
 
 ErrExit:
     if (FAILED(hr) && !*pbHookFunction)
@@ -868,12 +1164,171 @@ ErrExit:
     if (pMDI)
         pMDI->Release();
 
+    //Hooked functions are identified to the ELT hooks by their function record
+    if (*pbHookFunction)
+        return (UINT_PTR)pRecord;
+
     return funcId;
 }
 
+/// <summary>
+/// Rewrites the IL of a function that is about to be JITted so that it calls the Enter and Leave stubs itself, if RecordFunction decides
+/// the function should be hooked.
+/// </summary>
+/// <param name="functionId">The ID of the function that is being JITted.</param>
+/// <returns>A HRESULT that indicates whether the function was successfully instrumented.</returns>
+HRESULT CCorProfilerCallback::InstrumentFunction(FunctionID functionId)
+{
+    HRESULT hr = S_OK;
+
+    ModuleID moduleId;
+    mdMethodDef methodDef;
+    LPCBYTE pMethodHeader;
+    ULONG cbMethodSize;
+    IMetaDataEmit* pMDE = nullptr;
+    IMethodMalloc* pMalloc = nullptr;
+    mdSignature probeSig;
+    BYTE* pNewMethodHeader;
+    BOOL hook;
+    UINT_PTR clientId;
+    CILRewriter rewriter;
+
+    IfFailGo(m_pInfo->GetFunctionInfo(functionId, NULL, &moduleId, &methodDef));
+
+    //Lock scope
+    {
+        CLock instrumentedLock(&m_InstrumentedMethodMutex, true);
+
+        //Subsequent instantiations of a generic method will be reported as the instantiation that was JITted first
+        if (!m_InstrumentedMethodMap[moduleId].insert(methodDef).second)
+            goto ErrExit;
+    }
+
+    clientId = RecordFunction(functionId, nullptr, &hook);
+
+    if (!hook)
+        goto ErrExit;
+
+    IfFailGo(m_pInfo->GetILFunctionBody(moduleId, methodDef, &pMethodHeader, &cbMethodSize));
+    IfFailGo(rewriter.Import(pMethodHeader, cbMethodSize));
+
+    //Methods that make tail calls simply won't be traced
+    if (rewriter.HasTailCalls())
+        goto ErrExit;
+
+    //The stubs are invoked via calli, which requires a standalone signature in the module containing the method
+    IfFailGo(m_pInfo->GetModuleMetaData(moduleId, ofRead | ofWrite, IID_IMetaDataEmit, reinterpret_cast<IUnknown**>(&pMDE)));
+    IfFailGo(pMDE->GetTokenFromSig(CILRewriter::ProbeSig, CILRewriter::ProbeSigSize, &probeSig));
+
+    IfFailGo(m_pInfo->GetILFunctionBodyAllocator(moduleId, &pMalloc));
+
+    pNewMethodHeader = (BYTE*)pMalloc->Alloc(rewriter.GetExportSize());
+
+    if (!pNewMethodHeader)
+    {
+        hr = E_OUTOFMEMORY;
+        goto ErrExit;
+    }
+
+    rewriter.Export(clientId, (void*)g_pEnterStub, (void*)g_pLeaveStub, probeSig, pNewMethodHeader);
+
+    IfFailGo(m_pInfo->SetILFunctionBody(moduleId, methodDef, pNewMethodHeader));
+
+ErrExit:
+    if (pMDE)
+        pMDE->Release();
+
+    if (pMalloc)
+        pMalloc->Release();
+
+    return hr;
+}
+
+/// <summary>
+/// Stops the hooks from doing any further work and asks the CLR to unload the profiler. This is only possible when the profiler
+/// was attached, as ELT hooks cannot be removed once they've been installed.
+/// </summary>
+/// <returns>A HRESULT that indicates whether detaching was successfully requested.</returns>
+HRESULT CCorProfilerCallback::Detach()
+{
+#define DETACH_TIMEOUT 5000
+
+    HRESULT hr = S_OK;
+
+    if (!m_Attached)
+        return CORPROF_E_IMMUTABLE_FLAGS_SET;
+
+    //Methods that were rewritten when they were JITted can't be reverted, and will continue calling the stubs for the rest of the process'
+    //lifetime. The stubs return before looking at their function record or the thread's context once the hooks have been disabled
+    g_TracingEnabled = FALSE;
+    g_HooksDisabled = TRUE;
+
+    //The CLR only waits for threads to leave our callbacks before unloading us, so any threads of our own must be gone before then
+    StopBackgroundThreads();
+
+    IfFailGo(m_pInfo->RequestProfilerDetach(DETACH_TIMEOUT));
+
+ErrExit:
+    return hr;
+
+#undef DETACH_TIMEOUT
+}
+
+/// <summary>
+/// Enables or disables tracing in response to a request from the client.
+/// </summary>
+void CCorProfilerCallback::SetTracingEnabled(bool enabled)
+{
+    if (enabled)
+    {
+        //Threads will already be part way through their call stacks by the time tracing is enabled, so ask them to tell the client
+        //about the frames they've already entered. If the hooks were skipped while tracing was disabled, the frames on each thread's
+        //shadow stack can no longer be trusted, and must be discarded instead
+        CCallStackSnapshot::Request(g_HooksDisabled);
+
+        g_TracingEnabled = true;
+        g_HooksDisabled = FALSE;
+    }
+    else
+    {
+        g_TracingEnabled = false;
+        g_HooksDisabled = m_UnhookWhenNotTracing;
+    }
+}
+
+/// <summary>
+/// Stops and waits for every background thread that writes events or calls into the runtime.
+/// </summary>
+void CCorProfilerCallback::StopBackgroundThreads()
+{
+    CSampler::Shutdown();
+    CStackWalkSampler::Shutdown();
+    CContinuousProfiler::Shutdown();
+    CCallStackSnapshot::Shutdown();
+    CFlightRecorder::Shutdown();
+}
+
+CFunctionRecord* CCorProfilerCallback::GetOrCreateFunctionRecordNoLock(FunctionID functionId)
+{
+    auto match = m_FunctionRecordMap.find(functionId);
+
+    if (match != m_FunctionRecordMap.end())
+        return match->second;
+
+    CFunctionRecord* pRecord = new CFunctionRecord(functionId);
+    m_FunctionRecordMap[functionId] = pRecord;
+
+    if (g_CoverageEnabled)
+        CCoverage::AssignIndex(pRecord);
+
+    return pRecord;
+}
+
 BOOL CCorProfilerCallback::ShouldHook()
 {
-    WCHAR* ptr = wcsrchr(g_szModuleName, '\\');
+    CThreadContext* pContext = GetThreadContext();
+
+    WCHAR* ptr = wcsrchr(pContext->szModuleName, '\\');
 
     //Path doesn't contain a slash; assume we should hook it
     if (!ptr)
@@ -885,7 +1340,7 @@ BOOL CCorProfilerCallback::ShouldHook()
     {
         CMatchItem& item = g_pProfiler->m_ModuleBlacklist[i];
 
-        if (item.IsMatch(item.m_MatchKind == MatchKind::ModuleName ? ptr : g_szModuleName))
+        if (item.IsMatch(item.m_MatchKind == MatchKind::ModuleName ? ptr : pContext->szModuleName))
         {
             if (IsWhitelistedModule(ptr))
                 return TRUE;
@@ -903,21 +1358,122 @@ BOOL CCorProfilerCallback::IsWhitelistedModule(LPWSTR moduleName)
     {
         CMatchItem& item = g_pProfiler->m_ModuleWhitelist[i];
 
-        if (item.IsMatch(item.m_MatchKind == MatchKind::ModuleName ? moduleName : g_szModuleName))
+        if (item.IsMatch(item.m_MatchKind == MatchKind::ModuleName ? moduleName : GetThreadContext()->szModuleName))
             return TRUE;
     }
 
     return FALSE;
 }
 
+/// <summary>
+/// Determines whether a function is so simple (such as an auto-property accessor, an empty constructor or a stub that simply forwards to another method)
+/// that hooking it would add more overhead than information.<para/>
+/// A function is considered trivial when its IL body uses the tiny header format (meaning it has no locals, no exception handling clauses
+/// and a small evaluation stack) and its IL is no larger than the configured threshold.
+/// </summary>
+/// <param name="moduleId">The module that contains the function.</param>
+/// <param name="methodDef">The function's metadata token.</param>
+/// <param name="pMDI">The metadata of the module that contains the function.</param>
+/// <returns>TRUE if the function should not be hooked, otherwise FALSE.</returns>
+BOOL CCorProfilerCallback::IsTrivialFunction(ModuleID moduleId, mdMethodDef methodDef, IMetaDataImport2* pMDI)
+{
+    HRESULT hr = S_OK;
+    CThreadContext* pContext = GetThreadContext();
+    LPCBYTE pMethodHeader = nullptr;
+    ULONG cbMethodSize = 0;
+    ULONG codeSize;
+    mdTypeDef typeDef;
+    WCHAR szFullName[NAME_BUFFER_SIZE * 2];
+
+    //Methods without IL (such as P/Invoke and abstract methods) are never trivial
+    if (FAILED(g_pProfiler->m_pInfo->GetILFunctionBody(moduleId, methodDef, &pMethodHeader, &cbMethodSize)) || cbMethodSize == 0)
+        return FALSE;
+
+    //ECMA-335 II.25.4.2: a tiny header stores the code size in its upper 6 bits
+    if ((*pMethodHeader & 0x3) != CorILMethod_TinyFormat)
+        return FALSE;
+
+    codeSize = *pMethodHeader >> 2;
+
+    if (codeSize > g_pProfiler->m_MaxTrivialILSize)
+        return FALSE;
+
+    if (g_pProfiler->m_TrivialWhitelist.empty())
+        return TRUE;
+
+    IfFailGo(pMDI->GetMethodProps(methodDef, &typeDef, pContext->szMethodName, NAME_BUFFER_SIZE, NULL, NULL, NULL, NULL, NULL, NULL));
+    IfFailGo(pMDI->GetTypeDefProps(typeDef, pContext->szTypeName, NAME_BUFFER_SIZE, NULL, NULL, NULL));
+
+    swprintf_s(szFullName, L"%s.%s", pContext->szTypeName, pContext->szMethodName);
+
+    for (size_t i = 0; i < g_pProfiler->m_TrivialWhitelist.size(); i++)
+    {
+        if (g_pProfiler->m_TrivialWhitelist[i].IsMatch(szFullName))
+            return FALSE;
+    }
+
+ErrExit:
+    //If we couldn't get the function's name, err on the side of hooking it
+    return SUCCEEDED(hr);
+}
+
+ULONG CCorProfilerCallback::GetTrivialILSize()
+{
+    ULONG size = 0;
+    GetIntSetting("DEBUGTOOLS_SKIP_TRIVIAL_IL", &size);
+
+    return size;
+}
+
 HRESULT CCorProfilerCallback::SetEventMask()
 {
+    if (g_StackWalkSamplingEnabled)
+    {
+        //No hooks are installed, so NGEN images and inlining can remain enabled. Exceptions and transitions are only monitored
+        //in order to maintain the shadow stack, which doesn't exist in this mode
+        return m_pInfo->SetEventMask(
+            COR_PRF_MONITOR_THREADS |       //Track the threads that can be sampled
+            COR_PRF_ENABLE_STACK_SNAPSHOT   //Allow DoStackSnapshot to be called against other threads
+        );
+    }
+
+    if (m_ILInstrumentation)
+    {
+        //Inlining doesn't need to be disabled, as the JIT won't inline a method containing an unmanaged calli, so methods that have been rewritten
+        //are never inlined into their callers. Code transitions aren't monitored, as the probes are themselves unmanaged calls, and would cause a
+        //transition to be reported around every probe
+        DWORD flags =
+            COR_PRF_MONITOR_JIT_COMPILATION | //Rewrite the IL of each method before it's JITted
+            COR_PRF_MONITOR_THREADS;          //Record basic thread information
+
+        //The Leave probe won't be called when an exception occurs, so we must unwind ourselves. There's no shadow stack to unwind in coverage mode
+        if (!g_CoverageEnabled)
+            flags |= COR_PRF_MONITOR_EXCEPTIONS;
+
+        //Neither NGEN images nor ReJIT can be disabled or enabled after the process has started, so when we're attached only methods that are
+        //JITted after we attached are instrumented
+        if (!m_Attached)
+            flags |= GetNativeImageFlags(); //Methods must be JITted for their IL to be rewritten
+
+        return m_pInfo->SetEventMask(flags);
+    }
+
+    if (g_CoverageEnabled)
+    {
+        //No shadow stack is maintained, so there's no need to monitor exceptions or transitions
+        return m_pInfo->SetEventMask(
+            COR_PRF_MONITOR_ENTERLEAVE | //Inject Enter/Leave/Tailcall hooks during JIT
+            COR_PRF_MONITOR_THREADS    | //Record basic thread information
+            GetNativeImageFlags()        //We need a fresh JIT to be able to inject our Enter/Leave/Tailcall hooks
+        );
+    }
+
     DWORD flags =
         COR_PRF_MONITOR_ENTERLEAVE       | //Inject Enter/Leave/Tailcall hooks during JIT
         COR_PRF_MONITOR_EXCEPTIONS       | //Leave won't be called when an exception occurs, so we must unwind ourselves
         COR_PRF_MONITOR_THREADS          | //Record basic thread information
         COR_PRF_MONITOR_CODE_TRANSITIONS | //Track code transitions (but only when an exception is active) to detect when an exception is caught in unmanaged code
-        COR_PRF_DISABLE_ALL_NGEN_IMAGES;   //Don't use NGEN images (we need a fresh JIT to be able to inject our Enter/Leave/Tailcall hooks)
+        GetNativeImageFlags();             //We need a fresh JIT to be able to inject our Enter/Leave/Tailcall hooks
 
     //WithInfo hooks won't be called unless advanced event flags are set
     if (m_Detailed)
@@ -932,8 +1488,23 @@ HRESULT CCorProfilerCallback::SetEventMask()
     return m_pInfo->SetEventMask(flags);
 }
 
+/// <summary>
+/// Gets the event mask flags that prevent precompiled code from being used for functions that need to be hooked.
+/// </summary>
+DWORD CCorProfilerCallback::GetNativeImageFlags()
+{
+    //Only functions in hooked modules are denied their precompiled code (see JITCachedFunctionSearchStarted). This avoids JITting
+    //the entire framework, at the cost of a callback each time precompiled code is looked up
+    if (m_PreserveNativeImages)
+        return COR_PRF_MONITOR_CACHE_SEARCHES;
+
+    return COR_PRF_DISABLE_ALL_NGEN_IMAGES;
+}
+
 HRESULT CCorProfilerCallback::InstallHooks()
 {
+    SelectHookStubs();
+
     return m_pInfo->SetEnterLeaveFunctionHooks3(
         (FunctionEnter3*)EnterNaked,
         (FunctionLeave3*)LeaveNaked,
@@ -943,6 +1514,8 @@ HRESULT CCorProfilerCallback::InstallHooks()
 
 HRESULT CCorProfilerCallback::InstallHooksWithInfo()
 {
+    SelectHookStubs();
+
     return m_pInfo->SetEnterLeaveFunctionHooks3WithInfo(
         (FunctionEnter3WithInfo*)EnterNakedWithInfo,
         (FunctionLeave3WithInfo*)LeaveNakedWithInfo,
@@ -952,20 +1525,12 @@ HRESULT CCorProfilerCallback::InstallHooksWithInfo()
 
 HRESULT CCorProfilerCallback::BindLifetimeToParentProcess()
 {
-#define BUFFER_SIZE 100
-
     HANDLE hParentProcess;
-
-    CHAR envBuffer[BUFFER_SIZE];
     DWORD parentProcessId;
 
-    DWORD actualSize = GetEnvironmentVariableA("DEBUGTOOLS_PARENT_PID", envBuffer, BUFFER_SIZE);
-
-    if (actualSize == 0 || actualSize >= BUFFER_SIZE)
+    if (!GetIntSetting("DEBUGTOOLS_PARENT_PID", &parentProcessId))
         goto Exit;
 
-    parentProcessId = strtol(envBuffer, NULL, 10);
-
     //The only access right that is mandatory is SYNCHRONIZE; without this
     //RegisterWaitForSingleObject will throw an exception
     hParentProcess = OpenProcess(SYNCHRONIZE, FALSE, parentProcessId);
@@ -1034,6 +1599,7 @@ HRESULT CCorProfilerCallback::CreateClassInfo(
     _Out_ IClassInfo** ppClassInfo)
 {
     HRESULT hr = S_OK;
+    CThreadContext* pContext = GetThreadContext();
 
     IMetaDataImport2* pMDI = nullptr;
 
@@ -1117,9 +1683,9 @@ HRESULT CCorProfilerCallback::CreateClassInfo(
 
         IfFailGo(m_pInfo->GetModuleMetaData(moduleId, ofRead, IID_IMetaDataImport2, (IUnknown**)&pMDI));
 
-        IfFailGo(pMDI->GetTypeDefProps(typeDef, g_szTypeName, NAME_BUFFER_SIZE, NULL, NULL, NULL));
+        IfFailGo(pMDI->GetTypeDefProps(typeDef, pContext->szTypeName, NAME_BUFFER_SIZE, NULL, NULL, NULL));
 
-        CorElementType knownType = GetElementTypeFromClassName(g_szTypeName);
+        CorElementType knownType = GetElementTypeFromClassName(pContext->szTypeName);
 
         if (knownType != ELEMENT_TYPE_END)
         {
@@ -1146,7 +1712,7 @@ HRESULT CCorProfilerCallback::CreateClassInfo(
                 IfFailGo(pMDI->GetFieldProps(
                     fieldDef,
                     NULL,
-                    g_szFieldName,
+                    pContext->szFieldName,
                     NAME_BUFFER_SIZE,
                     NULL,
                     NULL,
@@ -1161,7 +1727,7 @@ HRESULT CCorProfilerCallback::CreateClassInfo(
 
                 CSigField* sigField;
 
-                IfFailGo(reader.ParseField(g_szFieldName, &sigField));
+                IfFailGo(reader.ParseField(pContext->szFieldName, &sigField));
 
                 fields[i] = sigField;
             }
@@ -1171,7 +1737,7 @@ HRESULT CCorProfilerCallback::CreateClassInfo(
             uniqueModuleID = pModuleInfo->m_UniqueModuleID;
 
         pClassInfo = new CClassInfo(
-            g_szTypeName,
+            pContext->szTypeName,
             classId,
             moduleId,
             uniqueModuleID,
@@ -1397,26 +1963,45 @@ BOOL CCorProfilerCallback::IsHookedFunction(FunctionID functionId)
     return m_HookedMethodMap.find(functionId) != m_HookedMethodMap.end();
 }
 
-void CCorProfilerCallback::EnsureTransitionMethodRecorded(FunctionID functionId)
+void CCorProfilerCallback::EnsureTransitionMethodRecorded(CThreadContext* pContext, FunctionID functionId)
 {
     /* Certain transition stubs(such as COMToCLR and CLRToCOM) are meaningless, however when the COM method(or the P/Invoke definition is actually invoked)
      * there is a second helper frame that is called (I think it may be the one that gets inlined). These methods DO exist in our metadata (i.e. the COM interface method or the P/Invoke definition),
      * however the function mapper won't be called for these methods (which makes sense, since they're special frames). As such, we need to record them ourselves. */
 
-    CLock transitionLock(&m_TransitionMutex, true);
+    //Transitions are extremely frequent in P/Invoke heavy applications. Once a thread knows a function has been recorded, it never needs to ask again
+    if (pContext->RecordedTransitions.find(functionId) != pContext->RecordedTransitions.end())
+        return;
+
+    BOOL recorded;
+
+    //Lock scope
+    {
+        CLock transitionLock(&m_TransitionMutex);
+
+        recorded = m_TransitionMap.find(functionId) != m_TransitionMap.end();
+    }
 
-    if (m_TransitionMap.find(functionId) == m_TransitionMap.end())
+    if (!recorded)
     {
-        BOOL isHooked = IsHookedFunction(functionId);
+        CLock transitionLock(&m_TransitionMutex, true);
 
-        if (!isHooked)
+        //Another thread may have recorded the function while we didn't hold the lock
+        if (m_TransitionMap.find(functionId) == m_TransitionMap.end())
         {
-            BOOL hook;
-            RecordFunction(functionId, nullptr, &hook);
-        }
+            BOOL isHooked = IsHookedFunction(functionId);
+
+            if (!isHooked)
+            {
+                BOOL hook;
+                RecordFunction(functionId, nullptr, &hook);
+            }
 
-        m_TransitionMap.insert(functionId);
+            m_TransitionMap.insert(functionId);
+        }
     }
+
+    pContext->RecordedTransitions.insert(functionId);
 }
 
 void NTAPI CCorProfilerCallback::ExitProcessCallback(
@@ -14,22 +14,18 @@
 #include "CExceptionManager.h"
 #include "CMatchItem.h"
 #include "CTypeIdentifier.h"
+#include "CFunctionRecord.h"
+#include "CThreadContext.h"
 
 #undef GetClassInfo
 
-//Thread local buffers (to avoid reallocating with each RecordFunction invocation that is made)
-#define NAME_BUFFER_SIZE 512
-
-extern thread_local WCHAR g_szMethodName[NAME_BUFFER_SIZE];
-extern thread_local WCHAR g_szTypeName[NAME_BUFFER_SIZE];
-extern thread_local WCHAR g_szModuleName[NAME_BUFFER_SIZE];
-extern thread_local WCHAR g_szAssemblyName[NAME_BUFFER_SIZE];
-extern thread_local WCHAR g_szFieldName[NAME_BUFFER_SIZE];
-
 #if _DEBUG && DEBUG_UNKNOWN
 extern std::unordered_set<CUnknown*>* g_UnknownMap;
 #endif
 
+//Whether the hooks have nothing to do for any function. The naked hooks test this before saving any registers
+EXTERN_C volatile BOOL g_HooksDisabled;
+
 class CCorProfilerCallback final : public ICorProfilerCallback3
 {
 public:
@@ -40,6 +36,11 @@ public:
     CCorProfilerCallback() :
         m_pInfo(nullptr),
         m_Detailed(FALSE),
+        m_ILInstrumentation(FALSE),
+        m_Attached(FALSE),
+        m_PreserveNativeImages(FALSE),
+        m_UnhookWhenNotTracing(FALSE),
+        m_MaxTrivialILSize(0),
         m_hHash(nullptr),
         m_RefCount(0)
     {
@@ -51,6 +52,8 @@ public:
     static UINT_PTR __stdcall RecordFunction(FunctionID funcId, void* clientData, BOOL* pbHookFunction);
     static BOOL ShouldHook();
     static BOOL IsWhitelistedModule(LPWSTR moduleName);
+    static ULONG GetTrivialILSize();
+    static BOOL IsTrivialFunction(ModuleID moduleId, mdMethodDef methodDef, IMetaDataImport2* pMDI);
     static void NTAPI ExitProcessCallback(_In_ PVOID   lpParameter, _In_ BOOLEAN TimerOrWaitFired);
 
     void GetMatchItems(
@@ -61,7 +64,12 @@ public:
         _In_ std::vector<CMatchItem>& items);
 
     HRESULT SetEventMask();
+    DWORD GetNativeImageFlags();
     HRESULT InstallHooks();
+    HRESULT InstrumentFunction(FunctionID functionId);
+    HRESULT Detach();
+    void SetTracingEnabled(bool enabled);
+    void StopBackgroundThreads();
     HRESULT InstallHooksWithInfo();
     HRESULT BindLifetimeToParentProcess();
 
@@ -101,7 +109,20 @@ public:
     }
 
     BOOL IsHookedFunction(FunctionID functionId);
-    void EnsureTransitionMethodRecorded(FunctionID functionId);
+    void EnsureTransitionMethodRecorded(CThreadContext* pContext, FunctionID functionId);
+    CFunctionRecord* GetOrCreateFunctionRecordNoLock(FunctionID functionId);
+
+    /// <summary>
+    /// Invokes a callback against every function record while preventing any records from being created.
+    /// </summary>
+    template<typename Callback>
+    void ForEachFunctionRecord(Callback callback)
+    {
+        CLock methodLock(&m_MethodMutex);
+
+        for (auto& kv : m_FunctionRecordMap)
+            callback(kv.second);
+    }
 
 #pragma region IUnknown
     STDMETHODIMP_(ULONG) AddRef() override;
@@ -133,9 +154,9 @@ public:
     STDMETHODIMP ClassUnloadFinished(ClassID classId, HRESULT hrStatus) override;
     STDMETHODIMP FunctionUnloadStarted(FunctionID functionId) override { return S_OK; }
     STDMETHODIMP Initialize(IUnknown* pICorProfilerInfoUnk) override;
-    STDMETHODIMP JITCompilationStarted(FunctionID functionId, BOOL fIsSafeToBlock) override { return S_OK; }
+    STDMETHODIMP JITCompilationStarted(FunctionID functionId, BOOL fIsSafeToBlock) override;
     STDMETHODIMP JITCompilationFinished(FunctionID functionId, HRESULT hrStatus, BOOL fIsSafeToBlock) override { return S_OK; }
-    STDMETHODIMP JITCachedFunctionSearchStarted(FunctionID functionId, BOOL* pbUseCachedFunction) override { return S_OK; }
+    STDMETHODIMP JITCachedFunctionSearchStarted(FunctionID functionId, BOOL* pbUseCachedFunction) override;
     STDMETHODIMP JITCachedFunctionSearchFinished(FunctionID functionId, COR_PRF_JIT_CACHE result) override { return S_OK; }
     STDMETHODIMP JITFunctionPitched(FunctionID functionId) override { return S_OK; }
     STDMETHODIMP JITInlining(FunctionID callerId, FunctionID calleeId, BOOL* pfShouldInline) override { return S_OK; }
@@ -196,14 +217,26 @@ public:
     STDMETHODIMP HandleDestroyed(GCHandleID handleId) override { return S_OK; }
 #pragma endregion
 #pragma region ICorProfilerCallback3
-    HRESULT STDMETHODCALLTYPE InitializeForAttach(IUnknown* pCorProfilerInfoUnk, void* pvClientData, UINT cbClientData) override { return S_OK; }
-    HRESULT STDMETHODCALLTYPE ProfilerAttachComplete(void) override { return S_OK; }
-    HRESULT STDMETHODCALLTYPE ProfilerDetachSucceeded(void) override { return S_OK; }
+    HRESULT STDMETHODCALLTYPE InitializeForAttach(IUnknown* pCorProfilerInfoUnk, void* pvClientData, UINT cbClientData) override;
+    HRESULT STDMETHODCALLTYPE ProfilerAttachComplete(void) override;
+    HRESULT STDMETHODCALLTYPE ProfilerDetachSucceeded(void) override;
 #pragma endregion
 
     ICorProfilerInfo4* m_pInfo;
     BOOL m_Detailed;
 
+    //Whether functions are hooked by rewriting their IL rather than via ELT hooks
+    BOOL m_ILInstrumentation;
+
+    //Whether the profiler was attached to a process that was already running, rather than being loaded on startup
+    BOOL m_Attached;
+
+    //Whether NGEN/ReadyToRun code remains in use for modules that aren't hooked, rather than JITting every function in the process
+    BOOL m_PreserveNativeImages;
+
+    //Whether the hooks return immediately while tracing is disabled, rather than continuing to maintain each thread's shadow stack
+    BOOL m_UnhookWhenNotTracing;
+
     std::unordered_map<AssemblyID, CAssemblyInfo*> m_AssemblyInfoMap;
     std::unordered_map<std::wstring_view, CAssemblyInfo*> m_AssemblyNameMap;
     std::shared_mutex m_AssemblyMutex;
@@ -220,11 +253,16 @@ public:
 
     std::unordered_map<FunctionID, CSigMethodDef*> m_MethodInfoMap;
     std::unordered_set<FunctionID> m_HookedMethodMap;
+    std::unordered_map<FunctionID, CFunctionRecord*> m_FunctionRecordMap;
     std::shared_mutex m_MethodMutex;
 
     std::unordered_set<FunctionID> m_TransitionMap;
     std::shared_mutex m_TransitionMutex;
 
+    //The methods whose IL has been rewritten in each module. A method's IL is shared by all of its generic instantiations, so it must only be rewritten once
+    std::unordered_map<ModuleID, std::unordered_set<mdMethodDef>> m_InstrumentedMethodMap;
+    std::shared_mutex m_InstrumentedMethodMutex;
+
     //For some reason using an unordered_set would cause a destructor to be called or something upon calling insert() or emplace()
     std::unordered_map<ObjectID, BYTE> m_ObjectIdBlacklist;
     std::shared_mutex m_ObjectIdBlacklistMutex;
@@ -238,6 +276,13 @@ public:
     std::vector<CMatchItem> m_ModuleBlacklist;
     std::vector<CMatchItem> m_ModuleWhitelist;
 
+    //Functions whose IL is no larger than this will not be hooked, unless their names match an item in m_TrivialWhitelist
+    ULONG m_MaxTrivialILSize;
+    std::vector<CMatchItem> m_TrivialWhitelist;
+
+    //Functions whose calls start a slow call capture, when DEBUGTOOLS_SLOW_CALL_THRESHOLD is specified
+    std::vector<CMatchItem> m_SlowCallTriggers;
+
 private:
     CCommunication m_Communication;
     BCRYPT_HASH_HANDLE m_hHash;
@@ -0,0 +1,104 @@
+#include "pch.h"
+#include "CCoverage.h"
+#include "CValueTracer.h"
+#include "Events.h"
+
+BOOL g_CoverageEnabled = FALSE;
+
+volatile LONG64* CCoverage::s_Pages[COVERAGE_MAX_PAGES];
+
+std::vector<CFunctionRecord*> CCoverage::s_Records;
+std::shared_mutex CCoverage::s_RecordsMutex;
+
+#define MAX_COVERED_FUNCTIONS (VALUE_BUFFER_SIZE / sizeof(UINT64))
+
+HRESULT CCoverage::Initialize()
+{
+    if (!GetBoolEnv("DEBUGTOOLS_COVERAGE"))
+        return S_OK;
+
+    //Allocate the last page up front so that the overflow index is always valid
+    volatile LONG64* pLastPage = new LONG64[COVERAGE_PAGE_WORDS]();
+    pLastPage[COVERAGE_PAGE_WORDS - 1] = 1LL << 63;
+
+    s_Pages[COVERAGE_MAX_PAGES - 1] = pLastPage;
+
+    g_CoverageEnabled = TRUE;
+
+    return S_OK;
+}
+
+/// <summary>
+/// Assigns the next available bit in the coverage bitmap to a function. Must be called before the record is given to the CLR.
+/// </summary>
+void CCoverage::AssignIndex(_In_ CFunctionRecord* pRecord)
+{
+    CLock recordsLock(&s_RecordsMutex, true);
+
+    ULONG index = (ULONG)s_Records.size();
+
+    if (index >= COVERAGE_OVERFLOW_INDEX)
+    {
+        pRecord->m_CoverageIndex = COVERAGE_OVERFLOW_INDEX;
+        return;
+    }
+
+    ULONG page = index >> COVERAGE_PAGE_SHIFT;
+
+    if (!s_Pages[page])
+        s_Pages[page] = new LONG64[COVERAGE_PAGE_WORDS]();
+
+    pRecord->m_CoverageIndex = index;
+    s_Records.push_back(pRecord);
+}
+
+/// <summary>
+/// Records that a function has been entered for what is probably the first time. If another thread got there first, nothing happens.
+/// </summary>
+void CCoverage::Cover(_In_ CFunctionRecord* pRecord)
+{
+    HRESULT hr = S_OK;
+    ULONG index = pRecord->m_CoverageIndex;
+
+    LONG64 mask = 1LL << (index & 63);
+    LONG64 previous = InterlockedOr64(&s_Pages[index >> COVERAGE_PAGE_SHIFT][(index >> 6) & (COVERAGE_PAGE_WORDS - 1)], mask);
+
+    if (previous & mask)
+        return;
+
+    //If tracing is disabled the function will still be reported by WriteCoveredFunctions
+    if (g_TracingEnabled)
+        ValidateETW(EventWriteMethodCoveredEvent(pRecord->m_FunctionId));
+}
+
+/// <summary>
+/// Writes one or more CoveredFunctionsEvents containing the FunctionIDs of all functions that have been covered so far.
+/// The last event is marked as final.
+/// </summary>
+void CCoverage::WriteCoveredFunctions()
+{
+    HRESULT hr = S_OK;
+    CThreadContext* pContext = GetThreadContext();
+
+    //This is only ever called from the pipe thread or on shutdown, neither of which otherwise use their value buffer at the same time
+    UINT64* pFunctionIds = (UINT64*)pContext->ValueBuffer;
+    ULONG count = 0;
+
+    CLock recordsLock(&s_RecordsMutex);
+
+    for (ULONG i = 0; i < (ULONG)s_Records.size(); i++)
+    {
+        if (!IsCovered(i))
+            continue;
+
+        pFunctionIds[count++] = s_Records[i]->m_FunctionId;
+
+        if (count == MAX_COVERED_FUNCTIONS)
+        {
+            ValidateETW(EventWriteCoveredFunctionsEvent(FALSE, (ULONG)(count * sizeof(UINT64)), pContext->ValueBuffer));
+            count = 0;
+        }
+    }
+
+    ValidateETW(EventWriteCoveredFunctionsEvent(TRUE, (ULONG)(count * sizeof(UINT64)), pContext->ValueBuffer));
+}
\ No newline at end of file
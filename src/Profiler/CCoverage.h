@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CFunctionRecord.h"
+#include <vector>
+
+extern BOOL g_CoverageEnabled;
+
+//Each page of the coverage bitmap tracks 65536 functions. Pages are allocated as functions are recorded and are never moved,
+//so the hooks can test a function's bit without taking a lock
+#define COVERAGE_PAGE_SHIFT 16
+#define COVERAGE_PAGE_WORDS ((1 << COVERAGE_PAGE_SHIFT) / 64)
+#define COVERAGE_MAX_PAGES 256
+
+//Functions recorded once the bitmap is full all share the last index, whose bit is always set so they're treated as already covered
+#define COVERAGE_OVERFLOW_INDEX ((COVERAGE_MAX_PAGES << COVERAGE_PAGE_SHIFT) - 1)
+
+/// <summary>
+/// Records which functions have been called at least once, while making each subsequent call as close to free as possible.<para/>
+/// Each hooked function is assigned a dense index into a bitmap when its <see cref="CFunctionRecord"/> is created. The first time a function is entered,
+/// its bit is set and a single MethodCoveredEvent is written. Every call after that only tests the bit.
+/// </summary>
+class CCoverage
+{
+public:
+    static HRESULT Initialize();
+
+    static void AssignIndex(_In_ CFunctionRecord* pRecord);
+
+    FORCEINLINE static BOOL IsCovered(_In_ ULONG index)
+    {
+        return (s_Pages[index >> COVERAGE_PAGE_SHIFT][(index >> 6) & (COVERAGE_PAGE_WORDS - 1)] & (1LL << (index & 63))) != 0;
+    }
+
+    static void Cover(_In_ CFunctionRecord* pRecord);
+
+    static void WriteCoveredFunctions();
+
+private:
+    static volatile LONG64* s_Pages[COVERAGE_MAX_PAGES];
+
+    //The record of each function that has been assigned an index, so that the bitmap can be translated back into FunctionIDs
+    static std::vector<CFunctionRecord*> s_Records;
+    static std::shared_mutex s_RecordsMutex;
+};
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "pch.h"
+#include "CCpuTime.h"
+#include "CHookCalibrator.h"
+#include "CValueTracer.h"
+#include "Events.h"
+
+BOOL g_CpuTimeEnabled = FALSE;
+
+HRESULT CCpuTime::Initialize()
+{
+    g_CpuTimeEnabled = GetBoolEnv("DEBUGTOOLS_CPU_TIME");
+
+    return S_OK;
+}
+
+/// <summary>
+/// Records the CPU time consumed by a frame that has just been popped from the shadow stack. Must be called before the CallLeaveEvent
+/// is written for the frame, so that the client can attach the CPU time to the frame before it's closed.
+/// </summary>
+void CCpuTime::Leave(_In_ CThreadContext* pContext, _In_ const Frame& frame)
+{
+    HRESULT hr = S_OK;
+
+    //Suppressed frames never record when they were entered. Their CPU time is attributed to their parent instead
+    if (frame.EnterCycles == 0)
+        return;
+
+    ULONG64 cycles;
+    QueryThreadCycleTime(GetCurrentThread(), &cycles);
+
+    ULONG64 inclusiveCycles = cycles - frame.EnterCycles;
+
+    //Each call beneath the frame ran its Enter and Leave hooks on this thread. As the inclusive cycles of each child already had
+    //the overhead of their own descendants removed, subtracting the child cycles below also removes it from the exclusive cycles
+    ULONG64 overhead = frame.DescendantCalls * CHookCalibrator::s_CompensatedCycles;
+    inclusiveCycles = inclusiveCycles > overhead ? inclusiveCycles - overhead : 0;
+
+    ULONG64 exclusiveCycles = inclusiveCycles > frame.ChildCycles ? inclusiveCycles - frame.ChildCycles : 0;
+
+    if (!pContext->CallStack.empty())
+    {
+        Frame& parent = pContext->CallStack.top();
+
+        parent.ChildCycles += inclusiveCycles;
+        parent.DescendantCalls += frame.DescendantCalls + 1;
+    }
+
+    if (g_TracingEnabled)
+        ValidateETW(EventWriteCallCpuTimeEvent(frame.FunctionId, inclusiveCycles, exclusiveCycles));
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "CThreadContext.h"
+
+extern BOOL g_CpuTimeEnabled;
+
+/// <summary>
+/// Measures the CPU time consumed by each frame, so that a frame that is expensive because it burns CPU can be told apart from one that is
+/// expensive because it blocks.<para/>
+/// Each frame records its thread's cycle count when it's entered. When the frame is left, the cycles elapsed since then are its inclusive CPU time,
+/// which are added to its parent so that the parent's exclusive CPU time can be calculated in turn.
+/// </summary>
+class CCpuTime
+{
+public:
+    static HRESULT Initialize();
+
+    FORCEINLINE static void Enter(_In_ Frame& frame)
+    {
+        QueryThreadCycleTime(GetCurrentThread(), &frame.EnterCycles);
+    }
+
+    static void Leave(_In_ CThreadContext* pContext, _In_ const Frame& frame);
+};
\ No newline at end of file
@@ -4,16 +4,14 @@
 #include "CValueTracer.h"
 #include "Events.h"
 #include "CExceptionInfo.h"
-
-thread_local std::deque<CExceptionInfo*> g_ExceptionQueue;
-
-thread_local long g_ExceptionSequence;
-
-thread_local ULONG g_FilterCallDepth = 0;
+#include "CFlightRecorder.h"
+#include "CSlowCallCapture.h"
 
 HRESULT CExceptionManager::UnmanagedToManagedTransition(FunctionID functionId, COR_PRF_TRANSITION_REASON reason)
 {
-    if (g_ExceptionQueue.empty())
+    CThreadContext* pContext = GetThreadContext();
+
+    if (pContext->ExceptionQueue.empty())
         return S_OK;
 
     CExceptionInfo* pExceptionInfo = GetCurrentException();
@@ -67,6 +65,7 @@ HRESULT CExceptionManager::ManagedToUnmanagedTransition(FunctionID functionId, C
 HRESULT CExceptionManager::ExceptionThrown(ObjectID thrownObjectId)
 {
     HRESULT hr = S_OK;
+    CThreadContext* pContext = GetThreadContext();
     ClassID classId;
     CClassInfo* pClassInfo;
     CExceptionInfo* pExceptionInfo;
@@ -77,18 +76,22 @@ HRESULT CExceptionManager::ExceptionThrown(ObjectID thrownObjectId)
 
     IfFailGo(g_pProfiler->GetClassInfoFromClassId(classId, (IClassInfo**)&pClassInfo));
 
-    g_ExceptionSequence++;
+    pContext->ExceptionSequence++;
 
-    pExceptionInfo = new CExceptionInfo(pClassInfo, g_ExceptionSequence);
+    pExceptionInfo = new CExceptionInfo(pClassInfo, pContext->ExceptionSequence);
 
-    if (g_FilterCallDepth > 0)
+    if (pContext->FilterCallDepth > 0)
         pExceptionInfo->m_IsInFilter = TRUE;
 
     LogException(L"ExceptionThrown %s\n", pClassInfo->m_szName);
 
-    g_ExceptionQueue.push_back(pExceptionInfo);
+    pContext->ExceptionQueue.push_back(pExceptionInfo);
+    pContext->ExceptionsPending = TRUE;
 
-    ValidateETW(EventWriteExceptionEvent(g_ExceptionSequence, pClassInfo->m_szName));
+    ValidateETW(EventWriteExceptionEvent(pContext->ExceptionSequence, pClassInfo->m_szName));
+
+    if (g_FlightRecorderEnabled)
+        CFlightRecorder::ExceptionThrown(pClassInfo->m_szName);
 
 ErrExit:
     return hr;
@@ -96,6 +99,8 @@ ErrExit:
 
 HRESULT CExceptionManager::SearchFilterEnter(FunctionID functionId)
 {
+    CThreadContext* pContext = GetThreadContext();
+
     CExceptionInfo* pExceptionInfo = GetCurrentException();
 
     //Set the function that will call the filter. This is NOT the FunctionID of the filter itself
@@ -103,17 +108,19 @@ HRESULT CExceptionManager::SearchFilterEnter(FunctionID functionId)
 
     LogException(L"FilterEnter %s " FORMAT_PTR "\n", pExceptionInfo->m_pClassInfo->m_szName, functionId);
 
-    g_FilterCallDepth++;
+    pContext->FilterCallDepth++;
 
     return S_OK;
 }
 
 HRESULT CExceptionManager::SearchFilterLeave()
 {
+    CThreadContext* pContext = GetThreadContext();
+
     CExceptionInfo* pExceptionInfo = GetCurrentException();
 
     LogException(L"FilterLeave %s\n", pExceptionInfo->m_pClassInfo->m_szName);
-    g_FilterCallDepth--;
+    pContext->FilterCallDepth--;
 
     return S_OK;
 }
@@ -121,13 +128,14 @@ HRESULT CExceptionManager::SearchFilterLeave()
 HRESULT CExceptionManager::UnwindFunctionEnter(FunctionID functionId)
 {
     HRESULT hr = S_OK;
+    CThreadContext* pContext = GetThreadContext();
 
     CExceptionInfo* pExceptionInfo = GetCurrentException();
 
     BOOL isHooked = g_pProfiler->IsHookedFunction(functionId);
 
     /* We've now entered a managed frame again. If the exception occurred inside a callback called
-     * from unmanaged code, we'll still have transition frames in our g_CallStack.
+     * from unmanaged code, we'll still have transition frames in our CallStack.
      * However, we saw in Visual Studio that we may be calling a COM method and trying to load an assembly. If a FileNotFoundException is thrown, UnwindFunctionEnter
      * will be called for AppDomain.CreateInstance and associated U2M methods. This will cause UnwindUnmanagedTransitions to be called right away. However, after the exception has been caught,
      * an orderly transition will occur anyway. If we wipe out the transitions several frames too early, the orderly transition won't detect we've unwound anything (because the sequence won't have changed for it)
@@ -138,7 +146,7 @@ HRESULT CExceptionManager::UnwindFunctionEnter(FunctionID functionId)
     if (isHooked)
         UnwindUnmanagedTransitions();
 
-    if (pExceptionInfo->m_IsInFilter && g_ExceptionQueue.size() > 1)
+    if (pExceptionInfo->m_IsInFilter && pContext->ExceptionQueue.size() > 1)
     {
         /* When an UnwindFunctionLeave event occurs, this indicates an unwind of an "exception handler scope".
          * If an unhandled exception occurs in an exception filter, the exception will be swallowed and the filter
@@ -152,7 +160,7 @@ HRESULT CExceptionManager::UnwindFunctionEnter(FunctionID functionId)
          * An issue that may be related is described at https://github.com/dotnet/runtime/issues/10871 */
 
         //A queue's indexer is relative to the start like a normal list
-        CExceptionInfo* pPreviousException = g_ExceptionQueue[g_ExceptionQueue.size() - 2];
+        CExceptionInfo* pPreviousException = pContext->ExceptionQueue[pContext->ExceptionQueue.size() - 2];
 
         if (pPreviousException->m_FilterInvokerFunctionId == functionId)
         {
@@ -174,6 +182,7 @@ HRESULT CExceptionManager::UnwindFunctionEnter(FunctionID functionId)
 HRESULT CExceptionManager::UnwindFunctionLeave()
 {
     HRESULT hr = S_OK;
+    CThreadContext* pContext = GetThreadContext();
 
     CExceptionInfo* pExceptionInfo = GetCurrentException();
 
@@ -187,16 +196,25 @@ HRESULT CExceptionManager::UnwindFunctionLeave()
     }
     else
     {
-        if (g_pProfiler->IsHookedFunction(functionId.functionID))
+        //While the hooks are disabled, hooked frames aren't pushed onto the shadow stack, so there's nothing to unwind
+        if (!g_HooksDisabled && g_pProfiler->IsHookedFunction(functionId.functionID))
         {
             LogException(L"UnwindFunctionLeave %s: Unwinding shadow stack frame " FORMAT_PTR "\n", pExceptionInfo->m_pClassInfo->m_szName, functionId.functionID);
 
-            //This increments g_Sequence so our profiler controller will explode if we don't also provide an ETW notification
-            LEAVE_FUNCTION(functionId.functionID);
-            LogCall(L"Unwind", functionId.functionID);
-            ValidateETW(EventWriteExceptionFrameUnwindEvent(functionId.functionID, g_Sequence, (int) FrameKind::Managed));
+            //Suppressed frames never consumed a sequence, so the profiler controller doesn't need to know they were unwound
+            if (!g_SuppressionEnabled || !CCallSuppressor::LeaveSuppressed(pContext, functionId.functionID))
+            {
+                //This increments the sequence so our profiler controller will explode if we don't also provide an ETW notification
+                LEAVE_FUNCTION(pContext, functionId.functionID);
+                LogCall(L"Unwind", functionId.functionID);
+                ValidateETW(EventWriteExceptionFrameUnwindEvent(functionId.functionID, pContext->Sequence, (int) FrameKind::Managed));
+            }
 
             UnwindU2M(functionId.functionID);
+
+            //If a capture was started for the unwound frame, the capture is now complete
+            if (g_SlowCallCaptureEnabled)
+                CSlowCallCapture::Leave(pContext);
         }
         else
         {
@@ -213,6 +231,7 @@ ErrExit:
 HRESULT CExceptionManager::UnwindFinallyEnter(FunctionID functionId)
 {
     HRESULT hr = S_OK;
+    CThreadContext* pContext = GetThreadContext();
 
     CExceptionInfo* pExceptionInfo = GetCurrentException();
 
@@ -224,7 +243,7 @@ HRESULT CExceptionManager::UnwindFinallyEnter(FunctionID functionId)
     LogException(L"ExceptionUnwindFinallyEnter: %s None -> EnterFinally\n", pExceptionInfo->m_pClassInfo->m_szName);
 
     pExceptionInfo->m_ExceptionState = ExceptionState::EnterFinally;
-    pExceptionInfo->m_ClauseCallDepth = g_CallStack.size();
+    pExceptionInfo->m_ClauseCallDepth = pContext->CallStack.size();
     pExceptionInfo->m_ClauseFramePointer = clauseInfo.framePointer;
     pExceptionInfo->m_ClauseProgramCounter = clauseInfo.programCounter;
 
@@ -248,6 +267,7 @@ HRESULT CExceptionManager::UnwindFinallyLeave()
 HRESULT CExceptionManager::CatcherEnter(FunctionID functionId, ObjectID objectId)
 {
     HRESULT hr = S_OK;
+    CThreadContext* pContext = GetThreadContext();
 
     CExceptionInfo* pExceptionInfo = GetCurrentException();
 
@@ -264,7 +284,7 @@ HRESULT CExceptionManager::CatcherEnter(FunctionID functionId, ObjectID objectId
     );
 
     pExceptionInfo->m_ExceptionState = ExceptionState::EnterCatch;
-    pExceptionInfo->m_ClauseCallDepth = g_CallStack.size();
+    pExceptionInfo->m_ClauseCallDepth = pContext->CallStack.size();
     pExceptionInfo->m_ClauseFramePointer = clauseInfo.framePointer;
     pExceptionInfo->m_ClauseProgramCounter = clauseInfo.programCounter;
 
@@ -350,15 +370,17 @@ void CExceptionManager::LeaveUnmanaged(CExceptionInfo* pExceptionInfo)
 
 void CExceptionManager::ClearStaleExceptions()
 {
-    while (!g_ExceptionQueue.empty())
+    CThreadContext* pContext = GetThreadContext();
+
+    while (!pContext->ExceptionQueue.empty())
     {
-        CExceptionInfo* pFirstException = g_ExceptionQueue.back();
+        CExceptionInfo* pFirstException = pContext->ExceptionQueue.back();
 
         if (pFirstException->m_ExceptionState == ExceptionState::EnterCatch || pFirstException->m_ExceptionState == ExceptionState::EnterFinally)
         {
             //If we've returned at least 1 frame from this previous exception, its EnterCatch or EnterFinally will never complete. The exception must have been
             //interrupted by an exception that was thrown in its catch/finally clause.
-            if (pFirstException->m_ClauseCallDepth > g_CallStack.size())
+            if (pFirstException->m_ClauseCallDepth > pContext->CallStack.size())
             {
                 ClearStaleException(pFirstException);
                 pFirstException = nullptr;
@@ -374,21 +396,25 @@ void CExceptionManager::ClearStaleExceptions()
 void CExceptionManager::ClearLastException(CExceptionInfo* pExceptionInfo, ExceptionCompletedReason reason)
 {
     HRESULT hr = S_OK;
+    CThreadContext* pContext = GetThreadContext();
 
     EventWriteExceptionCompletedEvent(pExceptionInfo->m_Sequence, (int) reason);
 
     if (reason != ExceptionCompletedReason::UnhandledInFilter)
         LogException(L"Exception %s has been handled. Clearing exception\n", pExceptionInfo->m_pClassInfo->m_szName);
 
-    _ASSERTE(g_ExceptionQueue.back() == pExceptionInfo);
-    g_ExceptionQueue.pop_back();
+    _ASSERTE(pContext->ExceptionQueue.back() == pExceptionInfo);
+    pContext->ExceptionQueue.pop_back();
+    pContext->ExceptionsPending = !pContext->ExceptionQueue.empty();
     delete pExceptionInfo;
 
-    LogException(L"Exceptions remaining: %d\n", g_ExceptionQueue.size());
+    LogException(L"Exceptions remaining: %d\n", pContext->ExceptionQueue.size());
 }
 
 void CExceptionManager::ClearStaleException(CExceptionInfo* pExceptionInfo)
 {
+    CThreadContext* pContext = GetThreadContext();
+
     if (pExceptionInfo->m_ExceptionState == ExceptionState::EnterCatch)
         LogException(L"UnwindFunctionLeave: Exception %s in queue is status EnterCatch and will never complete. Clearing exception\n", pExceptionInfo->m_pClassInfo->m_szName);
     else
@@ -396,21 +422,24 @@ void CExceptionManager::ClearStaleException(CExceptionInfo* pExceptionInfo)
 
     EventWriteExceptionCompletedEvent(pExceptionInfo->m_Sequence, (int) ExceptionCompletedReason::Superseded);
 
-    _ASSERTE(g_ExceptionQueue.back() == pExceptionInfo);
-    g_ExceptionQueue.pop_back();
+    _ASSERTE(pContext->ExceptionQueue.back() == pExceptionInfo);
+    pContext->ExceptionQueue.pop_back();
+    pContext->ExceptionsPending = !pContext->ExceptionQueue.empty();
     delete pExceptionInfo;
 
-    LogException(L"Exceptions remaining: %d\n", g_ExceptionQueue.size());
+    LogException(L"Exceptions remaining: %d\n", pContext->ExceptionQueue.size());
 }
 
 void CExceptionManager::UnwindU2M(FunctionID functionId)
 {
-    if (g_CallStack.empty())
+    CThreadContext* pContext = GetThreadContext();
+
+    if (pContext->CallStack.empty())
         return;
 
     HRESULT hr = S_OK;
 
-    Frame* top = &g_CallStack.top();
+    Frame* top = &pContext->CallStack.top();
 
     /* We're currently unwinding from a managed frame, which means the frame we just popped off is probably a Managed frame.
      * I don't know if it could be an M2U stub. If we can gracefully unwind M2U stubs, then if there's two M2U stubs I think
@@ -432,18 +461,18 @@ void CExceptionManager::UnwindU2M(FunctionID functionId)
          * - If the exception is caught inside unmanaged code, there will be an orderly U2M event (which we'll be able to unwind from). If there was an M2U event before it, it will be called too
          * - If the exception is not caught inside unmanaged code, we'll hit a CatcherEnter event, at which point we'll unwind any non-managed frames
          */
-        LEAVE_FUNCTION(top->FunctionId);
+        LEAVE_FUNCTION(pContext, top->FunctionId);
         LogCall(L"Unwind U2M Stub", top->FunctionId);
-        ValidateETW(EventWriteExceptionFrameUnwindEvent(top->FunctionId, g_Sequence, (int)top->Kind));
+        ValidateETW(EventWriteExceptionFrameUnwindEvent(top->FunctionId, pContext->Sequence, (int)top->Kind));
 
-        if (g_CallStack.empty())
+        if (pContext->CallStack.empty())
             break;
 
-        top = &g_CallStack.top();
+        top = &pContext->CallStack.top();
     }
 
     if (top->Kind == FrameKind::M2U)
-        g_CheckM2UUnwind = TRUE;
+        pContext->CheckM2UUnwind = TRUE;
 ErrExit:
     return;
 }
@@ -451,28 +480,29 @@ ErrExit:
 void CExceptionManager::UnwindUnmanagedTransitions()
 {
     HRESULT hr = S_OK;
+    CThreadContext* pContext = GetThreadContext();
 
-    if (!g_CallStack.empty())
+    if (!pContext->CallStack.empty())
     {
-        Frame* top = &g_CallStack.top();
+        Frame* top = &pContext->CallStack.top();
 
         while (top->Kind != FrameKind::Managed)
         {
             //The exception was caught in unmanaged code, and we've just stepped back into managed code. As such we need to clear any
             //transition frames we recorded
-            LEAVE_FUNCTION(top->FunctionId);
+            LEAVE_FUNCTION(pContext, top->FunctionId);
 
             if (top->Kind == FrameKind::M2U)
                 LogException(L"Unwind M2U", top->FunctionId);
             else
                 LogException(L"Unwind U2M", top->FunctionId);
 
-            ValidateETW(EventWriteExceptionFrameUnwindEvent(top->FunctionId, g_Sequence, (int)top->Kind));
+            ValidateETW(EventWriteExceptionFrameUnwindEvent(top->FunctionId, pContext->Sequence, (int)top->Kind));
 
-            if (g_CallStack.empty())
+            if (pContext->CallStack.empty())
                 break;
 
-            top = &g_CallStack.top();
+            top = &pContext->CallStack.top();
         }
     }
 
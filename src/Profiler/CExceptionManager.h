@@ -1,11 +1,9 @@
 #pragma once
 
-#include <deque>
+#include "CThreadContext.h"
 
 class CExceptionInfo;
 
-extern thread_local std::deque<CExceptionInfo*> g_ExceptionQueue;
-
 enum class ExceptionCompletedReason
 {
     Caught = 1,
@@ -48,6 +46,6 @@ private:
 
     CExceptionInfo* GetCurrentException()
     {
-        return g_ExceptionQueue.back();
+        return GetThreadContext()->ExceptionQueue.back();
     }
 };
\ No newline at end of file
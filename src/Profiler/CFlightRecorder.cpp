@@ -0,0 +1,600 @@
+#include "pch.h"
+#include "CFlightRecorder.h"
+#include "CCallStackSnapshot.h"
+#include "CHookCalibrator.h"
+#include <Shlwapi.h>
+#include <algorithm>
+
+BOOL g_FlightRecorderEnabled = FALSE;
+
+ULONG CFlightRecorder::s_BufferSize = 0;
+LPWSTR CFlightRecorder::s_szDumpPath = nullptr;
+LPWSTR CFlightRecorder::s_szExceptionType = nullptr;
+LONGLONG CFlightRecorder::s_SlowFrameThreshold = 0;
+ULONGLONG CFlightRecorder::s_SlowFrameThresholdDuration = 0;
+
+volatile BOOL CFlightRecorder::s_Flushing = FALSE;
+
+std::vector<CFlightRecorderBuffer*> CFlightRecorder::s_Buffers;
+ULONGLONG CFlightRecorder::s_TotalBufferSize = 0;
+std::shared_mutex CFlightRecorder::s_BuffersMutex;
+
+std::vector<MMFRecord> CFlightRecorder::s_Metadata;
+std::unordered_multimap<UINT64, size_t> CFlightRecorder::s_MetadataIndex;
+ULONGLONG CFlightRecorder::s_MetadataSize = 0;
+std::shared_mutex CFlightRecorder::s_MetadataMutex;
+
+volatile LONG CFlightRecorder::s_PendingDump = 0;
+LONG CFlightRecorder::s_DumpCount = 0;
+CIntervalThread CFlightRecorder::s_Thread;
+
+/// <summary>
+/// Owns the flight recorder buffer of the current thread, unregistering it when the thread exits.
+/// </summary>
+struct FlightRecorderBufferHolder
+{
+    CFlightRecorderBuffer* m_pBuffer = nullptr;
+
+    //Whether the thread couldn't be given a buffer, in which case it doesn't record any events
+    BOOL m_Denied = FALSE;
+
+    ~FlightRecorderBufferHolder()
+    {
+        if (m_pBuffer)
+            CFlightRecorder::ReleaseBuffer(m_pBuffer);
+    }
+};
+
+thread_local FlightRecorderBufferHolder g_FlightRecorderBuffer;
+
+#pragma region CFlightRecorderBuffer
+
+BOOL CFlightRecorderBuffer::Write(
+    _In_ PCEVENT_DESCRIPTOR EventDescriptor,
+    _In_ ULONG UserDataCount,
+    _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData,
+    _Out_ BOOL* pIsSlowFrame)
+{
+    *pIsSlowFrame = FALSE;
+
+    LARGE_INTEGER qpc;
+    QueryPerformanceCounter(&qpc);
+
+    DWORD userDataSize = 0;
+
+    for (ULONG i = 1; i < UserDataCount; i++)
+        userDataSize += UserData[i].Size;
+
+    MMFEventHeader header = { qpc.QuadPart, m_ThreadId, userDataSize, EventDescriptor->Id };
+
+    DWORD recordSize = sizeof(MMFEventHeader) + userDataSize;
+    ULONG required = sizeof(DWORD) + recordSize;
+
+    if (required > m_Size)
+        return FALSE;
+
+    //Dumps are rare, so rather than taking a lock for every event, the thread announces that it's writing and only takes the lock
+    //when a dump is flushing the buffers
+    m_Writing = TRUE;
+
+    if (CFlightRecorder::s_Flushing)
+    {
+        m_Writing = FALSE;
+
+        CLock lock(&m_Mutex, true);
+        WriteRecord(header, UserDataCount, UserData);
+    }
+    else
+    {
+        WriteRecord(header, UserDataCount, UserData);
+        m_Writing = FALSE;
+    }
+
+    //m_EnterTimes is only ever accessed by the thread that owns this buffer, so doesn't need to be protected by the lock
+    if (CFlightRecorder::s_SlowFrameThreshold == 0)
+        return TRUE;
+
+    BOOL isLeave = FALSE;
+
+    switch (EventDescriptor->Id)
+    {
+    case CallEnterEvent_value:
+    case CallEnterDetailedEvent_value:
+        m_EnterTimes.push_back(qpc.QuadPart);
+        break;
+
+    case CallLeaveEvent_value:
+    case TailcallEvent_value:
+    case CallLeaveDetailedEvent_value:
+    case TailcallDetailedEvent_value:
+    case ExceptionFrameUnwindEvent_value:
+        isLeave = TRUE;
+        break;
+
+    case CallCompleteEvent_value:
+        //Coalesced calls carry their own duration (in 100ns units), so there's no enter time to pair them with
+        *pIsSlowFrame = *(ULONGLONG*)UserData[4].Ptr >= CFlightRecorder::s_SlowFrameThresholdDuration;
+        return TRUE;
+
+    case CallRepeatedEvent_value:
+        *pIsSlowFrame = *(ULONGLONG*)UserData[6].Ptr >= CFlightRecorder::s_SlowFrameThresholdDuration;
+        return TRUE;
+
+    case ManagedToUnmanagedEvent_value:
+    case UnmanagedToManagedEvent_value:
+        //A transition that calls into the other side of the boundary is paired with a transition that returns from it
+        if (*(COR_PRF_TRANSITION_REASON*)UserData[3].Ptr == COR_PRF_TRANSITION_CALL)
+            m_EnterTimes.push_back(qpc.QuadPart);
+        else
+            isLeave = TRUE;
+        break;
+    }
+
+    //We may have started tracking this thread part way through a call
+    if (isLeave && !m_EnterTimes.empty())
+    {
+        LONGLONG elapsed = qpc.QuadPart - m_EnterTimes.back();
+        m_EnterTimes.pop_back();
+
+        *pIsSlowFrame = elapsed >= CFlightRecorder::s_SlowFrameThreshold;
+    }
+
+    return TRUE;
+}
+
+void CFlightRecorderBuffer::WriteRecord(
+    _In_ const MMFEventHeader& header,
+    _In_ ULONG UserDataCount,
+    _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData)
+{
+    DWORD recordSize = sizeof(MMFEventHeader) + header.UserDataSize;
+
+    while (m_Size - m_Used < sizeof(DWORD) + recordSize)
+        Evict();
+
+    CopyIn(&recordSize, sizeof(DWORD));
+    CopyIn(&header, sizeof(MMFEventHeader));
+
+    for (ULONG i = 1; i < UserDataCount; i++)
+        CopyIn((void*)UserData[i].Ptr, UserData[i].Size);
+}
+
+void CFlightRecorderBuffer::Flush(_In_opt_ HANDLE hFile, _Inout_ DWORD* pNumRecords)
+{
+    CLock lock(&m_Mutex, true);
+
+    //The owning thread may have started writing before it could see that the buffers are being flushed
+    while (m_Writing)
+        YieldProcessor();
+
+    std::vector<BYTE> record;
+
+    while (m_Used > 0)
+    {
+        DWORD recordSize;
+        CopyOut(m_Head, &recordSize, sizeof(DWORD));
+
+        record.resize(recordSize);
+        CopyOut((m_Head + sizeof(DWORD)) % m_Size, record.data(), recordSize);
+
+        CFlightRecorder::WriteRecord(hFile, record.data(), recordSize, pNumRecords);
+
+        Evict();
+    }
+
+    m_Head = 0;
+    m_Tail = 0;
+}
+
+void CFlightRecorderBuffer::Clear()
+{
+    //Only called by the owning thread, so there can't be a write in progress
+    CLock lock(&m_Mutex, true);
+
+    m_Head = 0;
+    m_Tail = 0;
+    m_Used = 0;
+
+    m_EnterTimes.clear();
+}
+
+void CFlightRecorderBuffer::Evict()
+{
+    DWORD recordSize;
+    CopyOut(m_Head, &recordSize, sizeof(DWORD));
+
+    ULONG total = sizeof(DWORD) + recordSize;
+
+    m_Head = (m_Head + total) % m_Size;
+    m_Used -= total;
+}
+
+void CFlightRecorderBuffer::CopyIn(_In_ const void* pData, _In_ ULONG size)
+{
+    //Records are not contiguous; when we reach the end of the buffer we simply continue writing from the start
+    ULONG first = min(size, m_Size - m_Tail);
+
+    memcpy(m_pBuffer + m_Tail, pData, first);
+
+    if (first < size)
+        memcpy(m_pBuffer, (BYTE*)pData + first, size - first);
+
+    m_Tail = (m_Tail + size) % m_Size;
+    m_Used += size;
+}
+
+void CFlightRecorderBuffer::CopyOut(_In_ ULONG offset, _Out_ void* pData, _In_ ULONG size)
+{
+    ULONG first = min(size, m_Size - offset);
+
+    memcpy(pData, m_pBuffer + offset, first);
+
+    if (first < size)
+        memcpy((BYTE*)pData + first, m_pBuffer, size - first);
+}
+
+#pragma endregion
+#pragma region CFlightRecorder
+
+static LPWSTR GetStringEnv(LPCWSTR name)
+{
+    WCHAR szBuffer[MAX_PATH];
+    DWORD length = GetSetting(name, szBuffer, MAX_PATH);
+
+    if (length == 0 || length >= MAX_PATH)
+        return nullptr;
+
+    return _wcsdup(szBuffer);
+}
+
+HRESULT CFlightRecorder::Initialize()
+{
+    HRESULT hr = S_OK;
+    long bufferSizeMB;
+    long threshold;
+
+    if (!GetIntSetting("DEBUGTOOLS_FLIGHTRECORDER", &bufferSizeMB))
+        goto ErrExit;
+
+    if (bufferSizeMB <= 0 || bufferSizeMB > FLIGHT_RECORDER_MAX_BUFFER_SIZE_MB)
+    {
+        hr = E_INVALIDARG;
+        goto ErrExit;
+    }
+
+    s_BufferSize = bufferSizeMB * 1024 * 1024;
+
+    s_szDumpPath = GetStringEnv(L"DEBUGTOOLS_FLIGHTRECORDER_PATH");
+
+    //When we're using ETW there's no way to get an arbitrarily large dump to the client, so we must write it to disk
+    if (s_szDumpPath == nullptr && g_IsETW)
+    {
+        WCHAR szTempPath[MAX_PATH + 1];
+
+        if (GetTempPath(MAX_PATH + 1, szTempPath) == 0)
+        {
+            hr = HRESULT_FROM_WIN32(GetLastError());
+            goto ErrExit;
+        }
+
+        s_szDumpPath = _wcsdup(szTempPath);
+    }
+
+    s_szExceptionType = GetStringEnv(L"DEBUGTOOLS_FLIGHTRECORDER_EXCEPTION");
+
+    if (GetIntSetting("DEBUGTOOLS_FLIGHTRECORDER_SLOWFRAME", &threshold))
+    {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+
+        s_SlowFrameThreshold = threshold * frequency.QuadPart / 1000;
+        s_SlowFrameThresholdDuration = threshold * 10000;
+    }
+
+    g_FlightRecorderEnabled = TRUE;
+
+    IfFailGo(s_Thread.Start(DumpThreadProc, INFINITE));
+
+ErrExit:
+    return hr;
+}
+
+void CFlightRecorder::Shutdown()
+{
+    s_Thread.Stop();
+}
+
+ULONG CFlightRecorder::Write(
+    _In_ REGHANDLE RegHandle,
+    _In_ PCEVENT_DESCRIPTOR EventDescriptor,
+    _In_opt_ LPCGUID ActivityId,
+    _In_opt_ LPCGUID RelatedActivityId,
+    _In_range_(0, MAX_EVENT_DATA_DESCRIPTORS) ULONG UserDataCount,
+    _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData)
+{
+    if (EventDescriptor->Keyword & (CallKeyword | ExceptionKeyword))
+    {
+        CFlightRecorderBuffer* pBuffer = GetCurrentBuffer();
+
+        if (pBuffer == nullptr)
+            return ERROR_SUCCESS;
+
+        BOOL isSlowFrame;
+        pBuffer->Write(EventDescriptor, UserDataCount, UserData, &isSlowFrame);
+
+        //A calibration round that was interrupted by the thread being switched out isn't a slow frame the user cares about
+        if (isSlowFrame && !CHookCalibrator::s_Calibrating)
+            Dump(FlightRecorderDumpReason::SlowFrame);
+
+        return ERROR_SUCCESS;
+    }
+
+    //Everything else is sent to the client as normal. When dumping to a file, we also need to hold onto
+    //a copy so that the file can be interpreted on its own
+    if (s_szDumpPath)
+        AddMetadata(EventDescriptor, UserDataCount, UserData);
+
+    if (g_IsETW)
+        return EventWriteTransfer(RegHandle, EventDescriptor, ActivityId, RelatedActivityId, UserDataCount, UserData);
+    else
+        return EventWriteMMF(EventDescriptor, UserDataCount, UserData);
+}
+
+void CFlightRecorder::ExceptionThrown(_In_ LPCWSTR szExceptionType)
+{
+    if (s_szExceptionType && StrStrI(szExceptionType, s_szExceptionType) != NULL)
+        Dump(FlightRecorderDumpReason::Exception);
+}
+
+/// <summary>
+/// Requests that the dump thread flush the contents of every thread's buffer.
+/// </summary>
+/// <param name="reason">The reason the dump was triggered.</param>
+void CFlightRecorder::Dump(_In_ FlightRecorderDumpReason reason)
+{
+    //Any triggers that occur while a dump is already pending or in progress are ignored
+    if (InterlockedCompareExchange(&s_PendingDump, (LONG)reason + 1, 0) == 0)
+        s_Thread.Wake();
+}
+
+DWORD WINAPI CFlightRecorder::DumpThreadProc(LPVOID lpParameter)
+{
+    while (s_Thread.Wait())
+    {
+        LONG pendingDump = s_PendingDump;
+
+        if (pendingDump == 0)
+            continue;
+
+        WriteDump((FlightRecorderDumpReason)(pendingDump - 1));
+
+        InterlockedExchange(&s_PendingDump, 0);
+    }
+
+    return 0;
+}
+
+/// <summary>
+/// Flushes the contents of every thread's buffer to the client (or to a file, if a dump path was specified).<para/>
+/// The dump is prefixed with a FlightRecorderDumpEvent so that the client knows the events that follow may not
+/// line up with the events it has previously seen.
+/// </summary>
+/// <param name="reason">The reason the dump was triggered.</param>
+void CFlightRecorder::WriteDump(_In_ FlightRecorderDumpReason reason)
+{
+    HANDLE hFile = NULL;
+    DWORD numRecords = 0;
+    DWORD bytesWritten;
+    INT32 dumpReason = (INT32)reason;
+    EVENT_DATA_DESCRIPTOR data[2];
+    MMFRecord marker;
+
+    if (s_szDumpPath)
+    {
+        hFile = CreateDumpFile();
+
+        if (hFile == INVALID_HANDLE_VALUE)
+        {
+            dprintf(L"Failed to create flight recorder dump file: %d\n", GetLastError());
+            return;
+        }
+
+        //Reserve space for the number of records. We'll come back and fill this in at the end
+        WriteFile(hFile, &numRecords, sizeof(DWORD), &bytesWritten, NULL);
+
+        CLock metadataLock(&s_MetadataMutex);
+
+        for (MMFRecord& record : s_Metadata)
+            WriteRecord(hFile, record.Ptr, record.Size, &numRecords);
+    }
+
+    EventDataDescCreate(&data[1], &dumpReason, sizeof(INT32));
+    marker = CreateMMFRecord(&FlightRecorderDumpEvent, 2, data);
+    WriteRecord(hFile, marker.Ptr, marker.Size, &numRecords);
+    free(marker.Ptr);
+
+    //Threads only announce that they're writing to their buffer with a plain store, which may not be visible to this thread yet, and
+    //may not have seen that we're flushing. Flushing every processor's write buffer ensures that any thread that was already writing
+    //can be seen to be, and that any thread that writes after this point will take its buffer's lock
+    s_Flushing = TRUE;
+    FlushProcessWriteBuffers();
+
+    //Lock scope
+    {
+        CLock buffersLock(&s_BuffersMutex);
+
+        for (CFlightRecorderBuffer* pBuffer : s_Buffers)
+            pBuffer->Flush(hFile, &numRecords);
+    }
+
+    s_Flushing = FALSE;
+
+    if (hFile)
+    {
+        SetFilePointer(hFile, 0, NULL, FILE_BEGIN);
+        WriteFile(hFile, &numRecords, sizeof(DWORD), &bytesWritten, NULL);
+        CloseHandle(hFile);
+    }
+
+    //The next events each thread writes to its buffer won't make sense without knowing what frames were active at the time of this dump
+    CCallStackSnapshot::Request();
+}
+
+/// <summary>
+/// Stores a copy of a metadata event for inclusion in dump files, unless an identical event has already been stored or
+/// FLIGHT_RECORDER_MAX_METADATA_SIZE has been reached.
+/// </summary>
+void CFlightRecorder::AddMetadata(
+    _In_ PCEVENT_DESCRIPTOR EventDescriptor,
+    _In_range_(0, MAX_EVENT_DATA_DESCRIPTORS) ULONG UserDataCount,
+    _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData)
+{
+    MMFRecord record = CreateMMFRecord(EventDescriptor, UserDataCount, UserData);
+    MMFEventHeader* pHeader = (MMFEventHeader*)record.Ptr;
+
+    //Two events are the same if they only differ by the time they were written at. The thread is part of their identity, as
+    //events such as ThreadName don't include the thread in their payload. The header's padding is uninitialized so can't be compared
+    BYTE* pPayload = (BYTE*)(pHeader + 1);
+
+    UINT64 hash = 14695981039346656037ULL;
+    hash = (hash ^ pHeader->ThreadId) * 1099511628211ULL;
+    hash = (hash ^ pHeader->EventType) * 1099511628211ULL;
+
+    for (DWORD i = 0; i < pHeader->UserDataSize; i++)
+        hash = (hash ^ pPayload[i]) * 1099511628211ULL;
+
+    CLock lock(&s_MetadataMutex, true);
+
+    if (s_MetadataSize + record.Size > FLIGHT_RECORDER_MAX_METADATA_SIZE)
+    {
+        free(record.Ptr);
+        return;
+    }
+
+    auto range = s_MetadataIndex.equal_range(hash);
+
+    for (auto match = range.first; match != range.second; match++)
+    {
+        MMFEventHeader* pExisting = (MMFEventHeader*)s_Metadata[match->second].Ptr;
+
+        if (pExisting->ThreadId == pHeader->ThreadId && pExisting->EventType == pHeader->EventType && pExisting->UserDataSize == pHeader->UserDataSize &&
+            memcmp(pExisting + 1, pPayload, pHeader->UserDataSize) == 0)
+        {
+            free(record.Ptr);
+            return;
+        }
+    }
+
+    s_MetadataIndex.emplace(hash, s_Metadata.size());
+    s_Metadata.push_back(record);
+    s_MetadataSize += record.Size;
+}
+
+/// <summary>
+/// Discards the events in the current thread's buffer without writing them anywhere.
+/// </summary>
+void CFlightRecorder::DiscardCurrentBuffer()
+{
+    CFlightRecorderBuffer* pBuffer = GetCurrentBuffer();
+
+    if (pBuffer)
+        pBuffer->Clear();
+}
+
+void CFlightRecorder::ReleaseBuffer(_In_ CFlightRecorderBuffer* pBuffer)
+{
+    //Lock scope
+    {
+        CLock lock(&s_BuffersMutex, true);
+
+        auto match = std::find(s_Buffers.begin(), s_Buffers.end(), pBuffer);
+
+        if (match != s_Buffers.end())
+        {
+            s_Buffers.erase(match);
+            s_TotalBufferSize -= pBuffer->m_Size;
+        }
+    }
+
+    delete pBuffer;
+}
+
+/// <summary>
+/// Writes a record to the specified dump file, or to the memory mapped file when no file is specified.<para/>
+/// Records are written in the same format they would appear in the memory mapped file: a DWORD size followed by the record itself.
+/// </summary>
+void CFlightRecorder::WriteRecord(_In_opt_ HANDLE hFile, _In_ void* pRecord, _In_ ULONG size, _Inout_ DWORD* pNumRecords)
+{
+    if (hFile)
+    {
+        DWORD bytesWritten;
+        WriteFile(hFile, &size, sizeof(DWORD), &bytesWritten, NULL);
+        WriteFile(hFile, pRecord, size, &bytesWritten, NULL);
+    }
+    else
+    {
+        //The MMF thread takes ownership of any records it is given
+        void* pCopy = malloc(size);
+        memcpy(pCopy, pRecord, size);
+
+        EnqueueMMFRecord({ size, pCopy });
+    }
+
+    (*pNumRecords)++;
+}
+
+CFlightRecorderBuffer* CFlightRecorder::GetCurrentBuffer()
+{
+    if (g_FlightRecorderBuffer.m_pBuffer == nullptr && !g_FlightRecorderBuffer.m_Denied)
+    {
+        CLock lock(&s_BuffersMutex, true);
+
+        if (s_TotalBufferSize + s_BufferSize > FLIGHT_RECORDER_MAX_TOTAL_SIZE)
+        {
+            dprintf(L"Not recording thread %d as the flight recorder buffers have reached their maximum total size\n", GetCurrentThreadId());
+            g_FlightRecorderBuffer.m_Denied = TRUE;
+            return nullptr;
+        }
+
+        CFlightRecorderBuffer* pBuffer = new CFlightRecorderBuffer(s_BufferSize, GetCurrentThreadId());
+
+        if (pBuffer->m_pBuffer == nullptr)
+        {
+            dprintf(L"Failed to allocate flight recorder buffer for thread %d\n", GetCurrentThreadId());
+            delete pBuffer;
+            g_FlightRecorderBuffer.m_Denied = TRUE;
+            return nullptr;
+        }
+
+        s_Buffers.push_back(pBuffer);
+        s_TotalBufferSize += s_BufferSize;
+
+        g_FlightRecorderBuffer.m_pBuffer = pBuffer;
+    }
+
+    return g_FlightRecorderBuffer.m_pBuffer;
+}
+
+HANDLE CFlightRecorder::CreateDumpFile()
+{
+    WCHAR szFileName[MAX_PATH];
+    swprintf_s(
+        szFileName,
+        L"%s\\FlightRecorder_%d_%d.bin",
+        s_szDumpPath,
+        GetCurrentProcessId(),
+        InterlockedIncrement(&s_DumpCount)
+    );
+
+    return CreateFile(
+        szFileName,
+        GENERIC_WRITE,
+        FILE_SHARE_READ,
+        nullptr,
+        CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+}
+
+#pragma endregion
\ No newline at end of file
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "Events.h"
+#include "CIntervalThread.h"
+#include <unordered_map>
+#include <vector>
+
+extern BOOL g_FlightRecorderEnabled;
+
+//The largest buffer each thread may be given, and the most memory the buffers of all threads may occupy in total.
+//Threads that start once the total has been used up don't record any events
+#define FLIGHT_RECORDER_MAX_BUFFER_SIZE_MB 256
+#define FLIGHT_RECORDER_MAX_TOTAL_SIZE (1024ULL * 1024 * 1024)
+
+//The most bytes of metadata events that will be kept to make dump files self describing
+#define FLIGHT_RECORDER_MAX_METADATA_SIZE (64 * 1024 * 1024)
+
+//Keep in sync with FlightRecorderDumpReason.cs
+enum class FlightRecorderDumpReason
+{
+    Exception = 0,
+    Command,
+    SlowFrame
+};
+
+/// <summary>
+/// A fixed size ring of serialized events belonging to a single thread. When the ring is full, the oldest events are overwritten.
+/// Each record is stored as a DWORD size followed by an <see cref="MMFEventHeader"/> and the event's payload, the same as they would
+/// appear in the memory mapped file.
+/// </summary>
+class CFlightRecorderBuffer
+{
+public:
+    CFlightRecorderBuffer(ULONG size, DWORD threadId) :
+        m_Size(size),
+        m_Head(0),
+        m_Tail(0),
+        m_Used(0),
+        m_ThreadId(threadId),
+        m_Writing(FALSE)
+    {
+        m_pBuffer = (BYTE*)malloc(size);
+    }
+
+    ~CFlightRecorderBuffer()
+    {
+        if (m_pBuffer)
+            free(m_pBuffer);
+    }
+
+    BOOL Write(
+        _In_ PCEVENT_DESCRIPTOR EventDescriptor,
+        _In_ ULONG UserDataCount,
+        _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData,
+        _Out_ BOOL* pIsSlowFrame);
+
+    void Flush(_In_opt_ HANDLE hFile, _Inout_ DWORD* pNumRecords);
+    void Clear();
+
+    ULONG m_Size;
+    BYTE* m_pBuffer;
+
+    //The offset of the oldest record in the buffer
+    ULONG m_Head;
+
+    //The offset the next record will be written to
+    ULONG m_Tail;
+
+    //The number of bytes currently occupied by records
+    ULONG m_Used;
+
+    DWORD m_ThreadId;
+
+    //The QPC each currently active frame on this thread was entered at. Used to detect slow frames
+    std::vector<LONGLONG> m_EnterTimes;
+
+    //Whether the owning thread is currently writing to the buffer without holding m_Mutex. See CFlightRecorder::WriteDump
+    volatile BOOL m_Writing;
+
+    //Only taken by the owning thread while a dump is in progress
+    std::shared_mutex m_Mutex;
+
+private:
+    void WriteRecord(
+        _In_ const MMFEventHeader& header,
+        _In_ ULONG UserDataCount,
+        _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData);
+    void Evict();
+    void CopyIn(_In_ const void* pData, _In_ ULONG size);
+    void CopyOut(_In_ ULONG offset, _Out_ void* pData, _In_ ULONG size);
+};
+
+/// <summary>
+/// Captures call and exception events into per-thread in-memory rings instead of transferring them to the client,
+/// only flushing them when a trigger condition occurs (an exception of interest, a slow frame or an explicit request from the client).
+/// Dumps are written by a background thread, so that the thread that triggered the dump isn't blocked while every buffer is flushed.
+/// </summary>
+class CFlightRecorder
+{
+public:
+    static HRESULT Initialize();
+    static void Shutdown();
+
+    static ULONG Write(
+        _In_ REGHANDLE RegHandle,
+        _In_ PCEVENT_DESCRIPTOR EventDescriptor,
+        _In_opt_ LPCGUID ActivityId,
+        _In_opt_ LPCGUID RelatedActivityId,
+        _In_range_(0, MAX_EVENT_DATA_DESCRIPTORS) ULONG UserDataCount,
+        _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData);
+
+    static void ExceptionThrown(_In_ LPCWSTR szExceptionType);
+
+    static void Dump(_In_ FlightRecorderDumpReason reason);
+    static void DiscardCurrentBuffer();
+
+    static void ReleaseBuffer(_In_ CFlightRecorderBuffer* pBuffer);
+    static void WriteRecord(_In_opt_ HANDLE hFile, _In_ void* pRecord, _In_ ULONG size, _Inout_ DWORD* pNumRecords);
+
+    static LONGLONG s_SlowFrameThreshold;
+    static ULONGLONG s_SlowFrameThresholdDuration;
+
+    //Whether a dump is currently flushing the buffers, in which case threads must take their buffer's lock in order to write to it
+    static volatile BOOL s_Flushing;
+
+private:
+    static DWORD WINAPI DumpThreadProc(LPVOID lpParameter);
+    static void WriteDump(_In_ FlightRecorderDumpReason reason);
+    static void AddMetadata(
+        _In_ PCEVENT_DESCRIPTOR EventDescriptor,
+        _In_range_(0, MAX_EVENT_DATA_DESCRIPTORS) ULONG UserDataCount,
+        _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData);
+    static CFlightRecorderBuffer* GetCurrentBuffer();
+    static HANDLE CreateDumpFile();
+
+    static ULONG s_BufferSize;
+    static LPWSTR s_szDumpPath;
+    static LPWSTR s_szExceptionType;
+
+    static std::vector<CFlightRecorderBuffer*> s_Buffers;
+    static ULONGLONG s_TotalBufferSize;
+    static std::shared_mutex s_BuffersMutex;
+
+    //Copies of events that describe the data contained in call events (methods, modules, threads). These must be included in
+    //a dump written to a file in order for it to be self describing. Identical events are only stored once, indexed by the hash
+    //of their contents
+    static std::vector<MMFRecord> s_Metadata;
+    static std::unordered_multimap<UINT64, size_t> s_MetadataIndex;
+    static ULONGLONG s_MetadataSize;
+    static std::shared_mutex s_MetadataMutex;
+
+    //The reason of the dump that has been requested of the dump thread plus one, or 0 if no dump is pending
+    static volatile LONG s_PendingDump;
+    static LONG s_DumpCount;
+    static CIntervalThread s_Thread;
+};
\ No newline at end of file
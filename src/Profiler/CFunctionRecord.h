@@ -0,0 +1,86 @@
+#pragma once
+
+/// <summary>
+/// Stores state about a hooked function that needs to be accessed each time the function is called.<para/>
+/// RecordFunction creates a record for each function it hooks and returns it from the function ID mapper, causing the CLR to pass
+/// the record to the ELT hooks as the function's client ID. This allows the hooks to access the record without performing a lookup.
+/// </summary>
+class CFunctionRecord
+{
+public:
+    CFunctionRecord(FunctionID functionId) :
+        m_FunctionId(functionId),
+        m_HooksDisabled(FALSE),
+        m_Suppressed(FALSE),
+        m_HasChildren(FALSE),
+        m_CallCount(0),
+        m_TotalDuration(0),
+        m_WindowCallCount(0),
+        m_WindowDuration(0),
+        m_CoverageIndex(0),
+        m_SlowCallTrigger(FALSE),
+        m_AggregateCallCount(0),
+        m_AggregateInclusiveDuration(0),
+        m_AggregateExclusiveDuration(0),
+        m_ReportedCallCount(0),
+        m_ReportedInclusiveDuration(0),
+        m_ReportedExclusiveDuration(0)
+    {
+        LARGE_INTEGER qpc;
+        QueryPerformanceCounter(&qpc);
+
+        m_WindowStart = qpc.QuadPart;
+    }
+
+    //Must be the first member, so that a client ID that is mistakenly treated as a pointer to a FunctionID still resolves correctly
+    FunctionID m_FunctionId;
+
+    //Whether the hooks have nothing left to do for this function. The naked hooks test this before saving any registers, and return
+    //immediately if it's set. Must directly follow m_FunctionId, as its offset is hardcoded in the naked hooks
+    volatile BOOL m_HooksDisabled;
+
+    //Whether the hooks should stop writing events for this function
+    volatile BOOL m_Suppressed;
+
+    //Whether any frames have ever been entered while this function was active
+    volatile BOOL m_HasChildren;
+
+    //The number of times the function has been called and the total time (in QPC ticks) these calls took.
+    //These are only recorded when hot function suppression is enabled
+    volatile LONG64 m_CallCount;
+    volatile LONG64 m_TotalDuration;
+
+    //The QPC the current measurement window started at, and the values of m_CallCount and m_TotalDuration at that time
+    volatile LONG64 m_WindowStart;
+    volatile LONG64 m_WindowCallCount;
+    volatile LONG64 m_WindowDuration;
+
+    //The function's bit in the coverage bitmap. Only assigned when coverage is enabled
+    ULONG m_CoverageIndex;
+
+    //Whether calls to the function start a slow call capture. Only assigned when DEBUGTOOLS_SLOW_CALL_TRIGGERS is specified
+    BOOL m_SlowCallTrigger;
+
+    //The number of calls to the function that have returned and their QPC durations, and the values of these counters
+    //at the time the last continuous snapshot was written. These are only recorded in continuous profiling mode
+    volatile LONG64 m_AggregateCallCount;
+    volatile LONG64 m_AggregateInclusiveDuration;
+    volatile LONG64 m_AggregateExclusiveDuration;
+    LONG64 m_ReportedCallCount;
+    LONG64 m_ReportedInclusiveDuration;
+    LONG64 m_ReportedExclusiveDuration;
+};
+
+static_assert(offsetof(CFunctionRecord, m_HooksDisabled) == sizeof(FunctionID), "m_HooksDisabled must directly follow m_FunctionId");
+
+/// <summary>
+/// Retrieves the <see cref="CFunctionRecord"/> that was passed to an ELT hook as its client ID, and replaces the client ID with the FunctionID
+/// the record was created for, so that the remainder of the hook can continue to treat it as a FunctionID.
+/// </summary>
+inline CFunctionRecord* ResolveFunctionRecord(FunctionIDOrClientID& functionId)
+{
+    CFunctionRecord* pRecord = (CFunctionRecord*)functionId.clientID;
+    functionId.functionID = pRecord->m_FunctionId;
+
+    return pRecord;
+}
\ No newline at end of file
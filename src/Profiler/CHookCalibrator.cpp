@@ -0,0 +1,120 @@
+#include "pch.h"
+#include "CHookCalibrator.h"
+#include "CCallCoalescer.h"
+#include "CCorProfilerCallback.h"
+#include "CFlightRecorder.h"
+#include "CValueTracer.h"
+#include "Events.h"
+
+//The calibration loop is repeated several times, and the fastest round is used, so that a round that was
+//interrupted by the thread being switched out doesn't inflate the result
+#define CALIBRATION_CALLS 10000
+#define CALIBRATION_ROUNDS 5
+
+ULONG64 CHookCalibrator::s_CompensatedCycles = 0;
+ULONG64 CHookCalibrator::s_CompensatedQPC = 0;
+BOOL CHookCalibrator::s_Calibrating = FALSE;
+ULONG64 CHookCalibrator::s_EnterLeaveCycles = 0;
+
+/// <summary>
+/// Measures the cost of a single Enter and Leave. Must be called after the hooks have been selected, and before the event provider
+/// has been registered.
+/// </summary>
+/// <param name="pEnter">The Enter hook the CLR or the instrumented IL calls.</param>
+/// <param name="pLeave">The Leave hook the CLR or the instrumented IL calls.</param>
+void CHookCalibrator::Calibrate(_In_ FunctionEnter3* pEnter, _In_ FunctionLeave3* pLeave)
+{
+    ULONG64 enterLeaveQPC;
+
+    MeasureEnterLeave(pEnter, pLeave, &s_EnterLeaveCycles, &enterLeaveQPC);
+
+    if (GetBoolEnv("DEBUGTOOLS_COMPENSATE_HOOK_OVERHEAD"))
+    {
+        s_CompensatedCycles = s_EnterLeaveCycles;
+        s_CompensatedQPC = enterLeaveQPC;
+    }
+}
+
+/// <summary>
+/// Writes the cost of a single Enter and Leave to the client in a HookOverheadEvent. Must be called after the event provider has been registered.
+/// </summary>
+void CHookCalibrator::WriteHookOverhead()
+{
+    HRESULT hr = S_OK;
+
+    if (s_EnterLeaveCycles != 0)
+        ValidateETW(EventWriteHookOverheadEvent(s_EnterLeaveCycles));
+}
+
+void CHookCalibrator::MeasureEnterLeave(_In_ FunctionEnter3* pEnter, _In_ FunctionLeave3* pLeave, _Out_ ULONG64* pCycles, _Out_ ULONG64* pQPC)
+{
+    CThreadContext* pContext = GetThreadContext();
+
+    //The record must never be resolved to a real function, so its FunctionID is simply its own address
+    CFunctionRecord record((FunctionID)&record);
+
+    FunctionIDOrClientID functionId;
+    functionId.clientID = (UINT_PTR)&record;
+
+    //The hooks must do everything they would do for a function that is being traced. The client must not see any gaps in this thread's sequence
+    bool tracingEnabled = g_TracingEnabled;
+    BOOL hooksDisabled = g_HooksDisabled;
+    ULONG sequence = pContext->Sequence;
+
+    g_TracingEnabled = true;
+    g_HooksDisabled = FALSE;
+    s_Calibrating = TRUE;
+
+    ULONG64 bestCycles = MAXULONG64;
+    ULONG64 bestQPC = MAXULONG64;
+
+    for (int i = 0; i < CALIBRATION_ROUNDS; i++)
+    {
+        ULONG64 startCycles;
+        ULONG64 endCycles;
+        LARGE_INTEGER startQPC;
+        LARGE_INTEGER endQPC;
+
+        QueryPerformanceCounter(&startQPC);
+        QueryThreadCycleTime(GetCurrentThread(), &startCycles);
+
+        for (int j = 0; j < CALIBRATION_CALLS; j++)
+        {
+            pEnter(functionId);
+            pLeave(functionId);
+        }
+
+        QueryThreadCycleTime(GetCurrentThread(), &endCycles);
+        QueryPerformanceCounter(&endQPC);
+
+        bestCycles = min(bestCycles, (endCycles - startCycles) / CALIBRATION_CALLS);
+        bestQPC = min(bestQPC, (ULONG64)(endQPC.QuadPart - startQPC.QuadPart) * HOOK_OVERHEAD_QPC_SCALE / CALIBRATION_CALLS);
+    }
+
+    DiscardEvents(pContext);
+
+    s_Calibrating = FALSE;
+    g_HooksDisabled = hooksDisabled;
+    g_TracingEnabled = tracingEnabled;
+    pContext->Sequence = sequence;
+
+    *pCycles = bestCycles;
+    *pQPC = bestQPC;
+}
+
+/// <summary>
+/// Discards the events the hooks wrote for the calibration record. Events sent to ETW were already dropped, as no session can be listening
+/// to a provider that hasn't been registered yet, however the memory mapped file queue and the flight recorder hold onto events until they're consumed.
+/// </summary>
+void CHookCalibrator::DiscardEvents(_In_ CThreadContext* pContext)
+{
+    //The coalescer may be holding onto a run of calls to the calibration record
+    if (g_CoalesceCalls)
+        CCallCoalescer::FlushThread(pContext);
+
+    if (g_FlightRecorderEnabled)
+        CFlightRecorder::DiscardCurrentBuffer();
+
+    if (!g_IsETW)
+        DiscardMMFRecords();
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CThreadContext.h"
+
+//QPC ticks are too coarse to represent a single Enter and Leave, so the QPC overhead is stored as the cost of this many of them
+#define HOOK_OVERHEAD_QPC_SCALE 1000
+
+/// <summary>
+/// Measures how long the hooks that were installed for the current profiler mode take to execute, so that the cost of the hooks
+/// can be reported to the client and optionally removed from the CPU time and durations attributed to each frame.<para/>
+/// The hooks are invoked through the same entry points the CLR calls, with tracing enabled, against a function record that was never given
+/// to the CLR. Calibration happens before the event provider is registered, so that the events the hooks write never reach the client.
+/// As a result, when ETW is used the cost of ETW delivering each event to a session is not included.
+/// </summary>
+class CHookCalibrator
+{
+public:
+    static void Calibrate(_In_ FunctionEnter3* pEnter, _In_ FunctionLeave3* pLeave);
+    static void WriteHookOverhead();
+
+    //The cost of a single Enter and Leave in cycles, and of HOOK_OVERHEAD_QPC_SCALE of them in QPC ticks, that should be subtracted for
+    //each call beneath a frame. Both are 0 unless hook overhead compensation is enabled
+    static ULONG64 s_CompensatedCycles;
+    static ULONG64 s_CompensatedQPC;
+
+    //Whether the hooks are currently being calibrated, in which case they must not trigger anything that outlives the calibration
+    static BOOL s_Calibrating;
+
+private:
+    static void MeasureEnterLeave(_In_ FunctionEnter3* pEnter, _In_ FunctionLeave3* pLeave, _Out_ ULONG64* pCycles, _Out_ ULONG64* pQPC);
+    static void DiscardEvents(_In_ CThreadContext* pContext);
+
+    static ULONG64 s_EnterLeaveCycles;
+};
\ No newline at end of file
@@ -0,0 +1,570 @@
+#include "pch.h"
+#include "CILRewriter.h"
+#include <algorithm>
+
+#define CEE_LDC_I8 0x21
+#define CEE_JMP 0x27
+#define CEE_CALLI 0x29
+#define CEE_RET 0x2A
+#define CEE_BR_S 0x2B
+#define CEE_BLT_UN_S 0x37
+#define CEE_LEAVE 0xDD
+#define CEE_LEAVE_S 0xDE
+#define CEE_CONV_I 0xD3
+#define CEE_PREFIX1 0xFE
+#define CEE_TAILCALL 0xFE14
+
+//ldc.i8 clientId, conv.i, ldc.i8 pStub, conv.i, calli probeSig
+#define PROBE_SIZE 25
+
+//Both small and fat sections begin with a DWORD containing their kind and size
+#define SECTION_HEADER_SIZE 4
+
+const BYTE CILRewriter::ProbeSig[] = {
+    IMAGE_CEE_CS_CALLCONV_STDCALL,
+    1,                 //Parameter count
+    ELEMENT_TYPE_VOID, //Return type
+    ELEMENT_TYPE_I     //FunctionIDOrClientID
+};
+
+const ULONG CILRewriter::ProbeSigSize = sizeof(CILRewriter::ProbeSig);
+
+enum class OperandKind
+{
+    None,
+    Int8,
+    Int16,
+    Int32,
+    Int64,
+    ShortBranch,
+    Branch,
+    Switch
+};
+
+static OperandKind GetOperandKind(USHORT opcode)
+{
+    if (opcode >= 0xFE00)
+    {
+        switch (opcode & 0xFF)
+        {
+        case 0x09: //ldarg
+        case 0x0A: //ldarga
+        case 0x0B: //starg
+        case 0x0C: //ldloc
+        case 0x0D: //ldloca
+        case 0x0E: //stloc
+            return OperandKind::Int16;
+
+        case 0x12: //unaligned.
+        case 0x19: //no.
+            return OperandKind::Int8;
+
+        case 0x06: //ldftn
+        case 0x07: //ldvirtftn
+        case 0x15: //initobj
+        case 0x16: //constrained.
+        case 0x1C: //sizeof
+            return OperandKind::Int32;
+
+        default:
+            return OperandKind::None;
+        }
+    }
+
+    if (opcode >= 0x0E && opcode <= 0x13) //ldarg.s - stloc.s
+        return OperandKind::Int8;
+
+    if (opcode >= CEE_BR_S && opcode <= CEE_BLT_UN_S)
+        return OperandKind::ShortBranch;
+
+    if (opcode >= 0x38 && opcode <= 0x44) //br - blt.un
+        return OperandKind::Branch;
+
+    switch (opcode)
+    {
+    case 0x1F: //ldc.i4.s
+        return OperandKind::Int8;
+
+    case 0x21: //ldc.i8
+    case 0x23: //ldc.r8
+        return OperandKind::Int64;
+
+    case 0x20: //ldc.i4
+    case 0x22: //ldc.r4
+    case 0x27: //jmp
+    case 0x28: //call
+    case 0x29: //calli
+    case 0x6F: //callvirt
+    case 0x70: //cpobj
+    case 0x71: //ldobj
+    case 0x72: //ldstr
+    case 0x73: //newobj
+    case 0x74: //castclass
+    case 0x75: //isinst
+    case 0x79: //unbox
+    case 0x7B: //ldfld
+    case 0x7C: //ldflda
+    case 0x7D: //stfld
+    case 0x7E: //ldsfld
+    case 0x7F: //ldsflda
+    case 0x80: //stsfld
+    case 0x81: //stobj
+    case 0x8C: //box
+    case 0x8D: //newarr
+    case 0x8F: //ldelema
+    case 0xA3: //ldelem
+    case 0xA4: //stelem
+    case 0xA5: //unbox.any
+    case 0xC2: //refanyval
+    case 0xC6: //mkrefany
+    case 0xD0: //ldtoken
+        return OperandKind::Int32;
+
+    case 0x45: //switch
+        return OperandKind::Switch;
+
+    case CEE_LEAVE:
+        return OperandKind::Branch;
+
+    case CEE_LEAVE_S:
+        return OperandKind::ShortBranch;
+
+    default:
+        return OperandKind::None;
+    }
+}
+
+static ULONG GetOperandSize(OperandKind kind)
+{
+    switch (kind)
+    {
+    case OperandKind::Int8:
+    case OperandKind::ShortBranch:
+        return 1;
+
+    case OperandKind::Int16:
+        return 2;
+
+    case OperandKind::Int32:
+    case OperandKind::Branch:
+        return 4;
+
+    case OperandKind::Int64:
+        return 8;
+
+    default:
+        return 0;
+    }
+}
+
+template<typename T>
+FORCEINLINE T ReadValue(LPCBYTE ptr)
+{
+    T value;
+    memcpy(&value, ptr, sizeof(T));
+    return value;
+}
+
+template<typename T>
+FORCEINLINE void WriteValue(BYTE*& ptr, T value)
+{
+    memcpy(ptr, &value, sizeof(T));
+    ptr += sizeof(T);
+}
+
+HRESULT CILRewriter::Import(
+    _In_ LPCBYTE pMethodHeader,
+    _In_ ULONG cbMethodSize)
+{
+    HRESULT hr = S_OK;
+    LPCBYTE pEnd = pMethodHeader + cbMethodSize;
+    LPCBYTE pCode;
+
+    if (cbMethodSize == 0)
+        return PROFILER_E_INVALID_IL;
+
+    if ((*pMethodHeader & 0x3) == CorILMethod_TinyFormat)
+    {
+        m_CodeSize = *pMethodHeader >> 2;
+        m_MaxStack = 8;
+        pCode = pMethodHeader + 1;
+    }
+    else
+    {
+        if (cbMethodSize < sizeof(IMAGE_COR_ILMETHOD_FAT))
+            return PROFILER_E_INVALID_IL;
+
+        const IMAGE_COR_ILMETHOD_FAT* pFat = (const IMAGE_COR_ILMETHOD_FAT*)pMethodHeader;
+
+        m_Flags = pFat->Flags;
+        m_MaxStack = pFat->MaxStack;
+        m_CodeSize = pFat->CodeSize;
+        m_LocalVarSigTok = pFat->LocalVarSigTok;
+
+        pCode = pMethodHeader + pFat->Size * sizeof(DWORD);
+    }
+
+    if (pCode > pEnd || m_CodeSize > (ULONG)(pEnd - pCode))
+        return PROFILER_E_INVALID_IL;
+
+    IfFailGo(ImportCode(pCode, m_CodeSize));
+
+    if (m_Flags & CorILMethod_MoreSects)
+    {
+        //Extra sections begin at the next DWORD boundary after the code
+        LPCBYTE pSection = (LPCBYTE)(((UINT_PTR)(pCode + m_CodeSize) + 3) & ~(UINT_PTR)3);
+
+        IfFailGo(ImportSections(pSection, pEnd));
+    }
+
+ErrExit:
+    return hr;
+}
+
+HRESULT CILRewriter::ImportCode(
+    _In_ LPCBYTE pCode,
+    _In_ ULONG cbCode)
+{
+    ULONG offset = 0;
+
+    while (offset < cbCode)
+    {
+        ILInstruction instr;
+        instr.Offset = offset;
+        instr.Operand = 0;
+
+        USHORT opcode = pCode[offset++];
+
+        if (opcode == CEE_PREFIX1)
+        {
+            if (offset >= cbCode)
+                return PROFILER_E_INVALID_IL;
+
+            opcode = (CEE_PREFIX1 << 8) | pCode[offset++];
+        }
+
+        instr.Opcode = opcode;
+
+        OperandKind kind = GetOperandKind(opcode);
+
+        if (kind == OperandKind::Switch)
+        {
+            if (cbCode - offset < sizeof(UINT32))
+                return PROFILER_E_INVALID_IL;
+
+            UINT32 count = ReadValue<UINT32>(pCode + offset);
+            offset += sizeof(UINT32);
+
+            if (count > (cbCode - offset) / sizeof(INT32))
+                return PROFILER_E_INVALID_IL;
+
+            //Switch targets are relative to the end of the entire instruction
+            ULONG next = offset + count * sizeof(INT32);
+
+            for (UINT32 i = 0; i < count; i++)
+            {
+                instr.Targets.push_back(next + ReadValue<INT32>(pCode + offset));
+                offset += sizeof(INT32);
+            }
+        }
+        else
+        {
+            ULONG operandSize = GetOperandSize(kind);
+
+            if (cbCode - offset < operandSize)
+                return PROFILER_E_INVALID_IL;
+
+            ULONG next = offset + operandSize;
+
+            if (kind == OperandKind::ShortBranch)
+                instr.Targets.push_back(next + ReadValue<INT8>(pCode + offset));
+            else if (kind == OperandKind::Branch)
+                instr.Targets.push_back(next + ReadValue<INT32>(pCode + offset));
+            else
+                memcpy(&instr.Operand, pCode + offset, operandSize);
+
+            offset = next;
+        }
+
+        m_Instructions.push_back(std::move(instr));
+    }
+
+    for (ILInstruction& instr : m_Instructions)
+    {
+        for (ULONG target : instr.Targets)
+        {
+            if (!IsInstructionStart(target))
+                return PROFILER_E_INVALID_IL;
+        }
+    }
+
+    return S_OK;
+}
+
+HRESULT CILRewriter::ImportSections(_In_ LPCBYTE pSection, _In_ LPCBYTE pEnd)
+{
+#define SMALL_CLAUSE_SIZE 12
+
+    BYTE kind;
+
+    do
+    {
+        if (pSection + SECTION_HEADER_SIZE > pEnd)
+            return PROFILER_E_INVALID_IL;
+
+        kind = pSection[0];
+
+        //Exception handling tables are the only kind of section that is defined
+        if ((kind & CorILMethod_Sect_KindMask) != CorILMethod_Sect_EHTable)
+            return PROFILER_E_INVALID_IL;
+
+        BOOL isFat = kind & CorILMethod_Sect_FatFormat;
+        ULONG dataSize = isFat ? (pSection[1] | (pSection[2] << 8) | (pSection[3] << 16)) : pSection[1];
+
+        if (dataSize < SECTION_HEADER_SIZE || dataSize > (ULONG)(pEnd - pSection))
+            return PROFILER_E_INVALID_IL;
+
+        LPCBYTE pClause = pSection + SECTION_HEADER_SIZE;
+        ULONG clauseSize = isFat ? sizeof(IMAGE_COR_ILMETHOD_SECT_EH_CLAUSE_FAT) : SMALL_CLAUSE_SIZE;
+        ULONG count = (dataSize - SECTION_HEADER_SIZE) / clauseSize;
+
+        for (ULONG i = 0; i < count; i++, pClause += clauseSize)
+        {
+            IMAGE_COR_ILMETHOD_SECT_EH_CLAUSE_FAT clause;
+
+            if (isFat)
+                memcpy(&clause, pClause, sizeof(clause));
+            else
+            {
+                clause.Flags = (CorExceptionFlag)ReadValue<USHORT>(pClause);
+                clause.TryOffset = ReadValue<USHORT>(pClause + 2);
+                clause.TryLength = pClause[4];
+                clause.HandlerOffset = ReadValue<USHORT>(pClause + 5);
+                clause.HandlerLength = pClause[7];
+                clause.ClassToken = ReadValue<DWORD>(pClause + 8);
+            }
+
+            BOOL isFilter = clause.Flags & COR_ILEXCEPTION_CLAUSE_FILTER;
+
+            if (!IsInstructionStart(clause.TryOffset) || !IsInstructionStart(clause.HandlerOffset) || (isFilter && !IsInstructionStart(clause.FilterOffset)))
+                return PROFILER_E_INVALID_IL;
+
+            ULONG tryEnd = clause.TryOffset + clause.TryLength;
+            ULONG handlerEnd = clause.HandlerOffset + clause.HandlerLength;
+
+            if ((tryEnd != m_CodeSize && !IsInstructionStart(tryEnd)) || (handlerEnd != m_CodeSize && !IsInstructionStart(handlerEnd)))
+                return PROFILER_E_INVALID_IL;
+
+            m_Clauses.push_back(clause);
+        }
+
+        pSection = (LPCBYTE)(((UINT_PTR)(pSection + dataSize) + 3) & ~(UINT_PTR)3);
+    } while (kind & CorILMethod_Sect_MoreSects);
+
+    return S_OK;
+
+#undef SMALL_CLAUSE_SIZE
+}
+
+/// <summary>
+/// Gets whether the method contains any tail. prefixed calls. Such methods can't be rewritten, as a tail call would skip the Leave probe,
+/// while removing the prefix would cause methods that rely on tail calls for deep recursion to overflow the stack.
+/// </summary>
+BOOL CILRewriter::HasTailCalls()
+{
+    return std::any_of(
+        m_Instructions.begin(),
+        m_Instructions.end(),
+        [](const ILInstruction& instr) { return instr.Opcode == CEE_TAILCALL; }
+    );
+}
+
+BOOL CILRewriter::IsInstructionStart(ULONG offset)
+{
+    auto match = std::lower_bound(
+        m_Instructions.begin(),
+        m_Instructions.end(),
+        offset,
+        [](const ILInstruction& instr, ULONG value) { return instr.Offset < value; }
+    );
+
+    return match != m_Instructions.end() && match->Offset == offset;
+}
+
+/// <summary>
+/// Gets the number of bytes an instruction will occupy in the rewritten method, including any probe that will be inserted before it.
+/// </summary>
+ULONG CILRewriter::GetNewSize(_In_ const ILInstruction& instr)
+{
+    ULONG size = instr.Opcode > 0xFF ? 2 : 1;
+
+    OperandKind kind = GetOperandKind(instr.Opcode);
+
+    if (kind == OperandKind::Switch)
+        size += sizeof(UINT32) + (ULONG)instr.Targets.size() * sizeof(INT32);
+    else if (kind == OperandKind::ShortBranch)
+        size += sizeof(INT32);
+    else
+        size += GetOperandSize(kind);
+
+    if (instr.Opcode == CEE_RET || instr.Opcode == CEE_JMP)
+        size += PROBE_SIZE;
+
+    return size;
+}
+
+/// <summary>
+/// Calculates the offset each instruction will have in the rewritten method, and returns the total size of the rewritten method.
+/// </summary>
+ULONG CILRewriter::GetExportSize()
+{
+    m_OffsetMap.assign(m_CodeSize + 1, 0);
+
+    ULONG offset = PROBE_SIZE;
+
+    for (ILInstruction& instr : m_Instructions)
+    {
+        //Any branch to a ret must land on the Leave probe in front of it
+        m_OffsetMap[instr.Offset] = offset;
+        offset += GetNewSize(instr);
+    }
+
+    m_OffsetMap[m_CodeSize] = offset;
+    m_NewCodeSize = offset;
+
+    ULONG size = sizeof(IMAGE_COR_ILMETHOD_FAT) + m_NewCodeSize;
+
+    if (!m_Clauses.empty())
+    {
+        size = (size + 3) & ~3;
+        size += SECTION_HEADER_SIZE + (ULONG)m_Clauses.size() * sizeof(IMAGE_COR_ILMETHOD_SECT_EH_CLAUSE_FAT);
+    }
+
+    return size;
+}
+
+/// <summary>
+/// Writes the rewritten method to a buffer allocated by the method body allocator. <see cref="GetExportSize"/> must be called first.
+/// </summary>
+/// <param name="clientId">The value to pass to the stubs. This will be the function's <see cref="CFunctionRecord"/>.</param>
+/// <param name="pEnterStub">The stub to call when the method is entered.</param>
+/// <param name="pLeaveStub">The stub to call before each ret and jmp instruction.</param>
+/// <param name="probeSig">The token of the <see cref="ProbeSig"/> in the module containing the method.</param>
+/// <param name="pMethodHeader">The buffer to write the method to.</param>
+void CILRewriter::Export(
+    _In_ UINT_PTR clientId,
+    _In_ void* pEnterStub,
+    _In_ void* pLeaveStub,
+    _In_ mdSignature probeSig,
+    _Out_ BYTE* pMethodHeader)
+{
+    //The rewritten method always uses a fat header, as it may no longer fit in a tiny one
+    IMAGE_COR_ILMETHOD_FAT* pHeader = (IMAGE_COR_ILMETHOD_FAT*)pMethodHeader;
+    pHeader->Flags = CorILMethod_FatFormat | (m_Flags & CorILMethod_InitLocals) | (m_Clauses.empty() ? 0 : CorILMethod_MoreSects);
+    pHeader->Size = sizeof(IMAGE_COR_ILMETHOD_FAT) / sizeof(DWORD);
+
+    //The probes push two values, which may be on top of a return value
+    pHeader->MaxStack = min(m_MaxStack + 2, 0xFFFF);
+    pHeader->CodeSize = m_NewCodeSize;
+    pHeader->LocalVarSigTok = m_LocalVarSigTok;
+
+    BYTE* pCode = pMethodHeader + sizeof(IMAGE_COR_ILMETHOD_FAT);
+    BYTE* ptr = WriteProbe(pCode, clientId, pEnterStub, probeSig);
+
+    for (ILInstruction& instr : m_Instructions)
+    {
+        if (instr.Opcode == CEE_RET || instr.Opcode == CEE_JMP)
+            ptr = WriteProbe(ptr, clientId, pLeaveStub, probeSig);
+
+        OperandKind kind = GetOperandKind(instr.Opcode);
+
+        //Branch targets are relative to the end of the instruction
+        ULONG next = m_OffsetMap[instr.Offset] + GetNewSize(instr);
+
+        if (instr.Opcode > 0xFF)
+        {
+            *ptr++ = CEE_PREFIX1;
+            *ptr++ = (BYTE)instr.Opcode;
+        }
+        else if (kind == OperandKind::ShortBranch)
+        {
+            //Each short branch has a long form with the same semantics. br.s - blt.un.s are 13 opcodes before br - blt.un
+            *ptr++ = instr.Opcode == CEE_LEAVE_S ? CEE_LEAVE : (BYTE)(instr.Opcode + 0x0D);
+        }
+        else
+            *ptr++ = (BYTE)instr.Opcode;
+
+        switch (kind)
+        {
+        case OperandKind::Switch:
+            WriteValue<UINT32>(ptr, (UINT32)instr.Targets.size());
+
+            for (ULONG target : instr.Targets)
+                WriteValue<INT32>(ptr, (INT32)(m_OffsetMap[target] - next));
+            break;
+
+        case OperandKind::ShortBranch:
+        case OperandKind::Branch:
+            WriteValue<INT32>(ptr, (INT32)(m_OffsetMap[instr.Targets[0]] - next));
+            break;
+
+        default:
+        {
+            ULONG operandSize = GetOperandSize(kind);
+            memcpy(ptr, &instr.Operand, operandSize);
+            ptr += operandSize;
+            break;
+        }
+        }
+    }
+
+    if (m_Clauses.empty())
+        return;
+
+    while ((ptr - pMethodHeader) % sizeof(DWORD) != 0)
+        *ptr++ = 0;
+
+    ULONG dataSize = SECTION_HEADER_SIZE + (ULONG)m_Clauses.size() * sizeof(IMAGE_COR_ILMETHOD_SECT_EH_CLAUSE_FAT);
+
+    *ptr++ = CorILMethod_Sect_EHTable | CorILMethod_Sect_FatFormat;
+    *ptr++ = (BYTE)dataSize;
+    *ptr++ = (BYTE)(dataSize >> 8);
+    *ptr++ = (BYTE)(dataSize >> 16);
+
+    for (IMAGE_COR_ILMETHOD_SECT_EH_CLAUSE_FAT clause : m_Clauses)
+    {
+        ULONG tryEnd = m_OffsetMap[clause.TryOffset + clause.TryLength];
+        ULONG handlerEnd = m_OffsetMap[clause.HandlerOffset + clause.HandlerLength];
+
+        clause.TryOffset = m_OffsetMap[clause.TryOffset];
+        clause.TryLength = tryEnd - clause.TryOffset;
+        clause.HandlerOffset = m_OffsetMap[clause.HandlerOffset];
+        clause.HandlerLength = handlerEnd - clause.HandlerOffset;
+
+        if (clause.Flags & COR_ILEXCEPTION_CLAUSE_FILTER)
+            clause.FilterOffset = m_OffsetMap[clause.FilterOffset];
+
+        memcpy(ptr, &clause, sizeof(clause));
+        ptr += sizeof(clause);
+    }
+}
+
+BYTE* CILRewriter::WriteProbe(
+    _In_ BYTE* ptr,
+    _In_ UINT_PTR clientId,
+    _In_ void* pStub,
+    _In_ mdSignature probeSig)
+{
+    *ptr++ = CEE_LDC_I8;
+    WriteValue<UINT64>(ptr, clientId);
+    *ptr++ = CEE_CONV_I;
+
+    *ptr++ = CEE_LDC_I8;
+    WriteValue<UINT64>(ptr, (UINT_PTR)pStub);
+    *ptr++ = CEE_CONV_I;
+
+    *ptr++ = CEE_CALLI;
+    WriteValue<mdSignature>(ptr, probeSig);
+
+    return ptr;
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vector>
+
+struct ILInstruction
+{
+    //The offset of the instruction in the original method body
+    ULONG Offset;
+
+    //The opcode of the instruction. Two byte opcodes include their 0xFE prefix
+    USHORT Opcode;
+
+    //The value of any inline operand that isn't a branch target
+    UINT64 Operand;
+
+    //The original offsets of any instructions this instruction may branch to
+    std::vector<ULONG> Targets;
+};
+
+/// <summary>
+/// Rewrites the IL of a method so that it calls the hook stubs directly, as a cheaper alternative to ELT hooks.<para/>
+/// ELT hooks are invoked through naked stubs that must preserve every register, as they're called from the prolog and epilog of a method
+/// where the JIT assumes nothing has been clobbered. When a method's IL is rewritten instead, the JIT sees an ordinary unmanaged call at
+/// the start of the method and before each return, and only needs to preserve whatever is live at that point. As the address of the stub and
+/// the function record are embedded in the IL as constants, the call also doesn't go through the g_pEnterStub/g_pLeaveStub indirection.<para/>
+/// Short branches are always widened to their long forms, so that the inserted probes can't push a branch target out of range.
+/// </summary>
+class CILRewriter
+{
+public:
+    CILRewriter() :
+        m_Flags(0),
+        m_MaxStack(0),
+        m_LocalVarSigTok(mdTokenNil),
+        m_CodeSize(0),
+        m_NewCodeSize(0)
+    {
+    }
+
+    HRESULT Import(
+        _In_ LPCBYTE pMethodHeader,
+        _In_ ULONG cbMethodSize);
+
+    BOOL HasTailCalls();
+
+    ULONG GetExportSize();
+
+    void Export(
+        _In_ UINT_PTR clientId,
+        _In_ void* pEnterStub,
+        _In_ void* pLeaveStub,
+        _In_ mdSignature probeSig,
+        _Out_ BYTE* pMethodHeader);
+
+    //The signature of the hook stubs, i.e. void STDMETHODCALLTYPE (FunctionIDOrClientID)
+    static const BYTE ProbeSig[];
+    static const ULONG ProbeSigSize;
+
+private:
+    HRESULT ImportCode(
+        _In_ LPCBYTE pCode,
+        _In_ ULONG cbCode);
+
+    HRESULT ImportSections(_In_ LPCBYTE pSection, _In_ LPCBYTE pEnd);
+
+    ULONG GetNewSize(_In_ const ILInstruction& instr);
+
+    BYTE* WriteProbe(
+        _In_ BYTE* ptr,
+        _In_ UINT_PTR clientId,
+        _In_ void* pStub,
+        _In_ mdSignature probeSig);
+
+    BOOL IsInstructionStart(ULONG offset);
+
+    //Header
+
+    ULONG m_Flags;
+    ULONG m_MaxStack;
+    mdSignature m_LocalVarSigTok;
+    ULONG m_CodeSize;
+    ULONG m_NewCodeSize;
+
+    std::vector<ILInstruction> m_Instructions;
+    std::vector<IMAGE_COR_ILMETHOD_SECT_EH_CLAUSE_FAT> m_Clauses;
+
+    //Maps each offset in the original method body to the offset it will have after the method has been rewritten
+    std::vector<ULONG> m_OffsetMap;
+};
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "pch.h"
+#include "CIntervalThread.h"
+
+HRESULT CIntervalThread::Start(_In_ LPTHREAD_START_ROUTINE lpStartAddress, _In_ DWORD interval)
+{
+    HRESULT hr = S_OK;
+
+    m_lpStartAddress = lpStartAddress;
+    m_Interval = interval;
+
+    m_hStopEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    m_hWakeEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    m_hExitedEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+
+    if (m_hStopEvent == nullptr || m_hWakeEvent == nullptr || m_hExitedEvent == nullptr)
+    {
+        hr = HRESULT_FROM_WIN32(GetLastError());
+        goto ErrExit;
+    }
+
+    m_hThread = CreateThread(
+        nullptr,
+        0,
+        ThreadProc,
+        this,
+        0,
+        nullptr
+    );
+
+    if (m_hThread == nullptr)
+    {
+        hr = HRESULT_FROM_WIN32(GetLastError());
+        goto ErrExit;
+    }
+
+ErrExit:
+    if (FAILED(hr))
+        Stop();
+
+    return hr;
+}
+
+/// <summary>
+/// Signals the thread to stop and waits for it to finish its current unit of work. Does nothing if the thread was never started or has already been stopped.
+/// </summary>
+void CIntervalThread::Stop()
+{
+    if (m_hThread)
+    {
+        SetEvent(m_hStopEvent);
+
+        //We may be called while the loader lock is held (such as when the runtime shuts down during ExitProcess), in which case the thread
+        //can't finish exiting until we return. Waiting for it to return from its start routine is sufficient to know it won't perform any more work.
+        //If the thread has already been terminated, its handle will be signalled instead
+        HANDLE handles[] = { m_hExitedEvent, m_hThread };
+        WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+
+        CloseHandle(m_hThread);
+        m_hThread = nullptr;
+    }
+
+    if (m_hStopEvent)
+    {
+        CloseHandle(m_hStopEvent);
+        m_hStopEvent = nullptr;
+    }
+
+    if (m_hWakeEvent)
+    {
+        CloseHandle(m_hWakeEvent);
+        m_hWakeEvent = nullptr;
+    }
+
+    if (m_hExitedEvent)
+    {
+        CloseHandle(m_hExitedEvent);
+        m_hExitedEvent = nullptr;
+    }
+}
+
+DWORD WINAPI CIntervalThread::ThreadProc(LPVOID lpParameter)
+{
+    CIntervalThread* pThis = (CIntervalThread*)lpParameter;
+
+    DWORD result = pThis->m_lpStartAddress(nullptr);
+
+    SetEvent(pThis->m_hExitedEvent);
+
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+/// <summary>
+/// A background thread that performs some work at a fixed interval, or whenever it's woken, until it's stopped.<para/>
+/// Components whose thread writes events or calls into the runtime must stop it before the profiler's provider is unregistered
+/// or the profiler is detached, as otherwise the thread would continue to run against resources that no longer exist.
+/// </summary>
+class CIntervalThread
+{
+public:
+    CIntervalThread() :
+        m_lpStartAddress(nullptr),
+        m_Interval(0),
+        m_hThread(nullptr),
+        m_hStopEvent(nullptr),
+        m_hWakeEvent(nullptr),
+        m_hExitedEvent(nullptr)
+    {
+    }
+
+    HRESULT Start(_In_ LPTHREAD_START_ROUTINE lpStartAddress, _In_ DWORD interval);
+
+    /// <summary>
+    /// Waits for the next interval to elapse or for the thread to be woken. Called by the thread prior to each unit of work.
+    /// </summary>
+    /// <returns>TRUE if the interval elapsed or the thread was woken, or FALSE if the thread has been asked to stop.</returns>
+    BOOL Wait()
+    {
+        HANDLE handles[] = { m_hStopEvent, m_hWakeEvent };
+        DWORD result = WaitForMultipleObjects(2, handles, FALSE, m_Interval);
+
+        return result == WAIT_TIMEOUT || result == WAIT_OBJECT_0 + 1;
+    }
+
+    /// <summary>
+    /// Causes the thread to perform its work without waiting for the current interval to elapse.
+    /// </summary>
+    void Wake()
+    {
+        HANDLE hWakeEvent = m_hWakeEvent;
+
+        if (hWakeEvent)
+            SetEvent(hWakeEvent);
+    }
+
+    void Stop();
+
+private:
+    static DWORD WINAPI ThreadProc(LPVOID lpParameter);
+
+    LPTHREAD_START_ROUTINE m_lpStartAddress;
+    DWORD m_Interval;
+
+    HANDLE m_hThread;
+    HANDLE m_hStopEvent;
+    HANDLE m_hWakeEvent;
+
+    //Signalled once the thread has returned from m_lpStartAddress, and will no longer perform any work
+    HANDLE m_hExitedEvent;
+};
\ No newline at end of file
@@ -58,6 +58,21 @@ public:
 
         case MatchKind::Contains:
             return StrStrI(str, m_szValue) != NULL;
+
+        case MatchKind::StartsWith:
+            return StrCmpNI(str, m_szValue, lstrlenW(m_szValue)) == 0;
+
+        case MatchKind::EndsWith:
+        {
+            int strLength = lstrlenW(str);
+            int valueLength = lstrlenW(m_szValue);
+
+            return strLength >= valueLength && lstrcmpiW(str + strLength - valueLength, m_szValue) == 0;
+        }
+
+        case MatchKind::Literal:
+            return lstrcmpiW(m_szValue, str) == 0;
+
         default:
             break;
         }
@@ -0,0 +1,142 @@
+#include "pch.h"
+#include "CPInvokeStats.h"
+#include "Events.h"
+
+BOOL g_PInvokeStatsEnabled = FALSE;
+
+LONGLONG CPInvokeStats::s_Frequency = 0;
+
+std::unordered_map<FunctionID, PInvokeHistogram*> CPInvokeStats::s_Histograms;
+std::shared_mutex CPInvokeStats::s_HistogramsMutex;
+
+//Each histogram is serialized as its FunctionID, call count, total duration in nanoseconds and each of its buckets
+#define PINVOKE_STATS_SIZE (sizeof(UINT64) * (3 + PINVOKE_HISTOGRAM_BUCKETS))
+#define MAX_PINVOKE_STATS (VALUE_BUFFER_SIZE / PINVOKE_STATS_SIZE)
+
+#define NS_PER_SECOND 1000000000
+#define US_PER_SECOND 1000000
+
+HRESULT CPInvokeStats::Initialize()
+{
+    g_PInvokeStatsEnabled = GetBoolEnv("DEBUGTOOLS_PINVOKE_STATS");
+
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    s_Frequency = frequency.QuadPart;
+
+    return S_OK;
+}
+
+/// <summary>
+/// Records the duration of a call to an unmanaged function that is about to return to managed code. Must be called before the
+/// frame of the call is popped from the shadow stack.
+/// </summary>
+void CPInvokeStats::Return(_In_ CThreadContext* pContext, _In_ FunctionID functionId)
+{
+    //If we started tracing partway through the call, we won't know when it began
+    if (pContext->CallStack.empty())
+        return;
+
+    const Frame& frame = pContext->CallStack.top();
+
+    if (frame.FunctionId != functionId || frame.Kind != FrameKind::M2U || frame.EnterQPC == 0)
+        return;
+
+    LARGE_INTEGER qpc;
+    QueryPerformanceCounter(&qpc);
+
+    LONG64 duration = qpc.QuadPart - frame.EnterQPC;
+    LONG64 microseconds = duration * US_PER_SECOND / s_Frequency;
+
+    ULONG bucket = 0;
+
+    if (microseconds > 0)
+    {
+        ULONG index;
+        _BitScanReverse64(&index, (ULONG64)microseconds);
+
+        bucket = index + 1 < PINVOKE_HISTOGRAM_BUCKETS ? index + 1 : PINVOKE_HISTOGRAM_BUCKETS - 1;
+    }
+
+    PInvokeHistogram* pHistogram = GetHistogram(pContext, functionId);
+
+    InterlockedIncrement64(&pHistogram->CallCount);
+    InterlockedAdd64(&pHistogram->TotalDuration, duration);
+    InterlockedIncrement64(&pHistogram->Buckets[bucket]);
+}
+
+/// <summary>
+/// Retrieves the histogram of an unmanaged function. Each thread caches the histograms it has used, so that the lock guarding
+/// the set of all histograms is only taken the first time a thread calls each function.
+/// </summary>
+PInvokeHistogram* CPInvokeStats::GetHistogram(_In_ CThreadContext* pContext, _In_ FunctionID functionId)
+{
+    auto cached = pContext->PInvokeHistograms.find(functionId);
+
+    if (cached != pContext->PInvokeHistograms.end())
+        return cached->second;
+
+    PInvokeHistogram* pHistogram;
+
+    //Lock scope
+    {
+        CLock histogramsLock(&s_HistogramsMutex, true);
+
+        auto match = s_Histograms.find(functionId);
+
+        if (match == s_Histograms.end())
+        {
+            pHistogram = new PInvokeHistogram();
+            pHistogram->FunctionId = functionId;
+
+            s_Histograms[functionId] = pHistogram;
+        }
+        else
+            pHistogram = match->second;
+    }
+
+    pContext->PInvokeHistograms[functionId] = pHistogram;
+
+    return pHistogram;
+}
+
+/// <summary>
+/// Writes one or more PInvokeStatsEvents containing the histogram of every unmanaged function that has been called so far.
+/// The last event is marked as final.
+/// </summary>
+void CPInvokeStats::WritePInvokeStats()
+{
+    HRESULT hr = S_OK;
+    CThreadContext* pContext = GetThreadContext();
+
+    //This is only ever called from the pipe thread or on shutdown, neither of which otherwise use their value buffer at the same time
+    UINT64* ptr = (UINT64*)pContext->ValueBuffer;
+    ULONG count = 0;
+
+    CLock histogramsLock(&s_HistogramsMutex);
+
+    for (auto& kv : s_Histograms)
+    {
+        PInvokeHistogram* pHistogram = kv.second;
+        LONG64 duration = pHistogram->TotalDuration;
+
+        *ptr++ = pHistogram->FunctionId;
+        *ptr++ = pHistogram->CallCount;
+
+        //Split the conversion so that long durations don't overflow
+        *ptr++ = (duration / s_Frequency) * NS_PER_SECOND + (duration % s_Frequency) * NS_PER_SECOND / s_Frequency;
+
+        for (ULONG i = 0; i < PINVOKE_HISTOGRAM_BUCKETS; i++)
+            *ptr++ = pHistogram->Buckets[i];
+
+        if (++count == MAX_PINVOKE_STATS)
+        {
+            ValidateETW(EventWritePInvokeStatsEvent(FALSE, (ULONG)(count * PINVOKE_STATS_SIZE), pContext->ValueBuffer));
+
+            ptr = (UINT64*)pContext->ValueBuffer;
+            count = 0;
+        }
+    }
+
+    ValidateETW(EventWritePInvokeStatsEvent(TRUE, (ULONG)(count * PINVOKE_STATS_SIZE), pContext->ValueBuffer));
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <unordered_map>
+#include "CThreadContext.h"
+
+extern BOOL g_PInvokeStatsEnabled;
+
+//Bucket 0 counts calls that took less than a microsecond. Each bucket after that counts calls that took [2^(n-1), 2^n) microseconds,
+//with the last bucket also counting any calls that took longer
+#define PINVOKE_HISTOGRAM_BUCKETS 32
+
+typedef struct PInvokeHistogram {
+    FunctionID FunctionId;
+    volatile LONG64 CallCount;
+    volatile LONG64 TotalDuration;
+    volatile LONG64 Buckets[PINVOKE_HISTOGRAM_BUCKETS];
+} PInvokeHistogram;
+
+/// <summary>
+/// Accumulates a histogram of how long the calls to each unmanaged function took, measured from the managed to unmanaged
+/// transition at the start of each call to the transition back to managed code when it returns.<para/>
+/// Histograms are only written when requested by the client or when the process shuts down, so measuring P/Invoke latency does not
+/// require any transition events to be streamed.
+/// </summary>
+class CPInvokeStats
+{
+public:
+    static HRESULT Initialize();
+
+    FORCEINLINE static void Call(_In_ Frame& frame)
+    {
+        QueryPerformanceCounter((LARGE_INTEGER*)&frame.EnterQPC);
+    }
+
+    static void Return(_In_ CThreadContext* pContext, _In_ FunctionID functionId);
+
+    static void WritePInvokeStats();
+
+private:
+    static PInvokeHistogram* GetHistogram(_In_ CThreadContext* pContext, _In_ FunctionID functionId);
+
+    static LONGLONG s_Frequency;
+
+    static std::unordered_map<FunctionID, PInvokeHistogram*> s_Histograms;
+    static std::shared_mutex s_HistogramsMutex;
+};
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include "pch.h"
+#include "CSampler.h"
+#include "CStackTable.h"
+#include "CValueTracer.h"
+#include "Events.h"
+
+BOOL g_SamplingEnabled = FALSE;
+BOOL g_OffCpuEnabled = FALSE;
+
+DWORD CSampler::s_Interval = 0;
+CIntervalThread CSampler::s_Thread;
+ULONG64 CSampler::s_LastTimestamp = 0;
+LONGLONG CSampler::s_LastQPC = 0;
+LONGLONG CSampler::s_Frequency = 0;
+
+#define MAX_SAMPLES (VALUE_BUFFER_SIZE / sizeof(StackSample))
+
+HRESULT CSampler::Initialize()
+{
+    HRESULT hr = S_OK;
+
+    if (!GetIntSetting("DEBUGTOOLS_SAMPLEINTERVAL", &s_Interval) || s_Interval == 0)
+        goto ErrExit;
+
+    //Must be set before any thread creates its context, so that every thread publishes its stack
+    g_SamplingEnabled = TRUE;
+    g_OffCpuEnabled = GetBoolEnv("DEBUGTOOLS_OFFCPU");
+
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    s_Frequency = frequency.QuadPart;
+
+    IfFailGo(s_Thread.Start(SamplerThreadProc, s_Interval));
+
+ErrExit:
+    return hr;
+}
+
+void CSampler::Shutdown()
+{
+    s_Thread.Stop();
+}
+
+DWORD WINAPI CSampler::SamplerThreadProc(LPVOID lpParameter)
+{
+    //Contexts can't be created while we're enumerating the contexts of other threads, so create ours up front
+    CThreadContext* pContext = GetThreadContext();
+
+    PublishedFrame* pFrames = new PublishedFrame[MAX_PUBLISHED_FRAMES];
+    std::vector<StackSample> samples;
+
+    while (s_Thread.Wait())
+    {
+        if (g_TracingEnabled)
+            Sample(pContext, pFrames, samples);
+    }
+
+    delete[] pFrames;
+
+    return 0;
+}
+
+void CSampler::Sample(
+    _In_ CThreadContext* pSamplerContext,
+    _In_ PublishedFrame* pFrames,
+    _Inout_ std::vector<StackSample>& samples)
+{
+    HRESULT hr = S_OK;
+
+    samples.clear();
+
+    LARGE_INTEGER qpc;
+    QueryPerformanceCounter(&qpc);
+
+    ULONG64 timestamp = ReadTimeStampCounter();
+    ULONG64 elapsedCycles = s_LastTimestamp == 0 ? 0 : timestamp - s_LastTimestamp;
+    ULONG64 elapsedTime = s_LastQPC == 0 ? 0 : (qpc.QuadPart - s_LastQPC) * 1000000 / s_Frequency;
+    s_LastTimestamp = timestamp;
+    s_LastQPC = qpc.QuadPart;
+
+    CThreadContext::ForEach([&](CThreadContext* pContext)
+    {
+        //Every thread's cycles must be read, even if it isn't sampled this time, so that its next sample is measured against the right interval
+        ULONG offCpuTime = g_OffCpuEnabled ? GetOffCpuTime(pContext, elapsedCycles, elapsedTime) : 0;
+
+        const CPublishedStack* pPublished = pContext->CallStack.Published();
+
+        if (pPublished == nullptr || samples.size() >= MAX_SAMPLES)
+            return;
+
+        size_t depth;
+        UINT64 stackHash;
+
+        //Threads that aren't inside any hooked function have an empty stack, and aren't included in the sample
+        if (!pPublished->TryRead(&depth, &stackHash, pFrames) || stackHash == 0)
+            return;
+
+        //The sampler thread never traces any values, so its value buffer is always free
+        ULONG cbFrames = SerializeFrames(pFrames, min(depth, MAX_PUBLISHED_FRAMES), pSamplerContext->ValueBuffer);
+
+        ULONG stackId = CStackTable::GetStackId(stackHash, cbFrames, pSamplerContext->ValueBuffer);
+
+        samples.push_back({ pContext->ThreadId, stackId, offCpuTime });
+    });
+
+    if (samples.empty())
+        return;
+
+    ValidateETW(EventWriteStackSampleEvent((ULONG)(samples.size() * sizeof(StackSample)), (const BYTE*)samples.data()));
+}
+
+/// <summary>
+/// Determines how long a thread spent switched out during the interval since the previous sample.<para/>
+/// The thread cycle time reported by the OS is measured in timestamp counter ticks, so the fraction of the interval the thread
+/// ran for can be determined by comparing it against the timestamp counter, without knowing the frequency of the processor.
+/// </summary>
+/// <returns>The time in microseconds the thread was not running for, or 0 if it can't be determined.</returns>
+ULONG CSampler::GetOffCpuTime(
+    _In_ CThreadContext* pContext,
+    _In_ ULONG64 elapsedCycles,
+    _In_ ULONG64 elapsedTime)
+{
+    ULONG64 cycles;
+
+    if (pContext->ThreadHandle == nullptr || !QueryThreadCycleTime(pContext->ThreadHandle, &cycles))
+        return 0;
+
+    ULONG64 lastCycles = pContext->SampledCycles;
+    pContext->SampledCycles = cycles;
+
+    //We don't know how long the thread ran for prior to the first time we saw it
+    if (lastCycles == 0 || elapsedCycles == 0)
+        return 0;
+
+    ULONG64 threadCycles = cycles - lastCycles;
+
+    //The timestamp counter and the thread's cycle time aren't read at exactly the same moment, so a thread that ran
+    //for the entire interval may appear to have consumed slightly more cycles than elapsed
+    if (threadCycles >= elapsedCycles)
+        return 0;
+
+    //The interval may be arbitrarily long if tracing was disabled since the previous sample, so avoid overflowing the multiplication
+    ULONG64 onCpuTime = (ULONG64)((double)elapsedTime * threadCycles / elapsedCycles);
+
+    return (ULONG)min(elapsedTime - onCpuTime, ULONG_MAX);
+}
+
+/// <summary>
+/// Serializes published frames in the same format as <see cref="CCallStackSnapshot::SerializeFrames"/>.
+/// </summary>
+/// <returns>The number of bytes that were written to the buffer.</returns>
+ULONG CSampler::SerializeFrames(
+    _In_ PublishedFrame* pFrames,
+    _In_ size_t numFrames,
+    _Out_ BYTE* buffer)
+{
+    BYTE* ptr = buffer;
+
+    for (size_t i = 0; i < numFrames; i++)
+    {
+        if (pFrames[i].Suppressed)
+            continue;
+
+        UINT64 functionId = pFrames[i].FunctionId;
+        INT32 kind = (INT32)pFrames[i].Kind;
+
+        memcpy(ptr, &functionId, sizeof(UINT64));
+        ptr += sizeof(UINT64);
+
+        memcpy(ptr, &kind, sizeof(INT32));
+        ptr += sizeof(INT32);
+    }
+
+    return (ULONG)(ptr - buffer);
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <vector>
+#include "CIntervalThread.h"
+
+extern BOOL g_SamplingEnabled;
+extern BOOL g_OffCpuEnabled;
+
+struct CThreadContext;
+struct PublishedFrame;
+
+typedef struct StackSample {
+    DWORD ThreadId;
+    ULONG StackId;
+
+    //The time (in microseconds) the thread spent switched out during the interval leading up to the sample. Only measured when off-CPU sampling is enabled
+    ULONG OffCpuTime;
+} StackSample;
+
+/// <summary>
+/// Periodically samples the shadow stack of every thread, producing a statistical wall clock profile without writing any per-call events.<para/>
+/// When sampling is enabled, each thread publishes its shadow stack to a <see cref="CPublishedStack"/> and the hooks stop writing call events.
+/// At each interval, the sampler thread reads every published stack without suspending its thread, interns it via <see cref="CStackTable"/>
+/// and writes a single StackSampleEvent containing the stack of every thread that was inside a hooked function.<para/>
+/// When off-CPU sampling is enabled, the sampler also compares the cycles each thread consumed since the previous sample against the cycles
+/// that elapsed on the processor. The portion of the interval the thread didn't run for is reported with its sample,
+/// attributing the time it spent switched out to the frame that was current on its shadow stack.
+/// </summary>
+class CSampler
+{
+public:
+    static HRESULT Initialize();
+    static void Shutdown();
+
+private:
+    static DWORD WINAPI SamplerThreadProc(LPVOID lpParameter);
+
+    static void Sample(
+        _In_ CThreadContext* pSamplerContext,
+        _In_ PublishedFrame* pFrames,
+        _Inout_ std::vector<StackSample>& samples);
+
+    static ULONG GetOffCpuTime(
+        _In_ CThreadContext* pContext,
+        _In_ ULONG64 elapsedCycles,
+        _In_ ULONG64 elapsedTime);
+
+    static ULONG SerializeFrames(
+        _In_ PublishedFrame* pFrames,
+        _In_ size_t numFrames,
+        _Out_ BYTE* buffer);
+
+    static DWORD s_Interval;
+    static CIntervalThread s_Thread;
+
+    //The value of the processor's timestamp counter and the QPC when the previous sample was taken
+    static ULONG64 s_LastTimestamp;
+    static LONGLONG s_LastQPC;
+
+    static LONGLONG s_Frequency;
+};
\ No newline at end of file
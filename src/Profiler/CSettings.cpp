@@ -0,0 +1,100 @@
+#include "pch.h"
+#include "CSettings.h"
+#include <string>
+#include <unordered_map>
+
+BOOL CSettings::s_Attached = FALSE;
+
+//The settings that were passed as client data. Only used when the profiler was attached
+static std::unordered_map<std::string, std::string> s_Settings;
+
+/// <summary>
+/// Stores the settings that were passed to the profiler when it was attached. Once called, settings are no longer read from the environment.
+/// </summary>
+/// <param name="pvClientData">A block of NAME=VALUE strings. Each string is null terminated, with the block ending in an additional null terminator.</param>
+/// <param name="cbClientData">The size of the block pointed to by pvClientData.</param>
+void CSettings::LoadClientData(_In_reads_bytes_(cbClientData) const void* pvClientData, _In_ UINT cbClientData)
+{
+    const char* pCurrent = (const char*)pvClientData;
+    const char* pEnd = pCurrent + cbClientData;
+
+    while (pCurrent && pCurrent < pEnd && *pCurrent)
+    {
+        std::string entry(pCurrent, strnlen(pCurrent, pEnd - pCurrent));
+
+        size_t separator = entry.find('=');
+
+        if (separator != std::string::npos)
+            s_Settings[entry.substr(0, separator)] = entry.substr(separator + 1);
+
+        pCurrent += entry.length() + 1;
+    }
+
+    s_Attached = TRUE;
+}
+
+DWORD CSettings::GetA(_In_ LPCSTR lpName, _Out_writes_to_opt_(nSize, return + 1) LPSTR lpBuffer, _In_ DWORD nSize)
+{
+    if (!s_Attached)
+        return GetEnvironmentVariableA(lpName, lpBuffer, nSize);
+
+    auto match = s_Settings.find(lpName);
+
+    if (match == s_Settings.end())
+    {
+        SetLastError(ERROR_ENVVAR_NOT_FOUND);
+        return 0;
+    }
+
+    const std::string& value = match->second;
+
+    //If the buffer is too small, the required size includes the null terminator
+    if (lpBuffer == nullptr || value.length() >= nSize)
+        return (DWORD)value.length() + 1;
+
+    memcpy(lpBuffer, value.c_str(), value.length() + 1);
+
+    return (DWORD)value.length();
+}
+
+DWORD CSettings::GetW(_In_ LPCWSTR lpName, _Out_writes_to_opt_(nSize, return + 1) LPWSTR lpBuffer, _In_ DWORD nSize)
+{
+    if (!s_Attached)
+        return GetEnvironmentVariableW(lpName, lpBuffer, nSize);
+
+    //Setting names are always ASCII
+    std::string name;
+
+    for (LPCWSTR ch = lpName; *ch; ch++)
+        name.push_back((char)*ch);
+
+    auto match = s_Settings.find(name);
+
+    if (match == s_Settings.end())
+    {
+        SetLastError(ERROR_ENVVAR_NOT_FOUND);
+        return 0;
+    }
+
+    const std::string& value = match->second;
+
+    if (value.empty())
+    {
+        if (lpBuffer == nullptr || nSize == 0)
+            return 1;
+
+        lpBuffer[0] = L'\0';
+        return 0;
+    }
+
+    //The client data was written in the same code page that SetEnvironmentVariableA would have interpreted it in
+    int length = MultiByteToWideChar(CP_ACP, 0, value.c_str(), (int)value.length(), NULL, 0);
+
+    if (lpBuffer == nullptr || (DWORD)length >= nSize)
+        return length + 1;
+
+    MultiByteToWideChar(CP_ACP, 0, value.c_str(), (int)value.length(), lpBuffer, length);
+    lpBuffer[length] = L'\0';
+
+    return length;
+}
\ No newline at end of file
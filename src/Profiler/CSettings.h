@@ -0,0 +1,25 @@
+#pragma once
+
+/// <summary>
+/// Provides access to the DEBUGTOOLS_* settings the profiler was started with.<para/>
+/// When the profiler is launched with the target process, its settings are read from the environment. When the profiler is attached
+/// to a process that is already running, the settings are instead passed as client data, and are stored here rather than being written
+/// to the environment of the target process, where they would be inherited by any child processes it creates and outlive the profiler.
+/// </summary>
+class CSettings
+{
+public:
+    static void LoadClientData(_In_reads_bytes_(cbClientData) const void* pvClientData, _In_ UINT cbClientData);
+
+    //These behave the same as GetEnvironmentVariableA/GetEnvironmentVariableW
+
+    static DWORD GetA(_In_ LPCSTR lpName, _Out_writes_to_opt_(nSize, return + 1) LPSTR lpBuffer, _In_ DWORD nSize);
+    static DWORD GetW(_In_ LPCWSTR lpName, _Out_writes_to_opt_(nSize, return + 1) LPWSTR lpBuffer, _In_ DWORD nSize);
+
+private:
+    static BOOL s_Attached;
+};
+
+#define GetSettingA CSettings::GetA
+#define GetSettingW CSettings::GetW
+#define GetSetting CSettings::GetW
\ No newline at end of file
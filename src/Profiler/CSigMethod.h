@@ -3,6 +3,8 @@
 #include "CSigType.h"
 #include "CUnknown.h"
 #include "ISigParameter.h"
+#include "CValuePredicate.h"
+#include <vector>
 
 class IClassInfo;
 
@@ -72,6 +74,9 @@ public:
     LPWSTR* m_GenericTypeArgNames;
 
     ModuleID m_ModuleID;
+
+    //The value predicates (if any) that apply to the parameters of this method. Each predicate is owned by CValueTracer
+    std::vector<BoundValuePredicate> m_ValuePredicates;
 };
 
 class CSigMethodRef : public CSigMethod
@@ -0,0 +1,224 @@
+#include "pch.h"
+#include "CSlowCallCapture.h"
+#include "CHookCalibrator.h"
+#include "CValueTracer.h"
+#include "Events.h"
+
+BOOL g_SlowCallCaptureEnabled = FALSE;
+
+BOOL CSlowCallCapture::s_UseTriggers = FALSE;
+LONGLONG CSlowCallCapture::s_Threshold = 0;
+LONGLONG CSlowCallCapture::s_Frequency = 0;
+
+//Each buffered event is stored as the descriptor it was written with, followed by the header and payload it would have in the memory mapped file
+typedef struct SlowCallRecordHeader {
+    PCEVENT_DESCRIPTOR EventDescriptor;
+    MMFEventHeader Header;
+} SlowCallRecordHeader;
+
+#define TICKS_PER_SECOND 10000000
+
+HRESULT CSlowCallCapture::Initialize()
+{
+    LARGE_INTEGER frequency;
+    long threshold;
+
+    if (!GetIntSetting("DEBUGTOOLS_SLOW_CALL_THRESHOLD", &threshold))
+        return S_OK;
+
+    if (threshold <= 0)
+        return E_INVALIDARG;
+
+    QueryPerformanceFrequency(&frequency);
+    s_Frequency = frequency.QuadPart;
+    s_Threshold = threshold * s_Frequency / 1000;
+
+    //The triggers themselves are matched by RecordFunction
+    s_UseTriggers = GetSettingA("DEBUGTOOLS_SLOW_CALL_TRIGGERS", NULL, 0) != 0;
+
+    g_SlowCallCaptureEnabled = TRUE;
+
+    return S_OK;
+}
+
+/// <summary>
+/// Starts capturing the subtree of a frame that has just been pushed onto the shadow stack, if it's a frame that captures should start at.
+/// Must be called before the event for the frame being entered is written.
+/// </summary>
+void CSlowCallCapture::Enter(_In_ CThreadContext* pContext, _In_ CFunctionRecord* pRecord)
+{
+    size_t depth = pContext->CallStack.size();
+
+    if (pContext->SlowCallDepth != 0)
+    {
+        //Any frames entered beneath the captured frame are part of its subtree, including other triggers
+        if (depth > pContext->SlowCallDepth)
+            return;
+
+        //The captured frame was left without its capture being completed
+        Complete(pContext);
+    }
+
+    if (!g_TracingEnabled)
+        return;
+
+    if (s_UseTriggers)
+    {
+        if (!pRecord->m_SlowCallTrigger)
+            return;
+    }
+    else
+    {
+        //A root call is a managed frame that was called from unmanaged code, such as a thread's entry point or a callback
+        if (depth > 1 && pContext->CallStack.Frames()[depth - 2].Kind != FrameKind::U2M)
+            return;
+    }
+
+    LARGE_INTEGER qpc;
+    QueryPerformanceCounter(&qpc);
+
+    pContext->SlowCallDepth = depth;
+    pContext->SlowCallEnterQPC = qpc.QuadPart;
+    pContext->SlowCallEnterSequence = pContext->Sequence;
+}
+
+ULONG CSlowCallCapture::Write(
+    _In_ REGHANDLE RegHandle,
+    _In_ PCEVENT_DESCRIPTOR EventDescriptor,
+    _In_opt_ LPCGUID ActivityId,
+    _In_opt_ LPCGUID RelatedActivityId,
+    _In_range_(0, MAX_EVENT_DATA_DESCRIPTORS) ULONG UserDataCount,
+    _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData)
+{
+    //Everything other than call and exception events is sent to the client as normal
+    if (!(EventDescriptor->Keyword & (CallKeyword | ExceptionKeyword)))
+    {
+        if (g_IsETW)
+            return EventWriteTransfer(RegHandle, EventDescriptor, ActivityId, RelatedActivityId, UserDataCount, UserData);
+        else
+            return EventWriteMMF(EventDescriptor, UserDataCount, UserData);
+    }
+
+    return Write(GetThreadContext(), EventDescriptor, UserDataCount, UserData);
+}
+
+/// <summary>
+/// Buffers a call or exception event of the specified thread's current capture. Used directly by the hook stubs,
+/// which already have the context of the thread and know the event belongs to the capture.
+/// </summary>
+ULONG CSlowCallCapture::Write(
+    _In_ CThreadContext* pContext,
+    _In_ PCEVENT_DESCRIPTOR EventDescriptor,
+    _In_range_(0, MAX_EVENT_DATA_DESCRIPTORS) ULONG UserDataCount,
+    _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData)
+{
+    if (pContext->SlowCallDepth == 0 || pContext->SlowCallOverflowed)
+        return ERROR_SUCCESS;
+
+    LARGE_INTEGER qpc;
+    QueryPerformanceCounter(&qpc);
+
+    DWORD userDataSize = 0;
+
+    for (ULONG i = 1; i < UserDataCount; i++)
+        userDataSize += UserData[i].Size;
+
+    std::vector<BYTE>& buffer = pContext->SlowCallBuffer;
+    size_t offset = buffer.size();
+
+    if (offset + sizeof(SlowCallRecordHeader) + userDataSize > SLOW_CALL_MAX_BUFFER_SIZE)
+    {
+        //Committing only part of the subtree would leave the client with unbalanced frames, so the whole capture is abandoned
+        pContext->SlowCallOverflowed = TRUE;
+        buffer.clear();
+        buffer.shrink_to_fit();
+
+        return ERROR_SUCCESS;
+    }
+
+    buffer.resize(offset + sizeof(SlowCallRecordHeader) + userDataSize);
+
+    SlowCallRecordHeader* pRecord = (SlowCallRecordHeader*)(buffer.data() + offset);
+    pRecord->EventDescriptor = EventDescriptor;
+    pRecord->Header = { qpc.QuadPart, pContext->ThreadId, userDataSize, EventDescriptor->Id };
+
+    BYTE* ptr = (BYTE*)(pRecord + 1);
+
+    for (ULONG i = 1; i < UserDataCount; i++)
+    {
+        memcpy(ptr, (void*)UserData[i].Ptr, UserData[i].Size);
+        ptr += UserData[i].Size;
+    }
+
+    return ERROR_SUCCESS;
+}
+
+void CSlowCallCapture::Complete(_In_ CThreadContext* pContext)
+{
+    LARGE_INTEGER qpc;
+    QueryPerformanceCounter(&qpc);
+
+    LONGLONG duration = qpc.QuadPart - pContext->SlowCallEnterQPC;
+
+    //Each call beneath the captured frame incremented the thread's sequence once when it was entered and once when it was left,
+    //and the captured frame itself once when it was left. Remove the cost of the hooks that ran for each of those calls
+    ULONG descendantCalls = (pContext->Sequence - pContext->SlowCallEnterSequence) / 2;
+    LONGLONG overhead = (LONGLONG)(descendantCalls * CHookCalibrator::s_CompensatedQPC / HOOK_OVERHEAD_QPC_SCALE);
+    duration = duration > overhead ? duration - overhead : 0;
+
+    if (!pContext->SlowCallOverflowed && duration >= s_Threshold)
+        Commit(pContext, duration);
+
+    pContext->SlowCallDepth = 0;
+    pContext->SlowCallOverflowed = FALSE;
+
+    //Keep the buffer's capacity so that the next capture doesn't need to reallocate it
+    pContext->SlowCallBuffer.clear();
+}
+
+/// <summary>
+/// Transfers the events captured for a slow call to the client, preceded by a SlowCallEvent. As the events of the calls the thread made
+/// before this one were discarded, the SlowCallEvent informs the client that the events that follow won't line up with those it has
+/// previously seen for the thread.
+/// </summary>
+void CSlowCallCapture::Commit(_In_ CThreadContext* pContext, _In_ LONGLONG duration)
+{
+    HRESULT hr = S_OK;
+
+    //Split the conversion so that long durations don't overflow
+    ULONGLONG ticks = (duration / s_Frequency) * TICKS_PER_SECOND + (duration % s_Frequency) * TICKS_PER_SECOND / s_Frequency;
+
+    ValidateETW(EventWriteSlowCallEvent(ticks));
+
+    std::vector<BYTE>& buffer = pContext->SlowCallBuffer;
+    size_t offset = 0;
+
+    while (offset < buffer.size())
+    {
+        SlowCallRecordHeader* pRecord = (SlowCallRecordHeader*)(buffer.data() + offset);
+        DWORD userDataSize = pRecord->Header.UserDataSize;
+
+        if (g_IsETW)
+        {
+            //The payload was flattened when it was buffered, which ETW can't tell apart from the original data descriptors
+            EVENT_DATA_DESCRIPTOR EventData[2];
+
+            EventDataDescCreateTraits(&EventData[0]);
+            EventDataDescCreate(&EventData[1], pRecord + 1, userDataSize);
+
+            ValidateETW(EventWriteTransfer(DebugToolsProfilerHandle, pRecord->EventDescriptor, NULL, NULL, 2, EventData));
+        }
+        else
+        {
+            //Preserve the time the event was originally written at
+            DWORD recordSize = sizeof(MMFEventHeader) + userDataSize;
+            void* pMMFRecord = malloc(recordSize);
+
+            memcpy(pMMFRecord, &pRecord->Header, recordSize);
+
+            EnqueueMMFRecord({ recordSize, pMMFRecord });
+        }
+
+        offset += sizeof(SlowCallRecordHeader) + userDataSize;
+    }
+}
\ No newline at end of file
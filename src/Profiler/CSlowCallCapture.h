@@ -0,0 +1,69 @@
+#pragma once
+
+#include "CThreadContext.h"
+#include "CFunctionRecord.h"
+
+extern BOOL g_SlowCallCaptureEnabled;
+
+//The most bytes of events a single thread will buffer for a call. If a call generates more than this, it's abandoned rather than
+//growing the buffer without bound
+#define SLOW_CALL_MAX_BUFFER_SIZE (16 * 1024 * 1024)
+
+/// <summary>
+/// Captures the events of slow calls at full fidelity, without paying to transfer the events of every other call.<para/>
+/// When a thread enters a root call (a managed frame called from unmanaged code) or a function matching DEBUGTOOLS_SLOW_CALL_TRIGGERS,
+/// the call and exception events of its entire subtree are serialized into a buffer belonging to the thread. When the frame is left,
+/// the subtree is transferred to the client if the call took longer than the threshold, and discarded otherwise. Call events written
+/// outside of a captured subtree are discarded immediately.
+/// </summary>
+class CSlowCallCapture
+{
+public:
+    static HRESULT Initialize();
+
+    static void Enter(_In_ CThreadContext* pContext, _In_ CFunctionRecord* pRecord);
+
+    /// <summary>
+    /// Completes the capture in progress on the current thread if the frame it was started for has been left. Must be called after the
+    /// event for the frame being left has been written.
+    /// </summary>
+    FORCEINLINE static void Leave(_In_ CThreadContext* pContext)
+    {
+        if (pContext->SlowCallDepth != 0 && pContext->CallStack.size() < pContext->SlowCallDepth)
+            Complete(pContext);
+    }
+
+    /// <summary>
+    /// Completes the capture in progress on the current thread, if any, regardless of whether the frame it was started for has been left.
+    /// Called when the thread is exiting, as it won't call any more functions that would complete the capture.
+    /// </summary>
+    FORCEINLINE static void Flush(_In_ CThreadContext* pContext)
+    {
+        if (pContext->SlowCallDepth != 0)
+            Complete(pContext);
+    }
+
+    static ULONG Write(
+        _In_ REGHANDLE RegHandle,
+        _In_ PCEVENT_DESCRIPTOR EventDescriptor,
+        _In_opt_ LPCGUID ActivityId,
+        _In_opt_ LPCGUID RelatedActivityId,
+        _In_range_(0, MAX_EVENT_DATA_DESCRIPTORS) ULONG UserDataCount,
+        _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData);
+
+    static ULONG Write(
+        _In_ CThreadContext* pContext,
+        _In_ PCEVENT_DESCRIPTOR EventDescriptor,
+        _In_range_(0, MAX_EVENT_DATA_DESCRIPTORS) ULONG UserDataCount,
+        _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData);
+
+    //Whether captures are started by functions matching DEBUGTOOLS_SLOW_CALL_TRIGGERS rather than by root calls
+    static BOOL s_UseTriggers;
+
+private:
+    static void Complete(_In_ CThreadContext* pContext);
+    static void Commit(_In_ CThreadContext* pContext, _In_ LONGLONG duration);
+
+    static LONGLONG s_Threshold;
+    static LONGLONG s_Frequency;
+};
\ No newline at end of file
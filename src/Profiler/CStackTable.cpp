@@ -0,0 +1,89 @@
+#include "pch.h"
+#include "CStackTable.h"
+#include "Events.h"
+
+std::unordered_multimap<UINT64, StackEntry> CStackTable::s_Stacks;
+std::shared_mutex CStackTable::s_StacksMutex;
+
+//Stack ID 0 is reserved for the empty stack, which is never defined
+ULONG CStackTable::s_NextStackId = 1;
+
+/// <summary>
+/// Gets the ID of a stack, assigning it a new ID and writing a StackDefinedEvent describing its frames if it hasn't been seen before.
+/// </summary>
+/// <param name="stackHash">The hash of the stack, as stored in the innermost frame of the stack.</param>
+/// <param name="cbFrames">The length of the serialized frames.</param>
+/// <param name="pFrames">The frames of the stack, serialized by <see cref="CCallStackSnapshot::SerializeFrames"/>.</param>
+/// <returns>The ID of the stack.</returns>
+ULONG CStackTable::GetStackId(
+    _In_ UINT64 stackHash,
+    _In_ ULONG cbFrames,
+    _In_reads_bytes_(cbFrames) const BYTE* pFrames)
+{
+    HRESULT hr = S_OK;
+    ULONG stackId;
+
+    //Lock scope
+    {
+        CLock stacksLock(&s_StacksMutex);
+
+        if (TryFindStack(stackHash, cbFrames, pFrames, &stackId))
+            return stackId;
+    }
+
+    CLock stacksLock(&s_StacksMutex, true);
+
+    //Another thread may have defined the same stack in the meantime
+    if (TryFindStack(stackHash, cbFrames, pFrames, &stackId))
+        return stackId;
+
+    stackId = s_NextStackId++;
+
+    s_Stacks.emplace(stackHash, StackEntry{ stackId, std::vector<BYTE>(pFrames, pFrames + cbFrames) });
+
+    //The definition is written while we still hold the lock, so that no other thread can write an event that refers to the stack
+    //before it has been defined. It goes straight to the transport; if it were held back by the flight recorder or a slow call
+    //capture and then discarded, any events that were transferred would refer to a stack the client never saw
+    if (MCGEN_EVENT_ENABLED(StackDefinedEvent))
+    {
+        EVENT_DATA_DESCRIPTOR EventData[4];
+
+        EventDataDescCreateTraits(&EventData[0]);
+        EventDataDescCreate(&EventData[1], &stackId, sizeof(ULONG));
+        EventDataDescCreate(&EventData[2], &cbFrames, sizeof(ULONG));
+        EventDataDescCreate(&EventData[3], pFrames, cbFrames);
+
+        if (g_IsETW)
+            ValidateETW(EventWriteTransfer(DebugToolsProfilerHandle, &StackDefinedEvent, NULL, NULL, 4, EventData));
+        else
+            ValidateETW(EventWriteMMF(&StackDefinedEvent, 4, EventData));
+    }
+
+    return stackId;
+}
+
+/// <summary>
+/// Finds the stack with the specified hash and frames. Must be called while holding s_StacksMutex.
+/// </summary>
+BOOL CStackTable::TryFindStack(
+    _In_ UINT64 stackHash,
+    _In_ ULONG cbFrames,
+    _In_reads_bytes_(cbFrames) const BYTE* pFrames,
+    _Out_ ULONG* pStackId)
+{
+    auto range = s_Stacks.equal_range(stackHash);
+
+    for (auto match = range.first; match != range.second; match++)
+    {
+        const std::vector<BYTE>& frames = match->second.Frames;
+
+        if (frames.size() == cbFrames && memcmp(frames.data(), pFrames, cbFrames) == 0)
+        {
+            *pStackId = match->second.StackId;
+            return TRUE;
+        }
+    }
+
+    *pStackId = 0;
+    return FALSE;
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+/// <summary>
+/// A distinct call path that has been assigned an ID, along with the serialized frames it was defined with.
+/// </summary>
+struct StackEntry
+{
+    ULONG StackId;
+    std::vector<BYTE> Frames;
+};
+
+/// <summary>
+/// Assigns compact IDs to the distinct call paths that have been observed across all threads.<para/>
+/// Each frame on the shadow stack stores a hash of the call path ending at that frame, so the identity of the current stack is always
+/// available without walking it. The first time a given stack is seen, it is assigned the next available ID and a single StackDefinedEvent
+/// is written describing its frames. Stack samples then refer to the stack by its ID.<para/>
+/// As different stacks may have the same hash, a stack is only considered to have been seen before if its frames match those of a stack
+/// that has the same hash.
+/// </summary>
+class CStackTable
+{
+public:
+    static ULONG GetStackId(
+        _In_ UINT64 stackHash,
+        _In_ ULONG cbFrames,
+        _In_reads_bytes_(cbFrames) const BYTE* pFrames);
+
+private:
+    static BOOL TryFindStack(
+        _In_ UINT64 stackHash,
+        _In_ ULONG cbFrames,
+        _In_reads_bytes_(cbFrames) const BYTE* pFrames,
+        _Out_ ULONG* pStackId);
+
+    static std::unordered_multimap<UINT64, StackEntry> s_Stacks;
+    static std::shared_mutex s_StacksMutex;
+
+    static ULONG s_NextStackId;
+};
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include "pch.h"
+#include "CStackWalkSampler.h"
+#include "CCorProfilerCallback.h"
+#include "CStackTable.h"
+#include "CValueTracer.h"
+#include "Events.h"
+
+BOOL g_StackWalkSamplingEnabled = FALSE;
+
+ICorProfilerInfo4* CStackWalkSampler::s_pInfo = nullptr;
+DWORD CStackWalkSampler::s_Interval = 0;
+CIntervalThread CStackWalkSampler::s_Thread;
+
+std::unordered_set<ThreadID> CStackWalkSampler::s_Threads;
+std::shared_mutex CStackWalkSampler::s_ThreadsMutex;
+
+std::unordered_map<FunctionID, BOOL> CStackWalkSampler::s_Functions;
+
+#define MAX_SAMPLES (VALUE_BUFFER_SIZE / sizeof(StackSample))
+
+HRESULT CStackWalkSampler::Initialize(_In_ ICorProfilerInfo4* pInfo)
+{
+    HRESULT hr = S_OK;
+
+    if (!GetIntSetting("DEBUGTOOLS_STACKWALKINTERVAL", &s_Interval) || s_Interval == 0)
+        goto ErrExit;
+
+    s_pInfo = pInfo;
+    g_StackWalkSamplingEnabled = TRUE;
+
+    IfFailGo(s_Thread.Start(SamplerThreadProc, s_Interval));
+
+ErrExit:
+    return hr;
+}
+
+void CStackWalkSampler::Shutdown()
+{
+    s_Thread.Stop();
+}
+
+void CStackWalkSampler::ThreadCreated(_In_ ThreadID threadId)
+{
+    CLock threadsLock(&s_ThreadsMutex, true);
+
+    s_Threads.insert(threadId);
+}
+
+void CStackWalkSampler::ThreadDestroyed(_In_ ThreadID threadId)
+{
+    CLock threadsLock(&s_ThreadsMutex, true);
+
+    s_Threads.erase(threadId);
+}
+
+DWORD WINAPI CStackWalkSampler::SamplerThreadProc(LPVOID lpParameter)
+{
+    CThreadContext* pContext = GetThreadContext();
+
+    StackWalk* pWalk = new StackWalk;
+    std::vector<StackSample> samples;
+
+    while (s_Thread.Wait())
+    {
+        if (g_TracingEnabled)
+            Sample(pContext, pWalk, samples);
+    }
+
+    delete pWalk;
+
+    return 0;
+}
+
+void CStackWalkSampler::Sample(
+    _In_ CThreadContext* pSamplerContext,
+    _In_ StackWalk* pWalk,
+    _Inout_ std::vector<StackSample>& samples)
+{
+    HRESULT hr = S_OK;
+
+    samples.clear();
+
+    CLock threadsLock(&s_ThreadsMutex);
+
+    for (ThreadID threadId : s_Threads)
+    {
+        if (samples.size() >= MAX_SAMPLES)
+            break;
+
+        DWORD win32ThreadId;
+
+        if (FAILED(s_pInfo->GetThreadInfo(threadId, &win32ThreadId)) || FAILED(WalkThread(threadId, pWalk)))
+            continue;
+
+        //The walk has completed and the CLR has resumed the thread; we're now free to resolve its frames and define its stack.
+        //Frames are reported innermost first, but stacks are hashed and serialized outermost first
+        UINT64 stackHash = 0;
+        BYTE* ptr = pSamplerContext->ValueBuffer;
+
+        for (ULONG i = pWalk->Count; i > 0; i--)
+        {
+            FunctionID functionId = pWalk->Frames[i - 1];
+
+            if (!ShouldInclude(functionId))
+                continue;
+
+            stackHash = HashStackFrame(stackHash, functionId, FrameKind::Managed);
+
+            UINT64 functionIdArg = functionId;
+            INT32 kind = (INT32)FrameKind::Managed;
+
+            memcpy(ptr, &functionIdArg, sizeof(UINT64));
+            ptr += sizeof(UINT64);
+
+            memcpy(ptr, &kind, sizeof(INT32));
+            ptr += sizeof(INT32);
+        }
+
+        if (stackHash == 0)
+            continue;
+
+        ULONG stackId = CStackTable::GetStackId(stackHash, (ULONG)(ptr - pSamplerContext->ValueBuffer), pSamplerContext->ValueBuffer);
+
+        samples.push_back({ win32ThreadId, stackId, FALSE });
+    }
+
+    if (samples.empty())
+        return;
+
+    ValidateETW(EventWriteStackSampleEvent((ULONG)(samples.size() * sizeof(StackSample)), (const BYTE*)samples.data()));
+}
+
+/// <summary>
+/// Records the FunctionIDs of a managed thread's managed frames.<para/>
+/// The walk is unseeded, so the CLR suspends the thread itself and begins the walk from the most recent transition into unmanaged code
+/// or from the thread's managed frame at the point it was suspended. We must not suspend the thread ourselves: calling into the runtime
+/// while it is suspended could deadlock on any lock the thread was holding.
+/// </summary>
+HRESULT CStackWalkSampler::WalkThread(
+    _In_ ThreadID threadId,
+    _In_ StackWalk* pWalk)
+{
+    pWalk->Count = 0;
+
+    return s_pInfo->DoStackSnapshot(
+        threadId,
+        StackSnapshotCallback,
+        COR_PRF_SNAPSHOT_DEFAULT,
+        pWalk,
+        NULL,
+        0
+    );
+}
+
+/// <summary>
+/// Determines whether a function that was observed on a stack should be included in samples, resolving the function the first time it is seen.
+/// Functions that would not have been hooked in ELT mode (such as those in blacklisted modules) are omitted, so that samples contain the same frames
+/// that a trace would.
+/// </summary>
+BOOL CStackWalkSampler::ShouldInclude(_In_ FunctionID functionId)
+{
+    auto match = s_Functions.find(functionId);
+
+    if (match != s_Functions.end())
+        return match->second;
+
+    BOOL include;
+    CCorProfilerCallback::RecordFunction(functionId, nullptr, &include);
+
+    s_Functions[functionId] = include;
+
+    return include;
+}
+
+HRESULT __stdcall CStackWalkSampler::StackSnapshotCallback(
+    FunctionID funcId,
+    UINT_PTR ip,
+    COR_PRF_FRAME_INFO frameInfo,
+    ULONG32 contextSize,
+    BYTE context[],
+    void* clientData)
+{
+    StackWalk* pWalk = (StackWalk*)clientData;
+
+    //Unmanaged frames are reported with a FunctionID of 0. If the stack is deeper than we can store, the outermost frames are dropped
+    if (funcId != 0 && pWalk->Count < MAX_PUBLISHED_FRAMES)
+        pWalk->Frames[pWalk->Count++] = funcId;
+
+    return S_OK;
+}
\ No newline at end of file
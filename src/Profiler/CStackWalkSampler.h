@@ -0,0 +1,70 @@
+#pragma once
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "CIntervalThread.h"
+#include "CSampler.h"
+#include "CThreadContext.h"
+
+extern BOOL g_StackWalkSamplingEnabled;
+
+/// <summary>
+/// Stores the frames collected by a single DoStackSnapshot walk. The CLR suspends the target thread while the walk is in progress,
+/// so the walk must not allocate memory or take any locks the target thread may be holding.
+/// </summary>
+typedef struct StackWalk {
+    ULONG Count;
+    FunctionID Frames[MAX_PUBLISHED_FRAMES];
+} StackWalk;
+
+/// <summary>
+/// Samples the stacks of managed threads via DoStackSnapshot, as an alternative to ELT hooks for when the cost of hooking every method
+/// (disabling NGEN images and preventing inlining) is unacceptable.<para/>
+/// In this mode no Enter/Leave hooks are installed. At each interval the sampler thread asks the CLR to walk each managed thread's stack in turn.
+/// Once the walk has completed, any methods that haven't been seen before are resolved through <see cref="CCorProfilerCallback::RecordFunction"/>,
+/// and the stack is interned via <see cref="CStackTable"/> and written in a StackSampleEvent, exactly as <see cref="CSampler"/> does.
+/// Overhead is bounded by the sampling interval and the number of threads, rather than by the rate at which methods are called.
+/// </summary>
+class CStackWalkSampler
+{
+public:
+    static HRESULT Initialize(_In_ ICorProfilerInfo4* pInfo);
+    static void Shutdown();
+
+    static void ThreadCreated(_In_ ThreadID threadId);
+    static void ThreadDestroyed(_In_ ThreadID threadId);
+
+private:
+    static DWORD WINAPI SamplerThreadProc(LPVOID lpParameter);
+
+    static void Sample(
+        _In_ CThreadContext* pSamplerContext,
+        _In_ StackWalk* pWalk,
+        _Inout_ std::vector<StackSample>& samples);
+
+    static HRESULT WalkThread(
+        _In_ ThreadID threadId,
+        _In_ StackWalk* pWalk);
+
+    static BOOL ShouldInclude(_In_ FunctionID functionId);
+
+    static HRESULT __stdcall StackSnapshotCallback(
+        FunctionID funcId,
+        UINT_PTR ip,
+        COR_PRF_FRAME_INFO frameInfo,
+        ULONG32 contextSize,
+        BYTE context[],
+        void* clientData);
+
+    static ICorProfilerInfo4* s_pInfo;
+    static DWORD s_Interval;
+    static CIntervalThread s_Thread;
+
+    //The managed threads that currently exist. Threads can't be destroyed while they're being walked
+    static std::unordered_set<ThreadID> s_Threads;
+    static std::shared_mutex s_ThreadsMutex;
+
+    //Whether each function that has been observed on a stack should be included in samples. Only accessed by the sampler thread
+    static std::unordered_map<FunctionID, BOOL> s_Functions;
+};
\ No newline at end of file
@@ -9,11 +9,12 @@
 void CStaticTracer::Trace(LPWSTR szName)
 {
     HRESULT hr = S_OK;
+    CThreadContext* pContext = GetThreadContext();
 
     CClassInfo* pInfo = nullptr;
     mdFieldDef fieldDef = 0;
     CSigField* pField;
-    CValueTracer tracer;
+    CValueTracer tracer(pContext);
     void* pAddress;
 
     LPWSTR szType;
@@ -41,7 +42,7 @@ void CStaticTracer::Trace(LPWSTR szName)
     IfFailGo(tracer.GetFieldValue(pAddress, pInfo, pField));
 
 ErrExit:
-    ValidateETW(EventWriteStaticFieldValueEvent(hr, g_ValueBufferPosition, g_ValueBuffer));
+    ValidateETW(EventWriteStaticFieldValueEvent(hr, pContext->ValueBufferPosition, pContext->ValueBuffer));
 }
 
 HRESULT CStaticTracer::ReadTraceRequest(
@@ -169,6 +170,7 @@ HRESULT CStaticTracer::GetFieldToken(
     _Out_ CSigField** ppField)
 {
     HRESULT hr = S_OK;
+    CThreadContext* pContext = GetThreadContext();
     IMetaDataImport2* pMDI = nullptr;
     HCORENUM hEnum = nullptr;
     ULONG cTokens = 0;
@@ -196,7 +198,7 @@ HRESULT CStaticTracer::GetFieldToken(
         IfFailGo(pMDI->GetFieldProps(
             rFields[i],
             NULL,
-            g_szFieldName,
+            pContext->szFieldName,
             NAME_BUFFER_SIZE,
             &chField,
             NULL,
@@ -207,7 +209,7 @@ HRESULT CStaticTracer::GetFieldToken(
             NULL
         ));
 
-        if (lstrcmpiW(g_szFieldName, szField) == 0)
+        if (lstrcmpiW(pContext->szFieldName, szField) == 0)
         {
             *fieldDef = rFields[i];
 
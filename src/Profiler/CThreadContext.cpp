@@ -0,0 +1,112 @@
+#include "pch.h"
+#include "CThreadContext.h"
+#include "CExceptionInfo.h"
+#include "CSampler.h"
+
+thread_local CThreadContext* g_pThreadContext = nullptr;
+
+std::unordered_map<DWORD, CThreadContext*> CThreadContext::s_Contexts;
+std::shared_mutex CThreadContext::s_ContextsMutex;
+
+/// <summary>
+/// Creates and registers the context of the current thread.<para/>
+/// Contexts are created the first time a thread requires one rather than in ThreadCreated, as the CLR does not guarantee that
+/// ThreadCreated is called on the thread that was created, and unmanaged threads may enter the profiler without ever being reported.
+/// </summary>
+CThreadContext* CThreadContext::Create()
+{
+    DWORD threadId = GetCurrentThreadId();
+
+    CThreadContext* pContext = new CThreadContext(threadId);
+
+    if (g_SamplingEnabled)
+        pContext->CallStack.Publish();
+
+    if (g_OffCpuEnabled)
+        pContext->ThreadHandle = OpenThread(THREAD_QUERY_LIMITED_INFORMATION, FALSE, threadId);
+
+    //Lock scope
+    {
+        CLock contextsLock(&s_ContextsMutex, true);
+
+        s_Contexts[threadId] = pContext;
+    }
+
+    g_pThreadContext = pContext;
+
+    return pContext;
+}
+
+/// <summary>
+/// Unregisters and frees the context of the current thread. Called when the thread detaches from the profiler.<para/>
+/// As the loader lock is held at this point, no events may be written. Any events the thread was holding onto are flushed
+/// when the thread is destroyed instead (see CCorProfilerCallback::ThreadDestroyed).
+/// </summary>
+void CThreadContext::Release()
+{
+    CThreadContext* pContext = g_pThreadContext;
+
+    if (pContext == nullptr)
+        return;
+
+    //Lock scope
+    {
+        CLock contextsLock(&s_ContextsMutex, true);
+
+        s_Contexts.erase(pContext->ThreadId);
+    }
+
+    g_pThreadContext = nullptr;
+
+    if (pContext->ThreadHandle)
+        CloseHandle(pContext->ThreadHandle);
+
+    //The thread may have exited while it still had exceptions in flight
+    for (CExceptionInfo* pException : pContext->ExceptionQueue)
+        delete pException;
+
+    delete pContext;
+}
+
+#define MAX_READ_ATTEMPTS 10
+
+/// <summary>
+/// Copies the published stack of another thread.
+/// </summary>
+/// <param name="pDepth">Receives the true depth of the stack, which may exceed MAX_PUBLISHED_FRAMES.</param>
+/// <param name="pStackHash">Receives the hash of the stack.</param>
+/// <param name="pFrames">A buffer that receives up to MAX_PUBLISHED_FRAMES of the stack's outermost frames.</param>
+/// <returns>TRUE if a consistent copy of the stack was obtained, or FALSE if the owning thread was modifying its stack each time it was read.</returns>
+BOOL CPublishedStack::TryRead(
+    _Out_ size_t* pDepth,
+    _Out_ UINT64* pStackHash,
+    _Out_writes_(MAX_PUBLISHED_FRAMES) PublishedFrame* pFrames) const
+{
+    for (int i = 0; i < MAX_READ_ATTEMPTS; i++)
+    {
+        ULONG before = m_Sequence.load(std::memory_order_acquire);
+
+        if (before & 1)
+        {
+            YieldProcessor();
+            continue;
+        }
+
+        size_t depth = m_Depth;
+        UINT64 stackHash = m_StackHash;
+
+        //If we observed a torn depth the sequence check below will fail, but we must not overrun the buffer in the meantime
+        memcpy(pFrames, m_Frames, min(depth, MAX_PUBLISHED_FRAMES) * sizeof(PublishedFrame));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (m_Sequence.load(std::memory_order_relaxed) == before)
+        {
+            *pDepth = depth;
+            *pStackHash = stackHash;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
\ No newline at end of file
@@ -0,0 +1,414 @@
+#pragma once
+
+#include <atomic>
+#include <stack>
+#include <deque>
+#include <unordered_set>
+#include <unordered_map>
+#include <vector>
+#include "CCallCoalescer.h"
+#include "CCallSuppressor.h"
+
+#define VALUE_BUFFER_SIZE 62000 //ETW is limited to 64KB
+
+//The size of the name buffers in each thread context (which avoid reallocating with each RecordFunction invocation that is made)
+#define NAME_BUFFER_SIZE 512
+
+//The maximum number of frames of each thread's shadow stack that are visible to the sampler. Deeper frames are still tracked
+//by the thread itself, however samples of such stacks will only contain their outermost frames
+#define MAX_PUBLISHED_FRAMES 512
+
+class CExceptionInfo;
+struct PInvokeHistogram;
+
+enum class FrameKind
+{
+    Managed = 0,
+    U2M,
+    M2U
+};
+
+/// <summary>
+/// Combines the hash of a parent stack with a frame that is being pushed on top of it, producing a value that identifies the resulting call path.<para/>
+/// The frame is mixed into the parent hash using the splitmix64 finalizer, so that every bit of the FunctionID (whose low bits are
+/// always zero) affects every bit of the result.
+/// </summary>
+FORCEINLINE UINT64 HashStackFrame(UINT64 parentHash, FunctionID functionId, FrameKind kind)
+{
+    UINT64 hash = parentHash + (UINT64)functionId + ((UINT64)kind << 56) + 0x9E3779B97F4A7C15;
+
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EB;
+
+    return hash ^ (hash >> 31);
+}
+
+struct Frame
+{
+    FunctionID FunctionId;
+    FrameKind Kind;
+
+    //Identifies the call path ending at this frame. Computed from the hash of the parent frame when the frame is pushed,
+    //so that the identity of the current stack is always available without walking it. An empty stack has a hash of 0
+    UINT64 StackHash;
+
+    //The QPC the frame was entered at, and the total QPC duration of the frames it has called so far. The entry time is only
+    //recorded when hot function suppression or continuous profiling is enabled, and the child duration only in continuous profiling mode
+    LONGLONG EnterQPC;
+    LONGLONG ChildDuration;
+
+    //Whether the frame belongs to a function that was suppressed when it was entered, in which case no events are written for it
+    BOOL Suppressed;
+
+    //Whether any frames were entered while this frame was active
+    BOOL HasChildren;
+
+    //The thread's cycle count when the frame was entered, the cycles consumed by the frames it has called so far, and the number
+    //of calls that have been made beneath it. The cycles are only recorded when CPU time is being measured, and the number of calls
+    //when CPU time is being measured or in continuous profiling mode
+    ULONG64 EnterCycles;
+    ULONG64 ChildCycles;
+    ULONG64 DescendantCalls;
+
+    Frame(FunctionID functionId, FrameKind kind, UINT64 parentHash, BOOL suppressed = FALSE) :
+        FunctionId(functionId),
+        Kind(kind),
+        //The client never sees suppressed frames, so they must not contribute to the identity of the stack
+        StackHash(suppressed ? parentHash : HashStackFrame(parentHash, functionId, kind)),
+        EnterQPC(0),
+        ChildDuration(0),
+        Suppressed(suppressed),
+        HasChildren(FALSE),
+        EnterCycles(0),
+        ChildCycles(0),
+        DescendantCalls(0)
+    {
+    }
+};
+
+struct PublishedFrame
+{
+    FunctionID FunctionId;
+    FrameKind Kind;
+    BOOL Suppressed;
+};
+
+/// <summary>
+/// A copy of a thread's shadow stack that can be safely read by other threads.<para/>
+/// The owning thread is the only writer. Each modification increments the sequence before and after the stack is modified,
+/// so a reader that observes the same even sequence before and after copying the stack knows it didn't observe a partial update.
+/// This allows the sampler to read the stack without taking any locks or suspending the thread, at the cost of two
+/// uncontended stores on each push and pop.
+/// </summary>
+class CPublishedStack
+{
+public:
+    CPublishedStack() :
+        m_Sequence(0),
+        m_Depth(0),
+        m_StackHash(0)
+    {
+    }
+
+    FORCEINLINE void Push(const Frame& frame, size_t depth)
+    {
+        BeginWrite();
+
+        if (depth <= MAX_PUBLISHED_FRAMES)
+        {
+            PublishedFrame& published = m_Frames[depth - 1];
+            published.FunctionId = frame.FunctionId;
+            published.Kind = frame.Kind;
+            published.Suppressed = frame.Suppressed;
+        }
+
+        m_Depth = depth;
+        m_StackHash = frame.StackHash;
+
+        EndWrite();
+    }
+
+    FORCEINLINE void Pop(size_t depth, UINT64 stackHash)
+    {
+        BeginWrite();
+
+        m_Depth = depth;
+        m_StackHash = stackHash;
+
+        EndWrite();
+    }
+
+    BOOL TryRead(
+        _Out_ size_t* pDepth,
+        _Out_ UINT64* pStackHash,
+        _Out_writes_(MAX_PUBLISHED_FRAMES) PublishedFrame* pFrames) const;
+
+private:
+    FORCEINLINE void BeginWrite()
+    {
+        m_Sequence.store(m_Sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    FORCEINLINE void EndWrite()
+    {
+        m_Sequence.store(m_Sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    //Odd while the owning thread is modifying the stack
+    std::atomic<ULONG> m_Sequence;
+
+    size_t m_Depth;
+    UINT64 m_StackHash;
+    PublishedFrame m_Frames[MAX_PUBLISHED_FRAMES];
+};
+
+class CCallStack : public std::stack<Frame>
+{
+public:
+    CCallStack() : m_pPublished(nullptr)
+    {
+    }
+
+    ~CCallStack()
+    {
+        if (m_pPublished)
+            delete m_pPublished;
+    }
+
+    CCallStack(const CCallStack&) = delete;
+    CCallStack& operator=(const CCallStack&) = delete;
+
+    //Hides std::stack::emplace and std::stack::pop so that every modification to the stack is published to the sampler
+
+    template<class... Args>
+    FORCEINLINE void emplace(Args&&... args)
+    {
+        std::stack<Frame>::emplace(std::forward<Args>(args)...);
+
+        if (m_pPublished)
+            m_pPublished->Push(c.back(), c.size());
+    }
+
+    FORCEINLINE void pop()
+    {
+        std::stack<Frame>::pop();
+
+        if (m_pPublished)
+            m_pPublished->Pop(c.size(), Hash());
+    }
+
+    void clear()
+    {
+        c.clear();
+
+        if (m_pPublished)
+            m_pPublished->Pop(0, 0);
+    }
+
+    /// <summary>
+    /// Starts publishing the stack so that it can be read by the sampler. Must be called while the stack is empty.
+    /// </summary>
+    void Publish()
+    {
+        if (!m_pPublished)
+            m_pPublished = new CPublishedStack();
+    }
+
+    const CPublishedStack* Published() const
+    {
+        return m_pPublished;
+    }
+
+    //std::stack doesn't provide a way to enumerate its items, which we need in order to write call stack snapshots
+    const std::deque<Frame>& Frames() const
+    {
+        return c;
+    }
+
+    UINT64 Hash() const
+    {
+        return c.empty() ? 0 : c.back().StackHash;
+    }
+
+private:
+    CPublishedStack* m_pPublished;
+};
+
+/// <summary>
+/// Stores all of the state the profiler maintains about a single thread.<para/>
+/// Hooks retrieve the context once and then access everything they need through it, rather than performing a separate TLS lookup
+/// for each piece of state. Members are ordered by how frequently they're accessed, so that the Enter/Leave fast path only touches
+/// the first one or two cache lines of the context.
+/// </summary>
+struct alignas(SYSTEM_CACHE_ALIGNMENT_SIZE) CThreadContext
+{
+    CThreadContext(DWORD threadId) :
+        Sequence(0),
+        CallStackSnapshotGeneration(0),
+        CheckM2UUnwind(FALSE),
+        ExceptionsPending(FALSE),
+        PendingEnter(),
+        PendingRun(),
+        SuppressorCalls(),
+        ThreadId(threadId),
+        ExceptionSequence(0),
+        FilterCallDepth(0),
+        SlowCallDepth(0),
+        SlowCallEnterQPC(0),
+        SlowCallEnterSequence(0),
+        SlowCallOverflowed(FALSE),
+        ValueBufferPosition(0),
+        ThreadHandle(nullptr),
+        SampledCycles(0)
+    {
+    }
+
+    static CThreadContext* Create();
+    static void Release();
+
+#pragma region Enter/Leave
+
+    //Stores a number that uniquely identifies each Enter/Leave/Tailcall event for the current thread.
+    ULONG Sequence;
+
+    //Stores the value of CCallStackSnapshot::s_Generation at the time the current thread last wrote a snapshot.
+    LONG CallStackSnapshotGeneration;
+
+    BOOL CheckM2UUnwind;
+
+    //Whether ExceptionQueue is non-empty. Hooks check this rather than the queue itself, so that a thread that has no exceptions
+    //in flight never touches the exception state stored further into the context
+    BOOL ExceptionsPending;
+
+    //Stores the current stack of function calls for the current thread.
+    CCallStack CallStack;
+
+#pragma endregion
+#pragma region Call Coalescing
+
+    alignas(SYSTEM_CACHE_ALIGNMENT_SIZE) PendingCallEnter PendingEnter;
+    PendingCallRun PendingRun;
+
+    //Protects PendingEnter and PendingRun. Only ever contended when the profiler shuts down and flushes the events held by every thread
+    std::shared_mutex CoalescerMutex;
+
+#pragma endregion
+#pragma region Call Suppression
+
+    //The calls to hooked functions this thread has measured that haven't yet been folded into their function records.
+    //Only used when hot function suppression is enabled. Calls still pending when the thread exits are discarded
+    PendingSuppressorCalls SuppressorCalls[PENDING_SUPPRESSOR_CALLS_SIZE];
+
+#pragma endregion
+#pragma region Exceptions
+
+    alignas(SYSTEM_CACHE_ALIGNMENT_SIZE) DWORD ThreadId;
+    long ExceptionSequence;
+    ULONG FilterCallDepth;
+    std::deque<CExceptionInfo*> ExceptionQueue;
+
+#pragma endregion
+#pragma region Transitions
+
+    //The transition functions this thread has already ensured were recorded, allowing subsequent transitions to skip taking any locks
+    std::unordered_set<FunctionID> RecordedTransitions;
+
+    //The histograms of the unmanaged functions this thread has called. Only used when P/Invoke statistics are enabled
+    std::unordered_map<FunctionID, PInvokeHistogram*> PInvokeHistograms;
+
+#pragma endregion
+#pragma region Slow Call Capture
+
+    //The depth of CallStack at which the call being captured was entered, or 0 if no call is being captured
+    size_t SlowCallDepth;
+    LONGLONG SlowCallEnterQPC;
+
+    //The thread's Sequence when the call being captured was entered, used to determine how many calls were made beneath it
+    ULONG SlowCallEnterSequence;
+
+    //Whether the events of the call being captured exceeded SLOW_CALL_MAX_BUFFER_SIZE, in which case the call won't be committed
+    BOOL SlowCallOverflowed;
+
+    //The events of the call being captured, which are only transferred if the call is found to be slow
+    std::vector<BYTE> SlowCallBuffer;
+
+#pragma endregion
+#pragma region Detailed
+
+    std::unordered_set<UINT_PTR> SeenMap;
+
+    //Stores the depths of CallStack at which calls satisfying their value predicates were entered on the current thread
+    std::vector<size_t> ValuePredicateMatches;
+
+    //If a value is passed that is longer than VALUE_BUFFER_SIZE, the calculated remaining length will be negative,
+    //so we need to have a signed buffer length so that the comparison works correctly
+    signed long ValueBufferPosition;
+
+    BYTE ValueBuffer[VALUE_BUFFER_SIZE];
+
+#pragma endregion
+#pragma region Names
+
+    WCHAR szMethodName[NAME_BUFFER_SIZE];
+    WCHAR szTypeName[NAME_BUFFER_SIZE];
+    WCHAR szModuleName[NAME_BUFFER_SIZE];
+    WCHAR szAssemblyName[NAME_BUFFER_SIZE];
+    WCHAR szFieldName[NAME_BUFFER_SIZE];
+
+#pragma endregion
+#pragma region Sampling
+
+    //A handle the sampler can use to query the thread's cycle time, and the cycle time at the previous sample.
+    //Only used when off-CPU sampling is enabled, and only accessed by the sampler thread after the context is created
+    HANDLE ThreadHandle;
+    ULONG64 SampledCycles;
+
+#pragma endregion
+
+    /// <summary>
+    /// Invokes a callback against the context of every thread while preventing any contexts from being created or released.
+    /// </summary>
+    template<typename Callback>
+    static void ForEach(Callback callback)
+    {
+        CLock contextsLock(&s_ContextsMutex);
+
+        for (auto& item : s_Contexts)
+            callback(item.second);
+    }
+
+    /// <summary>
+    /// Invokes a callback against the context of a given thread, if the thread has one, while preventing the context from being released.
+    /// </summary>
+    template<typename Callback>
+    static void ForThread(DWORD threadId, Callback callback)
+    {
+        CLock contextsLock(&s_ContextsMutex);
+
+        auto match = s_Contexts.find(threadId);
+
+        if (match != s_Contexts.end())
+            callback(match->second);
+    }
+
+private:
+    //All contexts that currently exist, keyed by the thread they belong to
+    static std::unordered_map<DWORD, CThreadContext*> s_Contexts;
+    static std::shared_mutex s_ContextsMutex;
+};
+
+extern thread_local CThreadContext* g_pThreadContext;
+
+/// <summary>
+/// Retrieves the context of the current thread, creating it if this is the first time the profiler has seen the thread.
+/// </summary>
+FORCEINLINE CThreadContext* GetThreadContext()
+{
+    CThreadContext* pContext = g_pThreadContext;
+
+    if (pContext == nullptr)
+        pContext = CThreadContext::Create();
+
+    return pContext;
+}
\ No newline at end of file
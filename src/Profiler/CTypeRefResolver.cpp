@@ -114,7 +114,7 @@ HRESULT CTypeRefResolver::ResolveAssemblyRef(
         assemblyRef,
         (const void**)&pbPublicKeyOrToken,
         &cbPublicKeyOrToken,
-        g_szAssemblyName,
+        GetThreadContext()->szAssemblyName,
         NAME_BUFFER_SIZE,
         &chName,
         &asmMetaData,
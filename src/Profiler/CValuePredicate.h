@@ -0,0 +1,138 @@
+#pragma once
+
+#include <Shlwapi.h>
+
+enum class ValuePredicateKind
+{
+    Equals = 1,
+    NotEquals,
+    Contains
+};
+
+/// <summary>
+/// Describes a condition that must be satisfied by the value of a named parameter of a given method
+/// in order for calls to that method to be traced in detail.<para/>
+/// String values are always compared case-insensitively, so that Equals and NotEquals agree with Contains about which strings are the same.
+/// </summary>
+class CValuePredicate
+{
+public:
+    CValuePredicate() :
+        m_Kind((ValuePredicateKind)0),
+        m_szMethodName(nullptr),
+        m_szParameterName(nullptr),
+        m_szValue(nullptr),
+        m_IsNumeric(FALSE),
+        m_NumericValue(0)
+    {
+    }
+
+    CValuePredicate(const CValuePredicate& existing)
+    {
+        m_Kind = existing.m_Kind;
+        m_szMethodName = _wcsdup(existing.m_szMethodName);
+        m_szParameterName = _wcsdup(existing.m_szParameterName);
+        m_szValue = _wcsdup(existing.m_szValue);
+        m_IsNumeric = existing.m_IsNumeric;
+        m_NumericValue = existing.m_NumericValue;
+    }
+
+    CValuePredicate(CValuePredicate&& existing) noexcept : //Move constructor
+        m_Kind(existing.m_Kind),
+        m_szMethodName(existing.m_szMethodName),
+        m_szParameterName(existing.m_szParameterName),
+        m_szValue(existing.m_szValue),
+        m_IsNumeric(existing.m_IsNumeric),
+        m_NumericValue(existing.m_NumericValue)
+    {
+        existing.m_szMethodName = nullptr;
+        existing.m_szParameterName = nullptr;
+        existing.m_szValue = nullptr;
+    }
+
+    ~CValuePredicate()
+    {
+        if (m_szMethodName)
+            free(m_szMethodName);
+
+        if (m_szParameterName)
+            free(m_szParameterName);
+
+        if (m_szValue)
+            free(m_szValue);
+    }
+
+    void SetValue(LPWSTR szValue)
+    {
+        m_szValue = szValue;
+
+        WCHAR* end = nullptr;
+        m_NumericValue = _wcstoi64(szValue, &end, 10);
+
+        //Only treat the value as a number if the entire string was consumed
+        m_IsNumeric = *szValue != '\0' && end != nullptr && *end == '\0';
+    }
+
+    BOOL IsMatch(LONGLONG value)
+    {
+        if (!m_IsNumeric)
+            return m_Kind == ValuePredicateKind::NotEquals;
+
+        switch (m_Kind)
+        {
+        case ValuePredicateKind::Equals:
+            return value == m_NumericValue;
+
+        case ValuePredicateKind::NotEquals:
+            return value != m_NumericValue;
+
+        default:
+            return FALSE;
+        }
+    }
+
+    BOOL IsMatch(LPCWSTR str)
+    {
+        //A null string only ever satisfies a NotEquals predicate
+        if (str == nullptr)
+            return m_Kind == ValuePredicateKind::NotEquals;
+
+        switch (m_Kind)
+        {
+        case ValuePredicateKind::Equals:
+            return _wcsicmp(str, m_szValue) == 0;
+
+        case ValuePredicateKind::NotEquals:
+            return _wcsicmp(str, m_szValue) != 0;
+
+        case ValuePredicateKind::Contains:
+            return StrStrI(str, m_szValue) != NULL;
+
+        default:
+            return FALSE;
+        }
+    }
+
+    ValuePredicateKind m_Kind;
+    LPWSTR m_szMethodName;
+    LPWSTR m_szParameterName;
+    LPWSTR m_szValue;
+
+    BOOL m_IsNumeric;
+    LONGLONG m_NumericValue;
+};
+
+/// <summary>
+/// Associates a <see cref="CValuePredicate"/> with the index of the parameter it applies to within a specific method.
+/// </summary>
+struct BoundValuePredicate
+{
+    ULONG ParameterIndex;
+    CValuePredicate* Predicate;
+
+    BoundValuePredicate(ULONG parameterIndex, CValuePredicate* predicate) :
+        ParameterIndex(parameterIndex),
+        Predicate(predicate)
+    {
+    }
+};
\ No newline at end of file
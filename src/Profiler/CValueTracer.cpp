@@ -5,41 +5,28 @@
 #include "CTypeRefResolver.h"
 #include "CTypeIdentifier.h"
 #include <unordered_set>
-
-thread_local ULONG g_Sequence = 0;
-thread_local std::stack<Frame> g_CallStack;
-thread_local BOOL g_CheckM2UUnwind = FALSE;
-
-thread_local std::unordered_set<UINT_PTR> g_SeenMap;
-thread_local BYTE g_ValueBuffer[VALUE_BUFFER_SIZE];
-
-//If a value is passed that is longer than VALUE_BUFFER_SIZE, the calculated remaining length will be negative,
-//so we need to have a signed buffer length so that the comparison works correctly
-thread_local signed long g_ValueBufferPosition = 0;
+#include <string>
 
 ULONG CValueTracer::s_StringLengthOffset;
 ULONG CValueTracer::s_StringBufferOffset;
 ULONG CValueTracer::s_MaxTraceDepth;
 BOOL CValueTracer::s_IgnorePointerValue;
+std::vector<CValuePredicate> CValueTracer::s_ValuePredicates;
+BOOL CValueTracer::s_ValuePredicateSubtree;
 
 HRESULT CValueTracer::Initialize(ICorProfilerInfo4* pInfo)
 {
-#define BUFFER_SIZE 100
-
     HRESULT hr = S_OK;
-    CHAR envBuffer[BUFFER_SIZE];
-    DWORD actualSize;
 
     IfFailGo(pInfo->GetStringLayout2(&s_StringLengthOffset, &s_StringBufferOffset));
 
-    actualSize = GetEnvironmentVariableA("DEBUGTOOLS_TRACEVALUEDEPTH", envBuffer, BUFFER_SIZE);
-
-    if (actualSize != 0 && actualSize < BUFFER_SIZE)
-        s_MaxTraceDepth = strtol(envBuffer, NULL, 10);
-    else
-        s_MaxTraceDepth = -1;
+    s_MaxTraceDepth = -1;
+    GetIntSetting("DEBUGTOOLS_TRACEVALUEDEPTH", &s_MaxTraceDepth);
 
     s_IgnorePointerValue = GetBoolEnv("DEBUGTOOLS_IGNORE_POINTERVALUE");
+    s_ValuePredicateSubtree = GetBoolEnv("DEBUGTOOLS_VALUEPREDICATE_SUBTREE");
+
+    GetValuePredicates();
 
 ErrExit:
     return hr;
@@ -51,8 +38,8 @@ HRESULT CValueTracer::EnterWithInfo(FunctionIDOrClientID functionId, COR_PRF_ELT
 {
     HRESULT hr = S_OK;
 
-    g_SeenMap.clear();
-    g_ValueBufferPosition = 0;
+    m_pContext->SeenMap.clear();
+    m_pContext->ValueBufferPosition = 0;
 
     CSigMethodDef* pMethod = nullptr;
 
@@ -61,12 +48,32 @@ HRESULT CValueTracer::EnterWithInfo(FunctionIDOrClientID functionId, COR_PRF_ELT
     ULONG cbArgumentInfo = 0;
     COR_PRF_FUNCTION_ARGUMENT_INFO* argumentInfo = nullptr;
 
+    //When value predicates have been specified, only calls that satisfy them (and optionally their children) have their values traced
+    BOOL mustMatch = FALSE;
+    BOOL traceValues = TRUE;
+
     //Lock scope
     {
         CLock methodLock(&g_pProfiler->m_MethodMutex);
         IfFailGo(GetMethodInfoNoLock(functionId, &pMethod));
     }
 
+    if (!s_ValuePredicates.empty())
+    {
+        //ENTER_FUNCTION has already pushed this frame, so any matches recorded at this depth or deeper were unwound without us seeing a leave
+        PruneValuePredicateMatches(m_pContext->CallStack.size() - 1);
+
+        if (!s_ValuePredicateSubtree || m_pContext->ValuePredicateMatches.empty())
+        {
+            mustMatch = TRUE;
+            traceValues = FALSE;
+
+            //A method without any predicates bound to its parameters can never match
+            if (pMethod->m_ValuePredicates.empty())
+                goto ErrExit;
+        }
+    }
+
     if (pMethod->m_NumParameters == 0)
     {
         WriteValue(&pMethod->m_NumParameters, 4);
@@ -93,6 +100,16 @@ HRESULT CValueTracer::EnterWithInfo(FunctionIDOrClientID functionId, COR_PRF_ELT
             argumentInfo
         ));
 
+        if (mustMatch)
+        {
+            IfFailGo(IsValuePredicateMatch(argumentInfo, pMethod, &traceValues));
+
+            if (!traceValues)
+                goto ErrExit;
+
+            m_pContext->ValuePredicateMatches.push_back(m_pContext->CallStack.size());
+        }
+
         CClassInfoResolver resolver(functionId, pMethod, frameInfo, this);
 
         DebugBlobHeader(L"Enter Start");
@@ -101,9 +118,14 @@ HRESULT CValueTracer::EnterWithInfo(FunctionIDOrClientID functionId, COR_PRF_ELT
     }
 
 ErrExit:
-    DebugBlobHeader(L"Enter End");
+    if (traceValues)
+    {
+        DebugBlobHeader(L"Enter End");
 
-    ValidateETW(EventWriteCallEnterDetailedEvent(functionId.functionID, g_Sequence, hr, g_ValueBufferPosition, g_ValueBuffer));
+        ValidateETW(EventWriteCallEnterDetailedEvent(functionId.functionID, m_pContext->Sequence, hr, m_pContext->ValueBufferPosition, m_pContext->ValueBuffer));
+    }
+    else
+        ValidateETW(EventWriteCallEnterEvent(functionId.functionID, m_pContext->Sequence, hr));
 
     if (argumentInfo != nullptr)
         free(argumentInfo);
@@ -129,8 +151,8 @@ HRESULT CValueTracer::LeaveWithInfo(FunctionIDOrClientID functionId, COR_PRF_ELT
 
     HRESULT hr = S_OK;
 
-    g_SeenMap.clear();
-    g_ValueBufferPosition = 0;
+    m_pContext->SeenMap.clear();
+    m_pContext->ValueBufferPosition = 0;
 
     CSigMethodDef* pMethod = nullptr;
 
@@ -143,6 +165,12 @@ HRESULT CValueTracer::LeaveWithInfo(FunctionIDOrClientID functionId, COR_PRF_ELT
     long genericIndex = -1;
     CSigType* pType;
 
+    if (!ShouldTraceLeave())
+    {
+        ValidateETW(EventWriteCallLeaveEvent(functionId.functionID, m_pContext->Sequence, hr));
+        return hr;
+    }
+
     //Lock scope
     {
         CLock methodLock(&g_pProfiler->m_MethodMutex);
@@ -188,7 +216,7 @@ HRESULT CValueTracer::LeaveWithInfo(FunctionIDOrClientID functionId, COR_PRF_ELT
 ErrExit:
     DebugBlobHeader(L"Return End");
 
-    ValidateETW(EventWriteCallLeaveDetailedEvent(functionId.functionID, g_Sequence, hr, g_ValueBufferPosition, g_ValueBuffer));
+    ValidateETW(EventWriteCallLeaveDetailedEvent(functionId.functionID, m_pContext->Sequence, hr, m_pContext->ValueBufferPosition, m_pContext->ValueBuffer));
 
     return hr;
 }
@@ -197,18 +225,257 @@ HRESULT CValueTracer::TailcallWithInfo(FunctionIDOrClientID functionId, COR_PRF_
 {
     HRESULT hr = S_OK;
     CSigMethodDef* pMethod;
-    g_ValueBufferPosition = 0;
+    m_pContext->ValueBufferPosition = 0;
+
+    if (!ShouldTraceLeave())
+    {
+        ValidateETW(EventWriteTailcallEvent(functionId.functionID, m_pContext->Sequence, hr));
+        return hr;
+    }
 
     CLock methodLock(&g_pProfiler->m_MethodMutex);
 
     //HRESULT needs to be reported to profiler controller
     hr = GetMethodInfoNoLock(functionId, &pMethod);
 
-    ValidateETW(EventWriteTailcallDetailedEvent(functionId.functionID, g_Sequence, hr, 0, NULL));
+    ValidateETW(EventWriteTailcallDetailedEvent(functionId.functionID, m_pContext->Sequence, hr, 0, NULL));
+
+    return hr;
+}
+
+#pragma endregion
+#pragma region Value Predicates
+
+/// <summary>
+/// Reads the value predicates specified in the DEBUGTOOLS_VALUEPREDICATES environment variable. Each predicate is of the form
+/// {kind}{method}\t{parameter}\t{value}\t, with the list being terminated by an additional \t.
+/// </summary>
+void CValueTracer::GetValuePredicates()
+{
+#define PREDICATE_BUFFER_SIZE 4000
+
+    WCHAR szBuffer[PREDICATE_BUFFER_SIZE];
+    int length = GetSetting(L"DEBUGTOOLS_VALUEPREDICATES", szBuffer, PREDICATE_BUFFER_SIZE);
+
+    if (length == 0 || length >= PREDICATE_BUFFER_SIZE)
+        return;
+
+    WCHAR* ptr = szBuffer;
+    WCHAR* end = szBuffer + length;
+
+    while (ptr < end && *ptr != '\t')
+    {
+        ValuePredicateKind kind = (ValuePredicateKind)*ptr;
+        ptr++;
+
+        LPWSTR fields[3];
+
+        for (int i = 0; i < 3; i++)
+        {
+            fields[i] = ptr;
+
+            while (ptr < end && *ptr != '\t')
+                ptr++;
+
+            //Malformed predicate
+            if (ptr >= end)
+                return;
+
+            *ptr = '\0';
+            ptr++;
+        }
+
+        s_ValuePredicates.emplace_back();
+        CValuePredicate& predicate = s_ValuePredicates[s_ValuePredicates.size() - 1];
+        predicate.m_Kind = kind;
+        predicate.m_szMethodName = _wcsdup(fields[0]);
+        predicate.m_szParameterName = _wcsdup(fields[1]);
+        predicate.SetValue(_wcsdup(fields[2]));
+    }
+}
+
+/// <summary>
+/// Resolves the parameters that any value predicates targeting the specified method apply to.
+/// </summary>
+/// <param name="pMDI">The metadata import of the module that contains the method.</param>
+/// <param name="methodDef">The token of the method whose parameters should be enumerated.</param>
+/// <param name="pMethod">The method that any predicates should be bound to.</param>
+/// <returns>A HRESULT that indicates success or failure.</returns>
+HRESULT CValueTracer::BindValuePredicates(IMetaDataImport2* pMDI, mdMethodDef methodDef, CSigMethodDef* pMethod)
+{
+    HRESULT hr = S_OK;
+
+    HCORENUM hEnum = nullptr;
+    mdParamDef paramDef;
+    ULONG fetched;
+    ULONG sequence;
+    WCHAR szParamName[NAME_BUFFER_SIZE];
+
+    for (CValuePredicate& predicate : s_ValuePredicates)
+    {
+        if (wcscmp(predicate.m_szMethodName, pMethod->m_szName) != 0)
+            continue;
+
+        while ((hr = pMDI->EnumParams(&hEnum, methodDef, &paramDef, 1, &fetched)) == S_OK && fetched == 1)
+        {
+            IfFailGo(pMDI->GetParamProps(paramDef, NULL, &sequence, szParamName, NAME_BUFFER_SIZE, NULL, NULL, NULL, NULL, NULL));
+
+            //Sequence 0 refers to the return value
+            if (sequence == 0 || sequence > pMethod->m_NumParameters)
+                continue;
+
+            if (wcscmp(predicate.m_szParameterName, szParamName) == 0)
+            {
+                pMethod->m_ValuePredicates.emplace_back(sequence - 1, &predicate);
+                break;
+            }
+        }
+
+        IfFailGo(hr);
+        hr = S_OK;
+
+        pMDI->CloseEnum(hEnum);
+        hEnum = nullptr;
+    }
+
+ErrExit:
+    if (hEnum)
+        pMDI->CloseEnum(hEnum);
 
     return hr;
 }
 
+void CValueTracer::PruneValuePredicateMatches(size_t maxDepth)
+{
+    while (!m_pContext->ValuePredicateMatches.empty() && m_pContext->ValuePredicateMatches.back() > maxDepth)
+        m_pContext->ValuePredicateMatches.pop_back();
+}
+
+/// <summary>
+/// Determines whether the frame that was just popped by LEAVE_FUNCTION previously satisfied its value predicates
+/// (or was a child of a frame that did), and should therefore have its return value traced.
+/// </summary>
+BOOL CValueTracer::ShouldTraceLeave()
+{
+    if (s_ValuePredicates.empty())
+        return TRUE;
+
+    size_t depth = m_pContext->CallStack.size() + 1;
+
+    PruneValuePredicateMatches(depth);
+
+    if (m_pContext->ValuePredicateMatches.empty())
+        return FALSE;
+
+    if (m_pContext->ValuePredicateMatches.back() == depth)
+    {
+        m_pContext->ValuePredicateMatches.pop_back();
+        return TRUE;
+    }
+
+    return s_ValuePredicateSubtree;
+}
+
+HRESULT CValueTracer::IsValuePredicateMatch(
+    _In_ COR_PRF_FUNCTION_ARGUMENT_INFO* argumentInfo,
+    _In_ CSigMethodDef* pMethod,
+    _Out_ BOOL* pIsMatch)
+{
+    HRESULT hr = S_OK;
+
+    ULONG offset = 0;
+
+    if (pMethod->m_CallingConv & IMAGE_CEE_CS_CALLCONV_HASTHIS)
+        offset++;
+
+    *pIsMatch = FALSE;
+
+    //If the arguments can't be mapped to the parameters the predicates were bound to, the call can't be said to satisfy them.
+    //This isn't an error in the call itself, so the call simply isn't traced in detail
+    if (argumentInfo->numRanges - offset != pMethod->m_NumParameters)
+    {
+        dprintf(L"Cannot evaluate value predicates against %d ranges (after ignoring %d ranges) when %d parameters were expected\n", argumentInfo->numRanges - offset, offset, pMethod->m_NumParameters);
+        goto ErrExit;
+    }
+
+    //A call only matches when all of the predicates bound to it are satisfied
+    for (BoundValuePredicate& bound : pMethod->m_ValuePredicates)
+    {
+        COR_PRF_FUNCTION_ARGUMENT_RANGE* range = &argumentInfo->ranges[bound.ParameterIndex + offset];
+        CSigType* pType = pMethod->m_Parameters[bound.ParameterIndex]->m_pType;
+
+        if (!pType || !IsValuePredicateMatch(range->startAddress, pType, bound.Predicate))
+            goto ErrExit;
+    }
+
+    *pIsMatch = TRUE;
+
+ErrExit:
+    return hr;
+}
+
+BOOL CValueTracer::IsValuePredicateMatch(
+    _In_ UINT_PTR startAddress,
+    _In_ CSigType* pType,
+    _In_ CValuePredicate* pPredicate)
+{
+    if (pType->m_IsByRef)
+        startAddress = *(UINT_PTR*)startAddress;
+
+    if (startAddress == 0)
+        return pPredicate->IsMatch((LPCWSTR)nullptr);
+
+    switch (pType->m_Type)
+    {
+    case ELEMENT_TYPE_BOOLEAN:
+    case ELEMENT_TYPE_U1:
+        return pPredicate->IsMatch((LONGLONG)*(BYTE*)startAddress);
+
+    case ELEMENT_TYPE_I1:
+        return pPredicate->IsMatch((LONGLONG)*(INT8*)startAddress);
+
+    case ELEMENT_TYPE_CHAR:
+    case ELEMENT_TYPE_U2:
+        return pPredicate->IsMatch((LONGLONG)*(UINT16*)startAddress);
+
+    case ELEMENT_TYPE_I2:
+        return pPredicate->IsMatch((LONGLONG)*(INT16*)startAddress);
+
+    case ELEMENT_TYPE_I4:
+        return pPredicate->IsMatch((LONGLONG)*(INT32*)startAddress);
+
+    case ELEMENT_TYPE_U4:
+        return pPredicate->IsMatch((LONGLONG)*(UINT32*)startAddress);
+
+    case ELEMENT_TYPE_I8:
+    case ELEMENT_TYPE_U8:
+        return pPredicate->IsMatch(*(LONGLONG*)startAddress);
+
+    case ELEMENT_TYPE_I:
+    case ELEMENT_TYPE_U:
+        return pPredicate->IsMatch((LONGLONG)*(INT_PTR*)startAddress);
+
+    case ELEMENT_TYPE_STRING:
+    {
+        ObjectID objectId = *(ObjectID*)startAddress;
+
+        if (IsInvalidObject(objectId))
+            return pPredicate->IsMatch((LPCWSTR)nullptr);
+
+        ULONG length = *(ULONG*)((BYTE*)objectId + s_StringLengthOffset);
+        LPWSTR buffer = (LPWSTR)((BYTE*)objectId + s_StringBufferOffset);
+
+        std::wstring str(buffer, length);
+
+        return pPredicate->IsMatch(str.c_str());
+    }
+
+    default:
+        //Predicates can only be evaluated against primitive values and strings
+        return FALSE;
+    }
+}
+
 #pragma endregion
 #pragma region Parameters
 
@@ -303,7 +570,7 @@ HRESULT CValueTracer::TraceValue(
 
     BOOL needSeenMap = elementType == ELEMENT_TYPE_OBJECT || elementType == ELEMENT_TYPE_CLASS || elementType == ELEMENT_TYPE_GENERICINST || elementType == ELEMENT_TYPE_SZARRAY || elementType == ELEMENT_TYPE_ARRAY;
 
-    if (needSeenMap && g_SeenMap.find(startAddress) != g_SeenMap.end())
+    if (needSeenMap && m_pContext->SeenMap.find(startAddress) != m_pContext->SeenMap.end())
     {
         DebugBlob(L"Recursion");
         WriteRecursion(elementType);
@@ -358,7 +625,7 @@ HRESULT CValueTracer::TraceValue(
     m_TraceDepth++;
 
     if (needSeenMap)
-        g_SeenMap.insert(startAddress);
+        m_pContext->SeenMap.insert(startAddress);
 
     switch (elementType)
     {
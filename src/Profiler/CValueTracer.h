@@ -2,7 +2,14 @@
 
 #include <stack>
 #include <unordered_map>
+#include <vector>
 #include "CClassInfoResolver.h"
+#include "CValuePredicate.h"
+#include "CCallStackSnapshot.h"
+#include "CCallSuppressor.h"
+#include "CCpuTime.h"
+#include "CContinuousProfiler.h"
+#include "CThreadContext.h"
 
 class CSigMethodDef;
 class CSigType;
@@ -17,54 +24,43 @@ class ISigArrayType;
 
 #undef GetClassInfo
 
-#define VALUE_BUFFER_SIZE 62000 //ETW is limited to 64KB
+extern bool g_TracingEnabled;
 
-extern thread_local BYTE g_ValueBuffer[VALUE_BUFFER_SIZE];
-extern thread_local signed long g_ValueBufferPosition;
+#define ENTER_FUNCTION(CONTEXT, FUNCTIONID, ENTERKIND) ENTER_FUNCTION_EX(CONTEXT, FUNCTIONID, ENTERKIND, g_SuppressionEnabled)
 
-//Stores a number that uniquely identifies each Enter/Leave/Tailcall event for the current thread.
-extern thread_local ULONG g_Sequence;
-
-enum class FrameKind
-{
-    Managed = 0,
-    U2M,
-    M2U
-};
-
-struct Frame
-{
-    FunctionID FunctionId;
-    FrameKind Kind;
-
-    Frame(FunctionID functionId, FrameKind kind) :
-        FunctionId(functionId),
-        Kind(kind)
-    {
-    }
-};
-
-//Stores the current stack of function calls for the current thread.
-extern thread_local std::stack<Frame> g_CallStack;
-
-extern thread_local BOOL g_CheckM2UUnwind;
-
-#define ENTER_FUNCTION(FUNCTIONID, ENTERKIND) \
+//Hook stubs that are specialized for a given profiler mode pass SUPPRESS as a compile time constant
+#define ENTER_FUNCTION_EX(CONTEXT, FUNCTIONID, ENTERKIND, SUPPRESS) \
     do { \
-    g_Sequence++; \
-    LogSequence(L"Sequence is now %d %S(%d) (Enter)\n", g_Sequence, __FILE__, __LINE__); \
-    g_CallStack.emplace(FUNCTIONID, ENTERKIND); \
+    CHECK_CALLSTACK_SNAPSHOT(CONTEXT); \
+    /* A suppressed parent must be entered normally before its child, so that the child isn't attributed to the wrong parent */ \
+    if ((SUPPRESS) && !(CONTEXT)->CallStack.empty()) \
+    { \
+        if ((CONTEXT)->CallStack.top().Suppressed) \
+            CCallSuppressor::Unsuppress(CONTEXT); \
+        (CONTEXT)->CallStack.top().HasChildren = TRUE; \
+    } \
+    (CONTEXT)->Sequence++; \
+    LogSequence(L"Sequence is now %d %S(%d) (Enter)\n", (CONTEXT)->Sequence, __FILE__, __LINE__); \
+    (CONTEXT)->CallStack.emplace(FUNCTIONID, ENTERKIND, (CONTEXT)->CallStack.Hash()); \
+    if ((SUPPRESS) || g_ContinuousEnabled) \
+        QueryPerformanceCounter((LARGE_INTEGER*)&(CONTEXT)->CallStack.top().EnterQPC); \
+    if (g_CpuTimeEnabled) \
+        CCpuTime::Enter((CONTEXT)->CallStack.top()); \
     } while(0)
 
-#define LEAVE_FUNCTION(FUNCTIONID) \
-    g_Sequence++; \
+#define LEAVE_FUNCTION(CONTEXT, FUNCTIONID) LEAVE_FUNCTION_EX(CONTEXT, FUNCTIONID, nullptr)
+
+//Hooks pass the record of the function being left, so that continuous profiling can accumulate its durations against it
+#define LEAVE_FUNCTION_EX(CONTEXT, FUNCTIONID, PRECORD) \
+    CHECK_CALLSTACK_SNAPSHOT(CONTEXT); \
+    (CONTEXT)->Sequence++; \
     do { \
-        LogSequence(L"Sequence is now %d %S(%d) (Leave)\n", g_Sequence, __FILE__, __LINE__); \
+        LogSequence(L"Sequence is now %d %S(%d) (Leave)\n", (CONTEXT)->Sequence, __FILE__, __LINE__); \
         /* If we started tracing after process start, we may see a series of leaves for enters that we never recorded */ \
-        if (!g_CallStack.empty()) \
+        if (!(CONTEXT)->CallStack.empty()) \
         { \
-            Frame old = g_CallStack.top(); \
-            g_CallStack.pop(); \
+            Frame old = (CONTEXT)->CallStack.top(); \
+            (CONTEXT)->CallStack.pop(); \
             if (old.FunctionId != (FUNCTIONID)) \
             { \
                 dprintf(L"Stack Error: Expected " FORMAT_PTR " but got " FORMAT_PTR "\n", old.FunctionId, FUNCTIONID); \
@@ -72,33 +68,37 @@ extern thread_local BOOL g_CheckM2UUnwind;
                 hr = PROFILER_E_UNKNOWN_FRAME; \
                 goto ErrExit; \
             } \
+            if (g_CpuTimeEnabled) \
+                CCpuTime::Leave((CONTEXT), old); \
+            if (g_ContinuousEnabled) \
+                CContinuousProfiler::Leave((CONTEXT), old, (PRECORD)); \
         } \
     } while(0)
 
 //An extra -1 on comparing the buffer size because the maximum index is VALUE_BUFFER_SIZE - 1 (arrays are 0 based!)
 
 #define WriteType(elementType) \
-    do { if (g_ValueBufferPosition >= VALUE_BUFFER_SIZE - 1 - 1) \
+    do { if (m_pContext->ValueBufferPosition >= VALUE_BUFFER_SIZE - 1 - 1) \
     { \
         hr = PROFILER_E_BUFFERFULL; \
         LogError("WriteType"); \
         goto ErrExit; \
     } \
-    *(g_ValueBuffer + g_ValueBufferPosition) = elementType; \
-    g_ValueBufferPosition++; \
-    if (g_ValueBufferPosition >= VALUE_BUFFER_SIZE) DebugBreakSafe(); \
+    *(m_pContext->ValueBuffer + m_pContext->ValueBufferPosition) = elementType; \
+    m_pContext->ValueBufferPosition++; \
+    if (m_pContext->ValueBufferPosition >= VALUE_BUFFER_SIZE) DebugBreakSafe(); \
     } while(0)
 
 #define WriteValue(pValue, length) \
-    do { if (g_ValueBufferPosition >= VALUE_BUFFER_SIZE - (int)(length) - 1) \
+    do { if (m_pContext->ValueBufferPosition >= VALUE_BUFFER_SIZE - (int)(length) - 1) \
     { \
         hr = PROFILER_E_BUFFERFULL; \
         LogError("WriteValue"); \
         goto ErrExit; \
     } \
-    memcpy(g_ValueBuffer + g_ValueBufferPosition, pValue, length); \
-    g_ValueBufferPosition += length; \
-    if (g_ValueBufferPosition >= VALUE_BUFFER_SIZE) DebugBreakSafe(); \
+    memcpy(m_pContext->ValueBuffer + m_pContext->ValueBufferPosition, pValue, length); \
+    m_pContext->ValueBufferPosition += length; \
+    if (m_pContext->ValueBufferPosition >= VALUE_BUFFER_SIZE) DebugBreakSafe(); \
     } while(0)
 
 #define Write(pValue, elementType, expectedSize) \
@@ -109,12 +109,12 @@ extern thread_local BOOL g_CheckM2UUnwind;
 #define WriteRecursion(elementType) \
     do { WriteType(ELEMENT_TYPE_END); \
     WriteType(elementType); \
-    if (g_ValueBufferPosition > VALUE_BUFFER_SIZE) DebugBreakSafe(); \
+    if (m_pContext->ValueBufferPosition > VALUE_BUFFER_SIZE) DebugBreakSafe(); \
     } while(0)
 
 #define WriteMaxTraceDepth() \
     do { WriteType(ELEMENT_TYPE_END); \
-    WriteType(ELEMENT_TYPE_END); if (g_ValueBufferPosition > VALUE_BUFFER_SIZE) DebugBreakSafe(); \
+    WriteType(ELEMENT_TYPE_END); if (m_pContext->ValueBufferPosition > VALUE_BUFFER_SIZE) DebugBreakSafe(); \
     } while(0)
 
 typedef struct _ValueTypeContext {
@@ -159,7 +159,8 @@ class CSigField;
 class CValueTracer
 {
 public:
-    CValueTracer() :
+    CValueTracer(CThreadContext* pContext) :
+        m_pContext(pContext),
         m_TraceDepth(0),
         m_MethodGenericTypeArgs(nullptr)
     {
@@ -173,6 +174,7 @@ public:
     }
 
     static HRESULT Initialize(ICorProfilerInfo4* pInfo);
+    static HRESULT BindValuePredicates(IMetaDataImport2* pMDI, mdMethodDef methodDef, CSigMethodDef* pMethod);
     FORCEINLINE static BOOL IsInvalidObject(ObjectID objectId);
     static BOOL IsInvalidPointer(ObjectID objectId);
 
@@ -189,6 +191,20 @@ private:
 
     HRESULT GetMethodInfoNoLock(_In_ FunctionIDOrClientID functionId, _Out_ CSigMethodDef** ppMethod);
 
+    static void GetValuePredicates();
+    void PruneValuePredicateMatches(size_t maxDepth);
+    BOOL ShouldTraceLeave();
+
+    HRESULT IsValuePredicateMatch(
+        _In_ COR_PRF_FUNCTION_ARGUMENT_INFO* argumentInfo,
+        _In_ CSigMethodDef* pMethod,
+        _Out_ BOOL* pIsMatch);
+
+    BOOL IsValuePredicateMatch(
+        _In_ UINT_PTR startAddress,
+        _In_ CSigType* pType,
+        _In_ CValuePredicate* pPredicate);
+
     HRESULT TraceParameters(
         _In_ COR_PRF_FUNCTION_ARGUMENT_INFO* argumentInfo,
         _In_ CSigMethodDef* pMethod,
@@ -316,6 +332,12 @@ private:
     static ULONG s_MaxTraceDepth;
     static BOOL s_IgnorePointerValue;
 
+    //Bound predicates point directly into this vector, so it must not be modified after Initialize() has completed
+    static std::vector<CValuePredicate> s_ValuePredicates;
+    static BOOL s_ValuePredicateSubtree;
+
+    //The context of the thread the tracer was created on. Tracers are always used on the thread that created them
+    CThreadContext* m_pContext;
     ULONG m_TraceDepth;
 
 public:
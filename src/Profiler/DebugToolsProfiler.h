@@ -659,7 +659,7 @@ Remarks:
 #endif // MCGEN_DISABLE_PROVIDER_CODE_GENERATION
 
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-// Provider "DebugToolsProfiler" event count 19
+// Provider "DebugToolsProfiler" event count 34
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 // Provider GUID = c6f30827-dd2d-4fee-ad2e-bba0ce6cbd8f
@@ -721,6 +721,36 @@ EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR ThreadNameEvent = {0x12, 0
 #define ThreadNameEvent_value 0x12
 EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR ShutdownEvent = {0x13, 0x0, 0x0, 0x5, 0x0, 0x0, 0x8};
 #define ShutdownEvent_value 0x13
+EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR FlightRecorderDumpEvent = {0x14, 0x0, 0x0, 0x5, 0x0, 0x0, 0x8};
+#define FlightRecorderDumpEvent_value 0x14
+EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR CallStackSnapshotEvent = {0x15, 0x0, 0x0, 0x5, 0x0, 0x0, 0x8000000000};
+#define CallStackSnapshotEvent_value 0x15
+EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR CallCompleteEvent = {0x16, 0x0, 0x0, 0x5, 0x0, 0x0, 0x8000000000};
+#define CallCompleteEvent_value 0x16
+EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR CallRepeatedEvent = {0x17, 0x0, 0x0, 0x5, 0x0, 0x0, 0x8000000000};
+#define CallRepeatedEvent_value 0x17
+EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR FunctionSuppressedEvent = {0x18, 0x0, 0x0, 0x5, 0x0, 0x0, 0x1};
+#define FunctionSuppressedEvent_value 0x18
+EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR SuppressedFunctionsEvent = {0x19, 0x0, 0x0, 0x5, 0x0, 0x0, 0x1};
+#define SuppressedFunctionsEvent_value 0x19
+EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR StackDefinedEvent = {0x1a, 0x0, 0x0, 0x5, 0x0, 0x0, 0x8000000000};
+#define StackDefinedEvent_value 0x1a
+EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR StackSampleEvent = {0x1b, 0x0, 0x0, 0x5, 0x0, 0x0, 0x8000000000};
+#define StackSampleEvent_value 0x1b
+EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR MethodCoveredEvent = {0x1c, 0x0, 0x0, 0x5, 0x0, 0x0, 0x1};
+#define MethodCoveredEvent_value 0x1c
+EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR CoveredFunctionsEvent = {0x1d, 0x0, 0x0, 0x5, 0x0, 0x0, 0x1};
+#define CoveredFunctionsEvent_value 0x1d
+EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR CallCpuTimeEvent = {0x1e, 0x0, 0x0, 0x5, 0x0, 0x0, 0x8000000000};
+#define CallCpuTimeEvent_value 0x1e
+EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR HookOverheadEvent = {0x1f, 0x0, 0x0, 0x5, 0x0, 0x0, 0x8};
+#define HookOverheadEvent_value 0x1f
+EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR ContinuousSnapshotEvent = {0x20, 0x0, 0x0, 0x5, 0x0, 0x0, 0x1};
+#define ContinuousSnapshotEvent_value 0x20
+EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR PInvokeStatsEvent = {0x21, 0x0, 0x0, 0x5, 0x0, 0x0, 0x1};
+#define PInvokeStatsEvent_value 0x21
+EXTERN_C __declspec(selectany) const EVENT_DESCRIPTOR SlowCallEvent = {0x22, 0x0, 0x0, 0x5, 0x0, 0x0, 0x4};
+#define SlowCallEvent_value 0x22
 
 //
 // MCGEN_DISABLE_PROVIDER_CODE_GENERATION macro:
@@ -1294,6 +1324,351 @@ _mcgen_CheckContextType_DebugToolsProfiler(_In_ McGenContext_DebugToolsProfiler*
 // This macro is for use by MC-generated code and should not be used directly.
 #define _mcgen_TEMPLATE_FOR_ShutdownEvent _mcgen_PASTE2(McTemplateU0_, MCGEN_EVENTWRITETRANSFER)
 
+//
+// Enablement check macro for event "FlightRecorderDumpEvent"
+//
+#define EventEnabledFlightRecorderDumpEvent() _mcgen_EVENT_BIT_SET(DebugToolsProfilerEnableBits, 6)
+#define EventEnabledFlightRecorderDumpEvent_ForContext(pContext) _mcgen_EVENT_BIT_SET(_mcgen_CheckContextType_DebugToolsProfiler(pContext)->EnableBits, 6)
+
+//
+// Event write macros for event "FlightRecorderDumpEvent"
+//
+#define EventWriteFlightRecorderDumpEvent(Reason) \
+        MCGEN_EVENT_ENABLED(FlightRecorderDumpEvent) \
+        ? _mcgen_TEMPLATE_FOR_FlightRecorderDumpEvent(&DebugToolsProfiler_Context, &FlightRecorderDumpEvent, Reason) : 0
+#define EventWriteFlightRecorderDumpEvent_AssumeEnabled(Reason) \
+        _mcgen_TEMPLATE_FOR_FlightRecorderDumpEvent(&DebugToolsProfiler_Context, &FlightRecorderDumpEvent, Reason)
+#define EventWriteFlightRecorderDumpEvent_ForContext(pContext, Reason) \
+        MCGEN_EVENT_ENABLED_FORCONTEXT(pContext, FlightRecorderDumpEvent) \
+        ? _mcgen_TEMPLATE_FOR_FlightRecorderDumpEvent(&(pContext)->Context, &FlightRecorderDumpEvent, Reason) : 0
+#define EventWriteFlightRecorderDumpEvent_ForContextAssumeEnabled(pContext, Reason) \
+        _mcgen_TEMPLATE_FOR_FlightRecorderDumpEvent(&_mcgen_CheckContextType_DebugToolsProfiler(pContext)->Context, &FlightRecorderDumpEvent, Reason)
+
+// This macro is for use by MC-generated code and should not be used directly.
+#define _mcgen_TEMPLATE_FOR_FlightRecorderDumpEvent _mcgen_PASTE2(McTemplateU0d_, MCGEN_EVENTWRITETRANSFER)
+
+//
+// Enablement check macro for event "CallStackSnapshotEvent"
+//
+#define EventEnabledCallStackSnapshotEvent() _mcgen_EVENT_BIT_SET(DebugToolsProfilerEnableBits, 0)
+#define EventEnabledCallStackSnapshotEvent_ForContext(pContext) _mcgen_EVENT_BIT_SET(_mcgen_CheckContextType_DebugToolsProfiler(pContext)->EnableBits, 0)
+
+//
+// Event write macros for event "CallStackSnapshotEvent"
+//
+#define EventWriteCallStackSnapshotEvent(Sequence, FramesLength, Frames) \
+        MCGEN_EVENT_ENABLED(CallStackSnapshotEvent) \
+        ? _mcgen_TEMPLATE_FOR_CallStackSnapshotEvent(&DebugToolsProfiler_Context, &CallStackSnapshotEvent, Sequence, FramesLength, Frames) : 0
+#define EventWriteCallStackSnapshotEvent_AssumeEnabled(Sequence, FramesLength, Frames) \
+        _mcgen_TEMPLATE_FOR_CallStackSnapshotEvent(&DebugToolsProfiler_Context, &CallStackSnapshotEvent, Sequence, FramesLength, Frames)
+#define EventWriteCallStackSnapshotEvent_ForContext(pContext, Sequence, FramesLength, Frames) \
+        MCGEN_EVENT_ENABLED_FORCONTEXT(pContext, CallStackSnapshotEvent) \
+        ? _mcgen_TEMPLATE_FOR_CallStackSnapshotEvent(&(pContext)->Context, &CallStackSnapshotEvent, Sequence, FramesLength, Frames) : 0
+#define EventWriteCallStackSnapshotEvent_ForContextAssumeEnabled(pContext, Sequence, FramesLength, Frames) \
+        _mcgen_TEMPLATE_FOR_CallStackSnapshotEvent(&_mcgen_CheckContextType_DebugToolsProfiler(pContext)->Context, &CallStackSnapshotEvent, Sequence, FramesLength, Frames)
+
+// This macro is for use by MC-generated code and should not be used directly.
+#define _mcgen_TEMPLATE_FOR_CallStackSnapshotEvent _mcgen_PASTE2(McTemplateU0xqbr1_, MCGEN_EVENTWRITETRANSFER)
+
+//
+// Enablement check macro for event "CallCompleteEvent"
+//
+#define EventEnabledCallCompleteEvent() _mcgen_EVENT_BIT_SET(DebugToolsProfilerEnableBits, 0)
+#define EventEnabledCallCompleteEvent_ForContext(pContext) _mcgen_EVENT_BIT_SET(_mcgen_CheckContextType_DebugToolsProfiler(pContext)->EnableBits, 0)
+
+//
+// Event write macros for event "CallCompleteEvent"
+//
+#define EventWriteCallCompleteEvent(FunctionID, Sequence, HRESULT, Duration) \
+        MCGEN_EVENT_ENABLED(CallCompleteEvent) \
+        ? _mcgen_TEMPLATE_FOR_CallCompleteEvent(&DebugToolsProfiler_Context, &CallCompleteEvent, FunctionID, Sequence, HRESULT, Duration) : 0
+#define EventWriteCallCompleteEvent_AssumeEnabled(FunctionID, Sequence, HRESULT, Duration) \
+        _mcgen_TEMPLATE_FOR_CallCompleteEvent(&DebugToolsProfiler_Context, &CallCompleteEvent, FunctionID, Sequence, HRESULT, Duration)
+#define EventWriteCallCompleteEvent_ForContext(pContext, FunctionID, Sequence, HRESULT, Duration) \
+        MCGEN_EVENT_ENABLED_FORCONTEXT(pContext, CallCompleteEvent) \
+        ? _mcgen_TEMPLATE_FOR_CallCompleteEvent(&(pContext)->Context, &CallCompleteEvent, FunctionID, Sequence, HRESULT, Duration) : 0
+#define EventWriteCallCompleteEvent_ForContextAssumeEnabled(pContext, FunctionID, Sequence, HRESULT, Duration) \
+        _mcgen_TEMPLATE_FOR_CallCompleteEvent(&_mcgen_CheckContextType_DebugToolsProfiler(pContext)->Context, &CallCompleteEvent, FunctionID, Sequence, HRESULT, Duration)
+
+// This macro is for use by MC-generated code and should not be used directly.
+#define _mcgen_TEMPLATE_FOR_CallCompleteEvent _mcgen_PASTE2(McTemplateU0xxdx_, MCGEN_EVENTWRITETRANSFER)
+
+//
+// Enablement check macro for event "CallRepeatedEvent"
+//
+#define EventEnabledCallRepeatedEvent() _mcgen_EVENT_BIT_SET(DebugToolsProfilerEnableBits, 0)
+#define EventEnabledCallRepeatedEvent_ForContext(pContext) _mcgen_EVENT_BIT_SET(_mcgen_CheckContextType_DebugToolsProfiler(pContext)->EnableBits, 0)
+
+//
+// Event write macros for event "CallRepeatedEvent"
+//
+#define EventWriteCallRepeatedEvent(FunctionID, Sequence, Count, TotalDuration, MinDuration, MaxDuration) \
+        MCGEN_EVENT_ENABLED(CallRepeatedEvent) \
+        ? _mcgen_TEMPLATE_FOR_CallRepeatedEvent(&DebugToolsProfiler_Context, &CallRepeatedEvent, FunctionID, Sequence, Count, TotalDuration, MinDuration, MaxDuration) : 0
+#define EventWriteCallRepeatedEvent_AssumeEnabled(FunctionID, Sequence, Count, TotalDuration, MinDuration, MaxDuration) \
+        _mcgen_TEMPLATE_FOR_CallRepeatedEvent(&DebugToolsProfiler_Context, &CallRepeatedEvent, FunctionID, Sequence, Count, TotalDuration, MinDuration, MaxDuration)
+#define EventWriteCallRepeatedEvent_ForContext(pContext, FunctionID, Sequence, Count, TotalDuration, MinDuration, MaxDuration) \
+        MCGEN_EVENT_ENABLED_FORCONTEXT(pContext, CallRepeatedEvent) \
+        ? _mcgen_TEMPLATE_FOR_CallRepeatedEvent(&(pContext)->Context, &CallRepeatedEvent, FunctionID, Sequence, Count, TotalDuration, MinDuration, MaxDuration) : 0
+#define EventWriteCallRepeatedEvent_ForContextAssumeEnabled(pContext, FunctionID, Sequence, Count, TotalDuration, MinDuration, MaxDuration) \
+        _mcgen_TEMPLATE_FOR_CallRepeatedEvent(&_mcgen_CheckContextType_DebugToolsProfiler(pContext)->Context, &CallRepeatedEvent, FunctionID, Sequence, Count, TotalDuration, MinDuration, MaxDuration)
+
+// This macro is for use by MC-generated code and should not be used directly.
+#define _mcgen_TEMPLATE_FOR_CallRepeatedEvent _mcgen_PASTE2(McTemplateU0xxqxxx_, MCGEN_EVENTWRITETRANSFER)
+
+//
+// Enablement check macro for event "FunctionSuppressedEvent"
+//
+#define EventEnabledFunctionSuppressedEvent() _mcgen_EVENT_BIT_SET(DebugToolsProfilerEnableBits, 3)
+#define EventEnabledFunctionSuppressedEvent_ForContext(pContext) _mcgen_EVENT_BIT_SET(_mcgen_CheckContextType_DebugToolsProfiler(pContext)->EnableBits, 3)
+
+//
+// Event write macros for event "FunctionSuppressedEvent"
+//
+#define EventWriteFunctionSuppressedEvent(FunctionID, CallCount, CallRate, AverageDuration) \
+        MCGEN_EVENT_ENABLED(FunctionSuppressedEvent) \
+        ? _mcgen_TEMPLATE_FOR_FunctionSuppressedEvent(&DebugToolsProfiler_Context, &FunctionSuppressedEvent, FunctionID, CallCount, CallRate, AverageDuration) : 0
+#define EventWriteFunctionSuppressedEvent_AssumeEnabled(FunctionID, CallCount, CallRate, AverageDuration) \
+        _mcgen_TEMPLATE_FOR_FunctionSuppressedEvent(&DebugToolsProfiler_Context, &FunctionSuppressedEvent, FunctionID, CallCount, CallRate, AverageDuration)
+#define EventWriteFunctionSuppressedEvent_ForContext(pContext, FunctionID, CallCount, CallRate, AverageDuration) \
+        MCGEN_EVENT_ENABLED_FORCONTEXT(pContext, FunctionSuppressedEvent) \
+        ? _mcgen_TEMPLATE_FOR_FunctionSuppressedEvent(&(pContext)->Context, &FunctionSuppressedEvent, FunctionID, CallCount, CallRate, AverageDuration) : 0
+#define EventWriteFunctionSuppressedEvent_ForContextAssumeEnabled(pContext, FunctionID, CallCount, CallRate, AverageDuration) \
+        _mcgen_TEMPLATE_FOR_FunctionSuppressedEvent(&_mcgen_CheckContextType_DebugToolsProfiler(pContext)->Context, &FunctionSuppressedEvent, FunctionID, CallCount, CallRate, AverageDuration)
+
+// This macro is for use by MC-generated code and should not be used directly.
+#define _mcgen_TEMPLATE_FOR_FunctionSuppressedEvent _mcgen_PASTE2(McTemplateU0xxxx_, MCGEN_EVENTWRITETRANSFER)
+
+//
+// Enablement check macro for event "SuppressedFunctionsEvent"
+//
+#define EventEnabledSuppressedFunctionsEvent() _mcgen_EVENT_BIT_SET(DebugToolsProfilerEnableBits, 3)
+#define EventEnabledSuppressedFunctionsEvent_ForContext(pContext) _mcgen_EVENT_BIT_SET(_mcgen_CheckContextType_DebugToolsProfiler(pContext)->EnableBits, 3)
+
+//
+// Event write macros for event "SuppressedFunctionsEvent"
+//
+#define EventWriteSuppressedFunctionsEvent(FunctionIDsLength, FunctionIDs) \
+        MCGEN_EVENT_ENABLED(SuppressedFunctionsEvent) \
+        ? _mcgen_TEMPLATE_FOR_SuppressedFunctionsEvent(&DebugToolsProfiler_Context, &SuppressedFunctionsEvent, FunctionIDsLength, FunctionIDs) : 0
+#define EventWriteSuppressedFunctionsEvent_AssumeEnabled(FunctionIDsLength, FunctionIDs) \
+        _mcgen_TEMPLATE_FOR_SuppressedFunctionsEvent(&DebugToolsProfiler_Context, &SuppressedFunctionsEvent, FunctionIDsLength, FunctionIDs)
+#define EventWriteSuppressedFunctionsEvent_ForContext(pContext, FunctionIDsLength, FunctionIDs) \
+        MCGEN_EVENT_ENABLED_FORCONTEXT(pContext, SuppressedFunctionsEvent) \
+        ? _mcgen_TEMPLATE_FOR_SuppressedFunctionsEvent(&(pContext)->Context, &SuppressedFunctionsEvent, FunctionIDsLength, FunctionIDs) : 0
+#define EventWriteSuppressedFunctionsEvent_ForContextAssumeEnabled(pContext, FunctionIDsLength, FunctionIDs) \
+        _mcgen_TEMPLATE_FOR_SuppressedFunctionsEvent(&_mcgen_CheckContextType_DebugToolsProfiler(pContext)->Context, &SuppressedFunctionsEvent, FunctionIDsLength, FunctionIDs)
+
+// This macro is for use by MC-generated code and should not be used directly.
+#define _mcgen_TEMPLATE_FOR_SuppressedFunctionsEvent _mcgen_PASTE2(McTemplateU0qbr0_, MCGEN_EVENTWRITETRANSFER)
+
+//
+// Enablement check macro for event "StackDefinedEvent"
+//
+#define EventEnabledStackDefinedEvent() _mcgen_EVENT_BIT_SET(DebugToolsProfilerEnableBits, 0)
+#define EventEnabledStackDefinedEvent_ForContext(pContext) _mcgen_EVENT_BIT_SET(_mcgen_CheckContextType_DebugToolsProfiler(pContext)->EnableBits, 0)
+
+//
+// Event write macros for event "StackDefinedEvent"
+//
+#define EventWriteStackDefinedEvent(StackID, FramesLength, Frames) \
+        MCGEN_EVENT_ENABLED(StackDefinedEvent) \
+        ? _mcgen_TEMPLATE_FOR_StackDefinedEvent(&DebugToolsProfiler_Context, &StackDefinedEvent, StackID, FramesLength, Frames) : 0
+#define EventWriteStackDefinedEvent_AssumeEnabled(StackID, FramesLength, Frames) \
+        _mcgen_TEMPLATE_FOR_StackDefinedEvent(&DebugToolsProfiler_Context, &StackDefinedEvent, StackID, FramesLength, Frames)
+#define EventWriteStackDefinedEvent_ForContext(pContext, StackID, FramesLength, Frames) \
+        MCGEN_EVENT_ENABLED_FORCONTEXT(pContext, StackDefinedEvent) \
+        ? _mcgen_TEMPLATE_FOR_StackDefinedEvent(&(pContext)->Context, &StackDefinedEvent, StackID, FramesLength, Frames) : 0
+#define EventWriteStackDefinedEvent_ForContextAssumeEnabled(pContext, StackID, FramesLength, Frames) \
+        _mcgen_TEMPLATE_FOR_StackDefinedEvent(&_mcgen_CheckContextType_DebugToolsProfiler(pContext)->Context, &StackDefinedEvent, StackID, FramesLength, Frames)
+
+// This macro is for use by MC-generated code and should not be used directly.
+#define _mcgen_TEMPLATE_FOR_StackDefinedEvent _mcgen_PASTE2(McTemplateU0qqbr1_, MCGEN_EVENTWRITETRANSFER)
+
+//
+// Enablement check macro for event "StackSampleEvent"
+//
+#define EventEnabledStackSampleEvent() _mcgen_EVENT_BIT_SET(DebugToolsProfilerEnableBits, 0)
+#define EventEnabledStackSampleEvent_ForContext(pContext) _mcgen_EVENT_BIT_SET(_mcgen_CheckContextType_DebugToolsProfiler(pContext)->EnableBits, 0)
+
+//
+// Event write macros for event "StackSampleEvent"
+//
+#define EventWriteStackSampleEvent(SamplesLength, Samples) \
+        MCGEN_EVENT_ENABLED(StackSampleEvent) \
+        ? _mcgen_TEMPLATE_FOR_StackSampleEvent(&DebugToolsProfiler_Context, &StackSampleEvent, SamplesLength, Samples) : 0
+#define EventWriteStackSampleEvent_AssumeEnabled(SamplesLength, Samples) \
+        _mcgen_TEMPLATE_FOR_StackSampleEvent(&DebugToolsProfiler_Context, &StackSampleEvent, SamplesLength, Samples)
+#define EventWriteStackSampleEvent_ForContext(pContext, SamplesLength, Samples) \
+        MCGEN_EVENT_ENABLED_FORCONTEXT(pContext, StackSampleEvent) \
+        ? _mcgen_TEMPLATE_FOR_StackSampleEvent(&(pContext)->Context, &StackSampleEvent, SamplesLength, Samples) : 0
+#define EventWriteStackSampleEvent_ForContextAssumeEnabled(pContext, SamplesLength, Samples) \
+        _mcgen_TEMPLATE_FOR_StackSampleEvent(&_mcgen_CheckContextType_DebugToolsProfiler(pContext)->Context, &StackSampleEvent, SamplesLength, Samples)
+
+// This macro is for use by MC-generated code and should not be used directly.
+#define _mcgen_TEMPLATE_FOR_StackSampleEvent _mcgen_PASTE2(McTemplateU0qbr0_, MCGEN_EVENTWRITETRANSFER)
+
+//
+// Enablement check macro for event "MethodCoveredEvent"
+//
+#define EventEnabledMethodCoveredEvent() _mcgen_EVENT_BIT_SET(DebugToolsProfilerEnableBits, 3)
+#define EventEnabledMethodCoveredEvent_ForContext(pContext) _mcgen_EVENT_BIT_SET(_mcgen_CheckContextType_DebugToolsProfiler(pContext)->EnableBits, 3)
+
+//
+// Event write macros for event "MethodCoveredEvent"
+//
+#define EventWriteMethodCoveredEvent(FunctionID) \
+        MCGEN_EVENT_ENABLED(MethodCoveredEvent) \
+        ? _mcgen_TEMPLATE_FOR_MethodCoveredEvent(&DebugToolsProfiler_Context, &MethodCoveredEvent, FunctionID) : 0
+#define EventWriteMethodCoveredEvent_AssumeEnabled(FunctionID) \
+        _mcgen_TEMPLATE_FOR_MethodCoveredEvent(&DebugToolsProfiler_Context, &MethodCoveredEvent, FunctionID)
+#define EventWriteMethodCoveredEvent_ForContext(pContext, FunctionID) \
+        MCGEN_EVENT_ENABLED_FORCONTEXT(pContext, MethodCoveredEvent) \
+        ? _mcgen_TEMPLATE_FOR_MethodCoveredEvent(&(pContext)->Context, &MethodCoveredEvent, FunctionID) : 0
+#define EventWriteMethodCoveredEvent_ForContextAssumeEnabled(pContext, FunctionID) \
+        _mcgen_TEMPLATE_FOR_MethodCoveredEvent(&_mcgen_CheckContextType_DebugToolsProfiler(pContext)->Context, &MethodCoveredEvent, FunctionID)
+
+// This macro is for use by MC-generated code and should not be used directly.
+#define _mcgen_TEMPLATE_FOR_MethodCoveredEvent _mcgen_PASTE2(McTemplateU0x_, MCGEN_EVENTWRITETRANSFER)
+
+//
+// Enablement check macro for event "CoveredFunctionsEvent"
+//
+#define EventEnabledCoveredFunctionsEvent() _mcgen_EVENT_BIT_SET(DebugToolsProfilerEnableBits, 3)
+#define EventEnabledCoveredFunctionsEvent_ForContext(pContext) _mcgen_EVENT_BIT_SET(_mcgen_CheckContextType_DebugToolsProfiler(pContext)->EnableBits, 3)
+
+//
+// Event write macros for event "CoveredFunctionsEvent"
+//
+#define EventWriteCoveredFunctionsEvent(Final, FunctionIDsLength, FunctionIDs) \
+        MCGEN_EVENT_ENABLED(CoveredFunctionsEvent) \
+        ? _mcgen_TEMPLATE_FOR_CoveredFunctionsEvent(&DebugToolsProfiler_Context, &CoveredFunctionsEvent, Final, FunctionIDsLength, FunctionIDs) : 0
+#define EventWriteCoveredFunctionsEvent_AssumeEnabled(Final, FunctionIDsLength, FunctionIDs) \
+        _mcgen_TEMPLATE_FOR_CoveredFunctionsEvent(&DebugToolsProfiler_Context, &CoveredFunctionsEvent, Final, FunctionIDsLength, FunctionIDs)
+#define EventWriteCoveredFunctionsEvent_ForContext(pContext, Final, FunctionIDsLength, FunctionIDs) \
+        MCGEN_EVENT_ENABLED_FORCONTEXT(pContext, CoveredFunctionsEvent) \
+        ? _mcgen_TEMPLATE_FOR_CoveredFunctionsEvent(&(pContext)->Context, &CoveredFunctionsEvent, Final, FunctionIDsLength, FunctionIDs) : 0
+#define EventWriteCoveredFunctionsEvent_ForContextAssumeEnabled(pContext, Final, FunctionIDsLength, FunctionIDs) \
+        _mcgen_TEMPLATE_FOR_CoveredFunctionsEvent(&_mcgen_CheckContextType_DebugToolsProfiler(pContext)->Context, &CoveredFunctionsEvent, Final, FunctionIDsLength, FunctionIDs)
+
+// This macro is for use by MC-generated code and should not be used directly.
+#define _mcgen_TEMPLATE_FOR_CoveredFunctionsEvent _mcgen_PASTE2(McTemplateU0qqbr1_, MCGEN_EVENTWRITETRANSFER)
+
+//
+// Enablement check macro for event "CallCpuTimeEvent"
+//
+#define EventEnabledCallCpuTimeEvent() _mcgen_EVENT_BIT_SET(DebugToolsProfilerEnableBits, 0)
+#define EventEnabledCallCpuTimeEvent_ForContext(pContext) _mcgen_EVENT_BIT_SET(_mcgen_CheckContextType_DebugToolsProfiler(pContext)->EnableBits, 0)
+
+//
+// Event write macros for event "CallCpuTimeEvent"
+//
+#define EventWriteCallCpuTimeEvent(FunctionID, InclusiveCycles, ExclusiveCycles) \
+        MCGEN_EVENT_ENABLED(CallCpuTimeEvent) \
+        ? _mcgen_TEMPLATE_FOR_CallCpuTimeEvent(&DebugToolsProfiler_Context, &CallCpuTimeEvent, FunctionID, InclusiveCycles, ExclusiveCycles) : 0
+#define EventWriteCallCpuTimeEvent_AssumeEnabled(FunctionID, InclusiveCycles, ExclusiveCycles) \
+        _mcgen_TEMPLATE_FOR_CallCpuTimeEvent(&DebugToolsProfiler_Context, &CallCpuTimeEvent, FunctionID, InclusiveCycles, ExclusiveCycles)
+#define EventWriteCallCpuTimeEvent_ForContext(pContext, FunctionID, InclusiveCycles, ExclusiveCycles) \
+        MCGEN_EVENT_ENABLED_FORCONTEXT(pContext, CallCpuTimeEvent) \
+        ? _mcgen_TEMPLATE_FOR_CallCpuTimeEvent(&(pContext)->Context, &CallCpuTimeEvent, FunctionID, InclusiveCycles, ExclusiveCycles) : 0
+#define EventWriteCallCpuTimeEvent_ForContextAssumeEnabled(pContext, FunctionID, InclusiveCycles, ExclusiveCycles) \
+        _mcgen_TEMPLATE_FOR_CallCpuTimeEvent(&_mcgen_CheckContextType_DebugToolsProfiler(pContext)->Context, &CallCpuTimeEvent, FunctionID, InclusiveCycles, ExclusiveCycles)
+
+// This macro is for use by MC-generated code and should not be used directly.
+#define _mcgen_TEMPLATE_FOR_CallCpuTimeEvent _mcgen_PASTE2(McTemplateU0xxx_, MCGEN_EVENTWRITETRANSFER)
+
+//
+// Enablement check macro for event "HookOverheadEvent"
+//
+#define EventEnabledHookOverheadEvent() _mcgen_EVENT_BIT_SET(DebugToolsProfilerEnableBits, 6)
+#define EventEnabledHookOverheadEvent_ForContext(pContext) _mcgen_EVENT_BIT_SET(_mcgen_CheckContextType_DebugToolsProfiler(pContext)->EnableBits, 6)
+
+//
+// Event write macros for event "HookOverheadEvent"
+//
+#define EventWriteHookOverheadEvent(EnterLeaveCycles) \
+        MCGEN_EVENT_ENABLED(HookOverheadEvent) \
+        ? _mcgen_TEMPLATE_FOR_HookOverheadEvent(&DebugToolsProfiler_Context, &HookOverheadEvent, EnterLeaveCycles) : 0
+#define EventWriteHookOverheadEvent_AssumeEnabled(EnterLeaveCycles) \
+        _mcgen_TEMPLATE_FOR_HookOverheadEvent(&DebugToolsProfiler_Context, &HookOverheadEvent, EnterLeaveCycles)
+#define EventWriteHookOverheadEvent_ForContext(pContext, EnterLeaveCycles) \
+        MCGEN_EVENT_ENABLED_FORCONTEXT(pContext, HookOverheadEvent) \
+        ? _mcgen_TEMPLATE_FOR_HookOverheadEvent(&(pContext)->Context, &HookOverheadEvent, EnterLeaveCycles) : 0
+#define EventWriteHookOverheadEvent_ForContextAssumeEnabled(pContext, EnterLeaveCycles) \
+        _mcgen_TEMPLATE_FOR_HookOverheadEvent(&_mcgen_CheckContextType_DebugToolsProfiler(pContext)->Context, &HookOverheadEvent, EnterLeaveCycles)
+
+// This macro is for use by MC-generated code and should not be used directly.
+#define _mcgen_TEMPLATE_FOR_HookOverheadEvent _mcgen_PASTE2(McTemplateU0x_, MCGEN_EVENTWRITETRANSFER)
+
+//
+// Enablement check macro for event "ContinuousSnapshotEvent"
+//
+#define EventEnabledContinuousSnapshotEvent() _mcgen_EVENT_BIT_SET(DebugToolsProfilerEnableBits, 3)
+#define EventEnabledContinuousSnapshotEvent_ForContext(pContext) _mcgen_EVENT_BIT_SET(_mcgen_CheckContextType_DebugToolsProfiler(pContext)->EnableBits, 3)
+
+//
+// Event write macros for event "ContinuousSnapshotEvent"
+//
+#define EventWriteContinuousSnapshotEvent(TotalCalls, FunctionsLength, Functions) \
+        MCGEN_EVENT_ENABLED(ContinuousSnapshotEvent) \
+        ? _mcgen_TEMPLATE_FOR_ContinuousSnapshotEvent(&DebugToolsProfiler_Context, &ContinuousSnapshotEvent, TotalCalls, FunctionsLength, Functions) : 0
+#define EventWriteContinuousSnapshotEvent_AssumeEnabled(TotalCalls, FunctionsLength, Functions) \
+        _mcgen_TEMPLATE_FOR_ContinuousSnapshotEvent(&DebugToolsProfiler_Context, &ContinuousSnapshotEvent, TotalCalls, FunctionsLength, Functions)
+#define EventWriteContinuousSnapshotEvent_ForContext(pContext, TotalCalls, FunctionsLength, Functions) \
+        MCGEN_EVENT_ENABLED_FORCONTEXT(pContext, ContinuousSnapshotEvent) \
+        ? _mcgen_TEMPLATE_FOR_ContinuousSnapshotEvent(&(pContext)->Context, &ContinuousSnapshotEvent, TotalCalls, FunctionsLength, Functions) : 0
+#define EventWriteContinuousSnapshotEvent_ForContextAssumeEnabled(pContext, TotalCalls, FunctionsLength, Functions) \
+        _mcgen_TEMPLATE_FOR_ContinuousSnapshotEvent(&_mcgen_CheckContextType_DebugToolsProfiler(pContext)->Context, &ContinuousSnapshotEvent, TotalCalls, FunctionsLength, Functions)
+
+// This macro is for use by MC-generated code and should not be used directly.
+#define _mcgen_TEMPLATE_FOR_ContinuousSnapshotEvent _mcgen_PASTE2(McTemplateU0xqbr1_, MCGEN_EVENTWRITETRANSFER)
+
+//
+// Enablement check macro for event "PInvokeStatsEvent"
+//
+#define EventEnabledPInvokeStatsEvent() _mcgen_EVENT_BIT_SET(DebugToolsProfilerEnableBits, 3)
+#define EventEnabledPInvokeStatsEvent_ForContext(pContext) _mcgen_EVENT_BIT_SET(_mcgen_CheckContextType_DebugToolsProfiler(pContext)->EnableBits, 3)
+
+//
+// Event write macros for event "PInvokeStatsEvent"
+//
+#define EventWritePInvokeStatsEvent(Final, PInvokeStatsLength, PInvokeStats) \
+        MCGEN_EVENT_ENABLED(PInvokeStatsEvent) \
+        ? _mcgen_TEMPLATE_FOR_PInvokeStatsEvent(&DebugToolsProfiler_Context, &PInvokeStatsEvent, Final, PInvokeStatsLength, PInvokeStats) : 0
+#define EventWritePInvokeStatsEvent_AssumeEnabled(Final, PInvokeStatsLength, PInvokeStats) \
+        _mcgen_TEMPLATE_FOR_PInvokeStatsEvent(&DebugToolsProfiler_Context, &PInvokeStatsEvent, Final, PInvokeStatsLength, PInvokeStats)
+#define EventWritePInvokeStatsEvent_ForContext(pContext, Final, PInvokeStatsLength, PInvokeStats) \
+        MCGEN_EVENT_ENABLED_FORCONTEXT(pContext, PInvokeStatsEvent) \
+        ? _mcgen_TEMPLATE_FOR_PInvokeStatsEvent(&(pContext)->Context, &PInvokeStatsEvent, Final, PInvokeStatsLength, PInvokeStats) : 0
+#define EventWritePInvokeStatsEvent_ForContextAssumeEnabled(pContext, Final, PInvokeStatsLength, PInvokeStats) \
+        _mcgen_TEMPLATE_FOR_PInvokeStatsEvent(&_mcgen_CheckContextType_DebugToolsProfiler(pContext)->Context, &PInvokeStatsEvent, Final, PInvokeStatsLength, PInvokeStats)
+
+// This macro is for use by MC-generated code and should not be used directly.
+#define _mcgen_TEMPLATE_FOR_PInvokeStatsEvent _mcgen_PASTE2(McTemplateU0qqbr1_, MCGEN_EVENTWRITETRANSFER)
+
+//
+// Enablement check macro for event "SlowCallEvent"
+//
+#define EventEnabledSlowCallEvent() _mcgen_EVENT_BIT_SET(DebugToolsProfilerEnableBits, 5)
+#define EventEnabledSlowCallEvent_ForContext(pContext) _mcgen_EVENT_BIT_SET(_mcgen_CheckContextType_DebugToolsProfiler(pContext)->EnableBits, 5)
+
+//
+// Event write macros for event "SlowCallEvent"
+//
+#define EventWriteSlowCallEvent(Duration) \
+        MCGEN_EVENT_ENABLED(SlowCallEvent) \
+        ? _mcgen_TEMPLATE_FOR_SlowCallEvent(&DebugToolsProfiler_Context, &SlowCallEvent, Duration) : 0
+#define EventWriteSlowCallEvent_AssumeEnabled(Duration) \
+        _mcgen_TEMPLATE_FOR_SlowCallEvent(&DebugToolsProfiler_Context, &SlowCallEvent, Duration)
+#define EventWriteSlowCallEvent_ForContext(pContext, Duration) \
+        MCGEN_EVENT_ENABLED_FORCONTEXT(pContext, SlowCallEvent) \
+        ? _mcgen_TEMPLATE_FOR_SlowCallEvent(&(pContext)->Context, &SlowCallEvent, Duration) : 0
+#define EventWriteSlowCallEvent_ForContextAssumeEnabled(pContext, Duration) \
+        _mcgen_TEMPLATE_FOR_SlowCallEvent(&_mcgen_CheckContextType_DebugToolsProfiler(pContext)->Context, &SlowCallEvent, Duration)
+
+// This macro is for use by MC-generated code and should not be used directly.
+#define _mcgen_TEMPLATE_FOR_SlowCallEvent _mcgen_PASTE2(McTemplateU0x_, MCGEN_EVENTWRITETRANSFER)
+
 #endif // MCGEN_DISABLE_PROVIDER_CODE_GENERATION
 
 //
@@ -1617,6 +1992,276 @@ _mcgen_PASTE2(McTemplateU0xzzzq_, MCGEN_EVENTWRITETRANSFER)(
 }
 #endif // McTemplateU0xzzzq_def
 
+//
+// Function for template "FlightRecorderDumpArgs" (and possibly others).
+// This function is for use by MC-generated code and should not be used directly.
+//
+#ifndef McTemplateU0d_def
+#define McTemplateU0d_def
+ETW_INLINE
+ULONG
+_mcgen_PASTE2(McTemplateU0d_, MCGEN_EVENTWRITETRANSFER)(
+    _In_ PMCGEN_TRACE_CONTEXT Context,
+    _In_ PCEVENT_DESCRIPTOR Descriptor,
+    _In_ const signed int  _Arg0
+    )
+{
+#define McTemplateU0d_ARGCOUNT 1
+
+    EVENT_DATA_DESCRIPTOR EventData[McTemplateU0d_ARGCOUNT + 1];
+
+    EventDataDescCreate(&EventData[1],&_Arg0, sizeof(const signed int)  );
+
+    return McGenEventWrite(Context, Descriptor, NULL, McTemplateU0d_ARGCOUNT + 1, EventData);
+}
+#endif // McTemplateU0d_def
+
+//
+// Function for template "CallStackSnapshotArgs" (and possibly others).
+// This function is for use by MC-generated code and should not be used directly.
+//
+#ifndef McTemplateU0xqbr1_def
+#define McTemplateU0xqbr1_def
+ETW_INLINE
+ULONG
+_mcgen_PASTE2(McTemplateU0xqbr1_, MCGEN_EVENTWRITETRANSFER)(
+    _In_ PMCGEN_TRACE_CONTEXT Context,
+    _In_ PCEVENT_DESCRIPTOR Descriptor,
+    _In_ const unsigned __int64  _Arg0,
+    _In_ const unsigned int  _Arg1,
+    _In_reads_(_Arg1) const unsigned char*  _Arg2
+    )
+{
+#define McTemplateU0xqbr1_ARGCOUNT 3
+
+    EVENT_DATA_DESCRIPTOR EventData[McTemplateU0xqbr1_ARGCOUNT + 1];
+
+    EventDataDescCreate(&EventData[1],&_Arg0, sizeof(const unsigned __int64)  );
+
+    EventDataDescCreate(&EventData[2],&_Arg1, sizeof(const unsigned int)  );
+
+    EventDataDescCreate(&EventData[3],_Arg2, (ULONG)sizeof(char)*_Arg1);
+
+    return McGenEventWrite(Context, Descriptor, NULL, McTemplateU0xqbr1_ARGCOUNT + 1, EventData);
+}
+#endif // McTemplateU0xqbr1_def
+
+//
+// Function for template "CallCompleteArgs" (and possibly others).
+// This function is for use by MC-generated code and should not be used directly.
+//
+#ifndef McTemplateU0xxdx_def
+#define McTemplateU0xxdx_def
+ETW_INLINE
+ULONG
+_mcgen_PASTE2(McTemplateU0xxdx_, MCGEN_EVENTWRITETRANSFER)(
+    _In_ PMCGEN_TRACE_CONTEXT Context,
+    _In_ PCEVENT_DESCRIPTOR Descriptor,
+    _In_ const unsigned __int64  _Arg0,
+    _In_ const unsigned __int64  _Arg1,
+    _In_ const signed int  _Arg2,
+    _In_ const unsigned __int64  _Arg3
+    )
+{
+#define McTemplateU0xxdx_ARGCOUNT 4
+
+    EVENT_DATA_DESCRIPTOR EventData[McTemplateU0xxdx_ARGCOUNT + 1];
+
+    EventDataDescCreate(&EventData[1],&_Arg0, sizeof(const unsigned __int64)  );
+
+    EventDataDescCreate(&EventData[2],&_Arg1, sizeof(const unsigned __int64)  );
+
+    EventDataDescCreate(&EventData[3],&_Arg2, sizeof(const signed int)  );
+
+    EventDataDescCreate(&EventData[4],&_Arg3, sizeof(const unsigned __int64)  );
+
+    return McGenEventWrite(Context, Descriptor, NULL, McTemplateU0xxdx_ARGCOUNT + 1, EventData);
+}
+#endif // McTemplateU0xxdx_def
+
+//
+// Function for template "CallRepeatedArgs" (and possibly others).
+// This function is for use by MC-generated code and should not be used directly.
+//
+#ifndef McTemplateU0xxqxxx_def
+#define McTemplateU0xxqxxx_def
+ETW_INLINE
+ULONG
+_mcgen_PASTE2(McTemplateU0xxqxxx_, MCGEN_EVENTWRITETRANSFER)(
+    _In_ PMCGEN_TRACE_CONTEXT Context,
+    _In_ PCEVENT_DESCRIPTOR Descriptor,
+    _In_ const unsigned __int64  _Arg0,
+    _In_ const unsigned __int64  _Arg1,
+    _In_ const unsigned int  _Arg2,
+    _In_ const unsigned __int64  _Arg3,
+    _In_ const unsigned __int64  _Arg4,
+    _In_ const unsigned __int64  _Arg5
+    )
+{
+#define McTemplateU0xxqxxx_ARGCOUNT 6
+
+    EVENT_DATA_DESCRIPTOR EventData[McTemplateU0xxqxxx_ARGCOUNT + 1];
+
+    EventDataDescCreate(&EventData[1],&_Arg0, sizeof(const unsigned __int64)  );
+
+    EventDataDescCreate(&EventData[2],&_Arg1, sizeof(const unsigned __int64)  );
+
+    EventDataDescCreate(&EventData[3],&_Arg2, sizeof(const unsigned int)  );
+
+    EventDataDescCreate(&EventData[4],&_Arg3, sizeof(const unsigned __int64)  );
+
+    EventDataDescCreate(&EventData[5],&_Arg4, sizeof(const unsigned __int64)  );
+
+    EventDataDescCreate(&EventData[6],&_Arg5, sizeof(const unsigned __int64)  );
+
+    return McGenEventWrite(Context, Descriptor, NULL, McTemplateU0xxqxxx_ARGCOUNT + 1, EventData);
+}
+#endif // McTemplateU0xxqxxx_def
+
+//
+// Function for template "FunctionSuppressedArgs" (and possibly others).
+// This function is for use by MC-generated code and should not be used directly.
+//
+#ifndef McTemplateU0xxxx_def
+#define McTemplateU0xxxx_def
+ETW_INLINE
+ULONG
+_mcgen_PASTE2(McTemplateU0xxxx_, MCGEN_EVENTWRITETRANSFER)(
+    _In_ PMCGEN_TRACE_CONTEXT Context,
+    _In_ PCEVENT_DESCRIPTOR Descriptor,
+    _In_ const unsigned __int64  _Arg0,
+    _In_ const unsigned __int64  _Arg1,
+    _In_ const unsigned __int64  _Arg2,
+    _In_ const unsigned __int64  _Arg3
+    )
+{
+#define McTemplateU0xxxx_ARGCOUNT 4
+
+    EVENT_DATA_DESCRIPTOR EventData[McTemplateU0xxxx_ARGCOUNT + 1];
+
+    EventDataDescCreate(&EventData[1],&_Arg0, sizeof(const unsigned __int64)  );
+
+    EventDataDescCreate(&EventData[2],&_Arg1, sizeof(const unsigned __int64)  );
+
+    EventDataDescCreate(&EventData[3],&_Arg2, sizeof(const unsigned __int64)  );
+
+    EventDataDescCreate(&EventData[4],&_Arg3, sizeof(const unsigned __int64)  );
+
+    return McGenEventWrite(Context, Descriptor, NULL, McTemplateU0xxxx_ARGCOUNT + 1, EventData);
+}
+#endif // McTemplateU0xxxx_def
+
+//
+// Function for template "SuppressedFunctionsArgs" (and possibly others).
+// This function is for use by MC-generated code and should not be used directly.
+//
+#ifndef McTemplateU0qbr0_def
+#define McTemplateU0qbr0_def
+ETW_INLINE
+ULONG
+_mcgen_PASTE2(McTemplateU0qbr0_, MCGEN_EVENTWRITETRANSFER)(
+    _In_ PMCGEN_TRACE_CONTEXT Context,
+    _In_ PCEVENT_DESCRIPTOR Descriptor,
+    _In_ const unsigned int  _Arg0,
+    _In_reads_(_Arg0) const unsigned char*  _Arg1
+    )
+{
+#define McTemplateU0qbr0_ARGCOUNT 2
+
+    EVENT_DATA_DESCRIPTOR EventData[McTemplateU0qbr0_ARGCOUNT + 1];
+
+    EventDataDescCreate(&EventData[1],&_Arg0, sizeof(const unsigned int)  );
+
+    EventDataDescCreate(&EventData[2],_Arg1, (ULONG)sizeof(char)*_Arg0);
+
+    return McGenEventWrite(Context, Descriptor, NULL, McTemplateU0qbr0_ARGCOUNT + 1, EventData);
+}
+#endif // McTemplateU0qbr0_def
+
+//
+// Function for template "StackDefinedArgs" (and possibly others).
+// This function is for use by MC-generated code and should not be used directly.
+//
+#ifndef McTemplateU0qqbr1_def
+#define McTemplateU0qqbr1_def
+ETW_INLINE
+ULONG
+_mcgen_PASTE2(McTemplateU0qqbr1_, MCGEN_EVENTWRITETRANSFER)(
+    _In_ PMCGEN_TRACE_CONTEXT Context,
+    _In_ PCEVENT_DESCRIPTOR Descriptor,
+    _In_ const unsigned int  _Arg0,
+    _In_ const unsigned int  _Arg1,
+    _In_reads_(_Arg1) const unsigned char*  _Arg2
+    )
+{
+#define McTemplateU0qqbr1_ARGCOUNT 3
+
+    EVENT_DATA_DESCRIPTOR EventData[McTemplateU0qqbr1_ARGCOUNT + 1];
+
+    EventDataDescCreate(&EventData[1],&_Arg0, sizeof(const unsigned int)  );
+
+    EventDataDescCreate(&EventData[2],&_Arg1, sizeof(const unsigned int)  );
+
+    EventDataDescCreate(&EventData[3],_Arg2, (ULONG)sizeof(char)*_Arg1);
+
+    return McGenEventWrite(Context, Descriptor, NULL, McTemplateU0qqbr1_ARGCOUNT + 1, EventData);
+}
+#endif // McTemplateU0qqbr1_def
+
+//
+// Function for template "MethodCoveredArgs" (and possibly others).
+// This function is for use by MC-generated code and should not be used directly.
+//
+#ifndef McTemplateU0x_def
+#define McTemplateU0x_def
+ETW_INLINE
+ULONG
+_mcgen_PASTE2(McTemplateU0x_, MCGEN_EVENTWRITETRANSFER)(
+    _In_ PMCGEN_TRACE_CONTEXT Context,
+    _In_ PCEVENT_DESCRIPTOR Descriptor,
+    _In_ const unsigned __int64  _Arg0
+    )
+{
+#define McTemplateU0x_ARGCOUNT 1
+
+    EVENT_DATA_DESCRIPTOR EventData[McTemplateU0x_ARGCOUNT + 1];
+
+    EventDataDescCreate(&EventData[1],&_Arg0, sizeof(const unsigned __int64)  );
+
+    return McGenEventWrite(Context, Descriptor, NULL, McTemplateU0x_ARGCOUNT + 1, EventData);
+}
+#endif // McTemplateU0x_def
+
+//
+// Function for template "CallCpuTimeArgs" (and possibly others).
+// This function is for use by MC-generated code and should not be used directly.
+//
+#ifndef McTemplateU0xxx_def
+#define McTemplateU0xxx_def
+ETW_INLINE
+ULONG
+_mcgen_PASTE2(McTemplateU0xxx_, MCGEN_EVENTWRITETRANSFER)(
+    _In_ PMCGEN_TRACE_CONTEXT Context,
+    _In_ PCEVENT_DESCRIPTOR Descriptor,
+    _In_ const unsigned __int64  _Arg0,
+    _In_ const unsigned __int64  _Arg1,
+    _In_ const unsigned __int64  _Arg2
+    )
+{
+#define McTemplateU0xxx_ARGCOUNT 3
+
+    EVENT_DATA_DESCRIPTOR EventData[McTemplateU0xxx_ARGCOUNT + 1];
+
+    EventDataDescCreate(&EventData[1],&_Arg0, sizeof(const unsigned __int64)  );
+
+    EventDataDescCreate(&EventData[2],&_Arg1, sizeof(const unsigned __int64)  );
+
+    EventDataDescCreate(&EventData[3],&_Arg2, sizeof(const unsigned __int64)  );
+
+    return McGenEventWrite(Context, Descriptor, NULL, McTemplateU0xxx_ARGCOUNT + 1, EventData);
+}
+#endif // McTemplateU0xxx_def
+
 #endif // MCGEN_DISABLE_PROVIDER_CODE_GENERATION
 
 #if defined(__cplusplus)
@@ -16,7 +16,7 @@ void dprintf(LPCWSTR format, ...);
 #ifdef _DEBUG
 
 #ifdef LOG_CALL
-#define LogCall(KIND, FUNCTIONID) dprintf(L"%d %d " KIND " " FORMAT_PTR "\n", GetCurrentThreadId(), g_Sequence, FUNCTIONID);
+#define LogCall(KIND, FUNCTIONID) dprintf(L"%d %d " KIND " " FORMAT_PTR "\n", GetCurrentThreadId(), GetThreadContext()->Sequence, FUNCTIONID);
 #endif //LOG_CALL
 #ifdef LOG_HRESULT
 //#define BreakCondition hr == E_FAIL
@@ -50,8 +50,8 @@ void ExitLevel(LPCWSTR format, ...);
 
 extern thread_local BOOL g_DebugBlob;
 
-#define DebugBlob(str) if(g_DebugBlob) dprintf(L"%s %d\n", str, g_ValueBufferPosition)
-#define DebugBlobCtx(str, ctx) if(g_DebugBlob) dprintf(L"%s %s %d\n", str, ctx, g_ValueBufferPosition)
+#define DebugBlob(str) if(g_DebugBlob) dprintf(L"%s %d\n", str, GetThreadContext()->ValueBufferPosition)
+#define DebugBlobCtx(str, ctx) if(g_DebugBlob) dprintf(L"%s %s %d\n", str, ctx, GetThreadContext()->ValueBufferPosition)
 
 #define DebugBlobHeader(HEADER) \
     DebugBlob(L"**************************************************************"); \
@@ -149,4 +149,5 @@ extern thread_local BOOL g_DebugBlob;
 #define PROFILER_E_STATICFIELD_NEED_THREADID MAKE_ERROR(0x1012)
 #define PROFILER_E_STATICFIELD_THREAD_NOT_FOUND MAKE_ERROR(0x1013)
 #define PROFILER_E_STATICFIELD_INVALID_MEMORY MAKE_ERROR(0x1014)
-#define PROFILER_E_STATICFIELD_NOT_INITIALIZED MAKE_ERROR(0x1015)
\ No newline at end of file
+#define PROFILER_E_STATICFIELD_NOT_INITIALIZED MAKE_ERROR(0x1015)
+#define PROFILER_E_INVALID_IL MAKE_ERROR(0x1016)
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include "pch.h"
 #include "Events.h"
 #include "SafeQueue.h"
+#include "CFlightRecorder.h"
+#include "CCallCoalescer.h"
+#include "CSlowCallCapture.h"
 
 #define MMF_BUFFER_SIZE 1000000000
 
@@ -15,11 +18,6 @@
     ptr += record.Size; \
     free(record.Ptr)
 
-typedef struct MMFRecord {
-    ULONG Size;
-    void* Ptr;
-} MMFRecord;
-
 BOOL g_IsETW = FALSE;
 HANDLE g_hFile = NULL;
 BYTE* g_pEventBuffer = NULL;
@@ -95,14 +93,7 @@ DWORD WINAPI MMFThreadProc
     return 0;
 }
 
-typedef struct MMFEventHeader {
-    LONGLONG QPC;
-    DWORD ThreadId;
-    DWORD UserDataSize;
-    USHORT EventType;
-} MMFEventHeader;
-
-ULONG __stdcall EventWriteMMF(
+MMFRecord CreateMMFRecord(
     _In_ PCEVENT_DESCRIPTOR EventDescriptor,
     _In_range_(0, MAX_EVENT_DATA_DESCRIPTORS) ULONG UserDataCount,
     _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData)
@@ -142,12 +133,40 @@ ULONG __stdcall EventWriteMMF(
         ptr += data.Size;
     }
 
-    g_MMFQueue.Push({ recordSize, originalPtr });
+    return { recordSize, originalPtr };
+}
+
+void EnqueueMMFRecord(_In_ MMFRecord record)
+{
+    g_MMFQueue.Push(std::move(record));
+}
+
+/// <summary>
+/// Frees the records that have been queued but not yet consumed by the MMF thread. Only used prior to the memory mapped file being opened,
+/// to discard the events written while the hooks are being calibrated.
+/// </summary>
+void DiscardMMFRecords()
+{
+    MMFRecord record;
+
+    while (g_MMFQueue.Peek() != nullptr)
+    {
+        g_MMFQueue.Pop(record);
+        free(record.Ptr);
+    }
+}
+
+ULONG __stdcall EventWriteMMF(
+    _In_ PCEVENT_DESCRIPTOR EventDescriptor,
+    _In_range_(0, MAX_EVENT_DATA_DESCRIPTORS) ULONG UserDataCount,
+    _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData)
+{
+    g_MMFQueue.Push(CreateMMFRecord(EventDescriptor, UserDataCount, UserData));
 
     return ERROR_SUCCESS;
 }
 
-FORCEINLINE ULONG __stdcall EventWriteTransferImpl(
+ULONG __stdcall EventWriteTransferCore(
     _In_ REGHANDLE RegHandle,
     _In_ PCEVENT_DESCRIPTOR EventDescriptor,
     _In_opt_ LPCGUID ActivityId,
@@ -156,12 +175,36 @@ FORCEINLINE ULONG __stdcall EventWriteTransferImpl(
     _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData
 )
 {
+    //When the flight recorder is enabled, call events are captured in memory and only transferred when a dump is triggered
+    if (g_FlightRecorderEnabled)
+        return CFlightRecorder::Write(RegHandle, EventDescriptor, ActivityId, RelatedActivityId, UserDataCount, UserData);
+
+    //Likewise, call events are only transferred if they belong to a call that was found to be slow
+    if (g_SlowCallCaptureEnabled)
+        return CSlowCallCapture::Write(RegHandle, EventDescriptor, ActivityId, RelatedActivityId, UserDataCount, UserData);
+
     if (g_IsETW)
         return EventWriteTransfer(RegHandle, EventDescriptor, ActivityId, RelatedActivityId, UserDataCount, UserData);
     else
         return EventWriteMMF(EventDescriptor, UserDataCount, UserData);
 }
 
+FORCEINLINE ULONG __stdcall EventWriteTransferImpl(
+    _In_ REGHANDLE RegHandle,
+    _In_ PCEVENT_DESCRIPTOR EventDescriptor,
+    _In_opt_ LPCGUID ActivityId,
+    _In_opt_ LPCGUID RelatedActivityId,
+    _In_range_(0, MAX_EVENT_DATA_DESCRIPTORS) ULONG UserDataCount,
+    _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData
+)
+{
+    //Call events may be held back so that they can be merged with the events that follow them
+    if (g_CoalesceCalls)
+        return CCallCoalescer::Write(RegHandle, EventDescriptor, ActivityId, RelatedActivityId, UserDataCount, UserData);
+
+    return EventWriteTransferCore(RegHandle, EventDescriptor, ActivityId, RelatedActivityId, UserDataCount, UserData);
+}
+
 #pragma endregion
 #pragma region Register
 
@@ -173,7 +216,7 @@ ULONG __stdcall EventRegisterMMF()
     WCHAR szHasDataEventName[BUFFER_SIZE];
     WCHAR szWasProcessedEventName[BUFFER_SIZE];
 
-    DWORD actualSize = GetEnvironmentVariableW(L"DEBUGTOOLS_PARENT_PID", envBuffer, BUFFER_SIZE);
+    DWORD actualSize = GetSettingW(L"DEBUGTOOLS_PARENT_PID", envBuffer, BUFFER_SIZE);
 
     if (actualSize == 0 || actualSize >= BUFFER_SIZE)
         return ERROR_BAD_ENVIRONMENT;
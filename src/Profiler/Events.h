@@ -4,6 +4,41 @@
 
 extern BOOL g_IsETW;
 
+typedef struct MMFRecord {
+    ULONG Size;
+    void* Ptr;
+} MMFRecord;
+
+typedef struct MMFEventHeader {
+    LONGLONG QPC;
+    DWORD ThreadId;
+    DWORD UserDataSize;
+    USHORT EventType;
+} MMFEventHeader;
+
+MMFRecord CreateMMFRecord(
+    _In_ PCEVENT_DESCRIPTOR EventDescriptor,
+    _In_range_(0, MAX_EVENT_DATA_DESCRIPTORS) ULONG UserDataCount,
+    _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData);
+
+void EnqueueMMFRecord(_In_ MMFRecord record);
+
+void DiscardMMFRecords();
+
+ULONG __stdcall EventWriteMMF(
+    _In_ PCEVENT_DESCRIPTOR EventDescriptor,
+    _In_range_(0, MAX_EVENT_DATA_DESCRIPTORS) ULONG UserDataCount,
+    _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData);
+
+ULONG __stdcall EventWriteTransferCore(
+    _In_ REGHANDLE RegHandle,
+    _In_ PCEVENT_DESCRIPTOR EventDescriptor,
+    _In_opt_ LPCGUID ActivityId,
+    _In_opt_ LPCGUID RelatedActivityId,
+    _In_range_(0, MAX_EVENT_DATA_DESCRIPTORS) ULONG UserDataCount,
+    _In_reads_opt_(UserDataCount) PEVENT_DATA_DESCRIPTOR UserData
+);
+
 extern FORCEINLINE ULONG __stdcall EventWriteTransferImpl(
     _In_ REGHANDLE RegHandle,
     _In_ PCEVENT_DESCRIPTOR EventDescriptor,
@@ -29,4 +64,23 @@ extern FORCEINLINE ULONG __stdcall EventUnregisterImpl(
 #define MCGEN_EVENTUNREGISTER EventUnregisterImpl
 #define MCGEN_EVENT_ENABLED(EventName) (g_IsETW ? EventEnabled##EventName() : TRUE)
 
-#include "DebugToolsProfiler.h"
\ No newline at end of file
+#include "DebugToolsProfiler.h"
+
+/// <summary>
+/// Fills the reserved first descriptor of an event that is written without going through the MC-generated helpers. ETW requires this
+/// descriptor to point to the provider's traits, while the memory mapped file transport ignores it.
+/// </summary>
+FORCEINLINE void EventDataDescCreateTraits(_Out_ PEVENT_DATA_DESCRIPTOR EventData)
+{
+    const USHORT UNALIGNED* Traits = (const USHORT UNALIGNED*)(UINT_PTR)DebugToolsProfiler_Context.Logger;
+
+    if (Traits == NULL)
+    {
+        EventDataDescCreate(EventData, NULL, 0);
+        return;
+    }
+
+    EventData->Ptr = (ULONG_PTR)Traits;
+    EventData->Size = *Traits;
+    EventData->Reserved = 2; // EVENT_DATA_DESCRIPTOR_TYPE_PROVIDER_METADATA
+}
\ No newline at end of file
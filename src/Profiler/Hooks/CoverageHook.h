@@ -0,0 +1,29 @@
+#pragma once
+
+#include "CCoverage.h"
+
+/// <summary>
+/// Records that a function has been called. No shadow stack is maintained in coverage mode, so once a function has been covered
+/// its hook does nothing more than test a single bit.<para/>
+/// Covering a function also disables its hooks, so that the naked hooks return before reaching this stub on subsequent calls.
+/// Stubs that are called from instrumented IL don't go through the naked hooks, and continue to rely on the bit, which is only
+/// read once the function has been covered.
+/// </summary>
+void STDMETHODCALLTYPE CoverageEnterStub(FunctionIDOrClientID functionId)
+{
+    if (g_HooksDisabled)
+        return;
+
+    CFunctionRecord* pRecord = (CFunctionRecord*)functionId.clientID;
+
+    if (!CCoverage::IsCovered(pRecord->m_CoverageIndex))
+    {
+        CCoverage::Cover(pRecord);
+
+        pRecord->m_HooksDisabled = TRUE;
+    }
+}
+
+void STDMETHODCALLTYPE CoverageLeaveStub(FunctionIDOrClientID functionId)
+{
+}
\ No newline at end of file
@@ -3,21 +3,41 @@
 #pragma warning(push)
 #pragma warning(disable: 4102) //unreferenced label
 
-// Can't be declared inline because x64 assembly won't work
-// ReSharper disable once CppNonInlineFunctionDefinitionInHeaderFile
-extern "C" void STDMETHODCALLTYPE EnterStub(FunctionIDOrClientID functionId)
+template<TransportKind Transport, bool Coalesce, bool Suppress>
+void STDMETHODCALLTYPE EnterStub(FunctionIDOrClientID functionId)
 {
-    ENTER_FUNCTION(functionId.functionID, FrameKind::Managed);
+    //Stubs that are called from instrumented IL don't go through the naked hooks, so must check this themselves
+    if (g_HooksDisabled)
+        return;
+
+    CThreadContext* pContext = GetThreadContext();
+    CFunctionRecord* pRecord = ResolveFunctionRecord(functionId);
+
+    if constexpr (Suppress)
+    {
+        if (CCallSuppressor::Enter(pContext, pRecord))
+            return;
+    }
+
+    ENTER_FUNCTION_EX(pContext, functionId.functionID, FrameKind::Managed, Suppress);
 
     LogCall(L"Enter", functionId);
 
+    if constexpr (Transport == TransportKind::SlowCall)
+        CSlowCallCapture::Enter(pContext, pRecord);
+
     if (!g_TracingEnabled)
+    {
+        if constexpr (Coalesce)
+            FlushCoalescedCalls(pContext);
+
         return;
+    }
 
     HRESULT hr = S_OK;
 
 ErrExit:
-    ValidateETW(EventWriteCallEnterEvent(functionId.functionID, g_Sequence, hr));
+    ValidateETW((EventWriteCallEvent<Transport, Coalesce>(pContext, &CallEnterEvent, functionId.functionID, pContext->Sequence, hr)));
 }
 
 #ifdef _X86_
@@ -25,6 +45,20 @@ void __declspec(naked) EnterNaked(FunctionIDOrClientID functionIDOrClientID)
 {
     __asm
     {
+        //If hooks are disabled globally (g_HooksDisabled) or for this function (CFunctionRecord::m_HooksDisabled) there's nothing to do,
+        //so return before saving anything else. EAX may contain the return value of the function, so must be preserved
+        cmp dword ptr [g_HooksDisabled], 0
+        jne Disabled
+        push eax
+        mov eax, [esp + 8]           //The client ID, above our saved EAX and the return address
+        cmp dword ptr [eax + 4], 0
+        pop eax
+        je Hooked
+
+Disabled:
+        ret SIZE functionIDOrClientID
+
+Hooked:
         //The method prologue will push the function ID onto the stack; reset ESP so it's correctly visible within this function.
         //This is not optional, in Debug or Release
         push ebp
@@ -68,7 +102,7 @@ SaveFPReg:
 NoSaveFPReg:
     }
 
-    EnterStub(functionIDOrClientID);
+    g_pEnterStub(functionIDOrClientID);
 
     __asm
     {
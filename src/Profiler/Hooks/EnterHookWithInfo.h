@@ -3,18 +3,29 @@
 #pragma warning(push)
 #pragma warning(disable: 4102) //unreferenced label
 
-// Can't be declared inline because x64 assembly won't work
-// ReSharper disable once CppNonInlineFunctionDefinitionInHeaderFile
-extern "C" void STDMETHODCALLTYPE EnterStubWithInfo(FunctionIDOrClientID functionId, COR_PRF_ELT_INFO eltInfo)
+template<bool Suppress>
+void STDMETHODCALLTYPE EnterStubWithInfo(FunctionIDOrClientID functionId, COR_PRF_ELT_INFO eltInfo)
 {
-    ENTER_FUNCTION(functionId.functionID, FrameKind::Managed);
+    CThreadContext* pContext = GetThreadContext();
+    CFunctionRecord* pRecord = ResolveFunctionRecord(functionId);
+
+    if constexpr (Suppress)
+    {
+        if (CCallSuppressor::Enter(pContext, pRecord))
+            return;
+    }
+
+    ENTER_FUNCTION_EX(pContext, functionId.functionID, FrameKind::Managed, Suppress);
 
     LogCall(L"EnterDetailed", functionId);
 
+    if (g_SlowCallCaptureEnabled)
+        CSlowCallCapture::Enter(pContext, pRecord);
+
     if (!g_TracingEnabled)
         return;
 
-    CValueTracer tracer;
+    CValueTracer tracer(pContext);
     tracer.EnterWithInfo(functionId, eltInfo);
 }
 
@@ -66,7 +77,7 @@ SaveFPReg:
 NoSaveFPReg:
     }
 
-    EnterStubWithInfo(functionIDOrClientID, eltInfo);
+    g_pEnterStubWithInfo(functionIDOrClientID, eltInfo);
 
     __asm
     {
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "CCallCoalescer.h"
+#include "CFlightRecorder.h"
+#include "CSampler.h"
+#include "CSlowCallCapture.h"
+
+/// <summary>
+/// Specifies where the events written by the hook stubs are sent. As the transport can't change after Initialize,
+/// the stubs are instantiated for each transport so that they don't need to decide where to send each event as it's written.
+/// </summary>
+enum class TransportKind
+{
+    ETW,
+    MMF,
+    FlightRecorder,
+    SlowCall,
+
+    //Call events are not written at all. The hooks only maintain the shadow stack for CSampler
+    None
+};
+
+/// <summary>
+/// Writes a CallEnterEvent, CallLeaveEvent or TailcallEvent straight to the transport of a given profiler mode,
+/// bypassing the runtime checks performed by the generic event write macros and EventWriteTransferImpl.
+/// </summary>
+/// <typeparam name="Transport">The transport the event should be sent to.</typeparam>
+/// <typeparam name="Coalesce">Whether the event should be passed through <see cref="CCallCoalescer"/> prior to being sent to the transport.</typeparam>
+template<TransportKind Transport, bool Coalesce>
+FORCEINLINE ULONG EventWriteCallEvent(
+    _In_ CThreadContext* pContext,
+    _In_ PCEVENT_DESCRIPTOR EventDescriptor,
+    _In_ FunctionID functionId,
+    _In_ ULONG sequence,
+    _In_ HRESULT hr)
+{
+    if constexpr (Transport == TransportKind::None)
+        return ERROR_SUCCESS;
+
+    if constexpr (Transport == TransportKind::ETW)
+    {
+        //All plain call events share the same enable bit
+        if (!EventEnabledCallEnterEvent())
+            return ERROR_SUCCESS;
+    }
+
+    //Keep in sync with McTemplateU0xxd
+    const unsigned __int64 functionIdArg = functionId;
+    const unsigned __int64 sequenceArg = sequence;
+    const signed int hrArg = hr;
+
+    EVENT_DATA_DESCRIPTOR EventData[4];
+
+    if constexpr (Transport == TransportKind::ETW)
+    {
+        const USHORT UNALIGNED* Traits = (const USHORT UNALIGNED*)(UINT_PTR)DebugToolsProfiler_Context.Logger;
+
+        EventData[0].Ptr = (ULONG_PTR)Traits;
+        EventData[0].Size = *Traits;
+        EventData[0].Reserved = 2; // EVENT_DATA_DESCRIPTOR_TYPE_PROVIDER_METADATA
+    }
+    else
+        EventDataDescCreate(&EventData[0], NULL, 0);
+
+    EventDataDescCreate(&EventData[1], &functionIdArg, sizeof(const unsigned __int64));
+    EventDataDescCreate(&EventData[2], &sequenceArg, sizeof(const unsigned __int64));
+    EventDataDescCreate(&EventData[3], &hrArg, sizeof(const signed int));
+
+    //The coalescer forwards any events it doesn't hold onto to the transport itself
+    if constexpr (Coalesce)
+        return CCallCoalescer::Write(DebugToolsProfilerHandle, EventDescriptor, NULL, NULL, 4, EventData);
+    else if constexpr (Transport == TransportKind::ETW)
+        return EventWriteTransfer(DebugToolsProfilerHandle, EventDescriptor, NULL, NULL, 4, EventData);
+    else if constexpr (Transport == TransportKind::MMF)
+        return EventWriteMMF(EventDescriptor, 4, EventData);
+    else if constexpr (Transport == TransportKind::SlowCall)
+        return CSlowCallCapture::Write(pContext, EventDescriptor, 4, EventData);
+    else
+        return CFlightRecorder::Write(DebugToolsProfilerHandle, EventDescriptor, NULL, NULL, 4, EventData);
+}
+
+/// <summary>
+/// Writes the call events the coalescer is holding onto for the current thread. Called by the hook stubs while tracing is disabled,
+/// as otherwise the thread wouldn't write the event that causes them to be flushed until tracing was enabled again.
+/// </summary>
+FORCEINLINE void FlushCoalescedCalls(_In_ CThreadContext* pContext)
+{
+    if (pContext->PendingEnter.IsPending || pContext->PendingRun.Count)
+        CCallCoalescer::FlushThread(pContext);
+}
+
+typedef void (STDMETHODCALLTYPE* HookStub)(FunctionIDOrClientID functionId);
+typedef void (STDMETHODCALLTYPE* HookStubWithInfo)(FunctionIDOrClientID functionId, COR_PRF_ELT_INFO eltInfo);
+
+//The instantiations of the hook stubs that were selected for the current profiler mode. These are invoked by the naked hooks
+//that are registered with the CLR
+EXTERN_C HookStub g_pEnterStub;
+EXTERN_C HookStub g_pLeaveStub;
+EXTERN_C HookStub g_pTailcallStub;
+
+EXTERN_C HookStubWithInfo g_pEnterStubWithInfo;
+EXTERN_C HookStubWithInfo g_pLeaveStubWithInfo;
+EXTERN_C HookStubWithInfo g_pTailcallStubWithInfo;
\ No newline at end of file
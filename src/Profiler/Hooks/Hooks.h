@@ -6,6 +6,7 @@
 
 #include "Events.h"
 #include "CValueTracer.h"
+#include "HookMode.h"
 
 extern bool g_TracingEnabled;
 
@@ -15,4 +16,72 @@ extern bool g_TracingEnabled;
 
 #include "EnterHookWithInfo.h"
 #include "LeaveHookWithInfo.h"
-#include "TailcallHookWithInfo.h"
\ No newline at end of file
+#include "TailcallHookWithInfo.h"
+
+#include "CoverageHook.h"
+
+volatile BOOL g_HooksDisabled = FALSE;
+
+HookStub g_pEnterStub = nullptr;
+HookStub g_pLeaveStub = nullptr;
+HookStub g_pTailcallStub = nullptr;
+
+HookStubWithInfo g_pEnterStubWithInfo = nullptr;
+HookStubWithInfo g_pLeaveStubWithInfo = nullptr;
+HookStubWithInfo g_pTailcallStubWithInfo = nullptr;
+
+template<TransportKind Transport, bool Coalesce, bool Suppress>
+void SelectHookStubs()
+{
+    g_pEnterStub = EnterStub<Transport, Coalesce, Suppress>;
+    g_pLeaveStub = LeaveStub<Transport, Coalesce, Suppress>;
+    g_pTailcallStub = TailcallStub<Transport, Coalesce, Suppress>;
+
+    //Detailed events are written by CValueTracer, which still goes through the generic event write macros
+    g_pEnterStubWithInfo = EnterStubWithInfo<Suppress>;
+    g_pLeaveStubWithInfo = LeaveStubWithInfo<Suppress>;
+    g_pTailcallStubWithInfo = TailcallStubWithInfo<Suppress>;
+}
+
+template<TransportKind Transport>
+void SelectHookStubs(BOOL coalesce, BOOL suppress)
+{
+    if (coalesce)
+    {
+        if (suppress)
+            SelectHookStubs<Transport, true, true>();
+        else
+            SelectHookStubs<Transport, true, false>();
+    }
+    else
+    {
+        if (suppress)
+            SelectHookStubs<Transport, false, true>();
+        else
+            SelectHookStubs<Transport, false, false>();
+    }
+}
+
+/// <summary>
+/// Selects the instantiations of the hook stubs that correspond to the current profiler mode. Must be called after
+/// all components that contribute to the mode have been initialized, and before the hooks are installed.
+/// </summary>
+inline void SelectHookStubs()
+{
+    if (g_CoverageEnabled)
+    {
+        g_pEnterStub = CoverageEnterStub;
+        g_pLeaveStub = CoverageLeaveStub;
+        g_pTailcallStub = CoverageLeaveStub;
+    }
+    else if (g_SamplingEnabled || g_ContinuousEnabled)
+        SelectHookStubs<TransportKind::None>(FALSE, g_SuppressionEnabled);
+    else if (g_FlightRecorderEnabled)
+        SelectHookStubs<TransportKind::FlightRecorder>(g_CoalesceCalls, g_SuppressionEnabled);
+    else if (g_SlowCallCaptureEnabled)
+        SelectHookStubs<TransportKind::SlowCall>(FALSE, g_SuppressionEnabled);
+    else if (g_IsETW)
+        SelectHookStubs<TransportKind::ETW>(g_CoalesceCalls, g_SuppressionEnabled);
+    else
+        SelectHookStubs<TransportKind::MMF>(g_CoalesceCalls, g_SuppressionEnabled);
+}
\ No newline at end of file
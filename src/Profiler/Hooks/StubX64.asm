@@ -1,6 +1,7 @@
-EXTERN EnterStub:PROC
-EXTERN LeaveStub:PROC
-EXTERN TailcallStub:PROC
+EXTERN g_pEnterStub:QWORD
+EXTERN g_pLeaveStub:QWORD
+EXTERN g_pTailcallStub:QWORD
+EXTERN g_HooksDisabled:DWORD
 
 ; Constants which are used in the following assembly code.
 SIZEOF_OUTGOING_ARGUMENT_HOMES          equ 8h*4h
@@ -8,6 +9,9 @@ NUMBER_XMM_SAVES                        equ 6h
 SIZEOF_STACK_ALLOC                      equ 10h*NUMBER_XMM_SAVES + SIZEOF_OUTGOING_ARGUMENT_HOMES
 OFFSETOF_XMM_SAVE                       equ SIZEOF_OUTGOING_ARGUMENT_HOMES
 
+; Keep in sync with CFunctionRecord::m_HooksDisabled
+OFFSETOF_HOOKS_DISABLED                 equ 8h
+
 _text SEGMENT PARA 'CODE'
 
 ALIGN 16
@@ -15,6 +19,17 @@ PUBLIC EnterNaked
 
 EnterNaked PROC FRAME
 
+    ; If hooks are disabled globally, or for the function whose CFunctionRecord is in rcx, there's nothing to do,
+    ; so return before saving anything
+    cmp     dword ptr [g_HooksDisabled], 0
+    jne     Disabled_Enter
+    cmp     dword ptr [rcx + OFFSETOF_HOOKS_DISABLED], 0
+    je      Hooked_Enter
+
+Disabled_Enter:
+    ret
+
+Hooked_Enter:
     ; save integer return register
     push    rax
     .allocstack 8
@@ -68,7 +83,7 @@ DoneSaveVolFPRegs_Enter:
     .endprolog
 
     ; call C++ helper
-    call                    EnterStub
+    call                    qword ptr [g_pEnterStub]
 
     ; restore floating-point return register
     movdqa                  xmm0, [rsp + OFFSETOF_XMM_SAVE + 0h]
@@ -108,6 +123,17 @@ PUBLIC LeaveNaked
 
 LeaveNaked PROC FRAME
 
+    ; If hooks are disabled globally, or for the function whose CFunctionRecord is in rcx, there's nothing to do,
+    ; so return before saving anything
+    cmp     dword ptr [g_HooksDisabled], 0
+    jne     Disabled_Leave
+    cmp     dword ptr [rcx + OFFSETOF_HOOKS_DISABLED], 0
+    je      Hooked_Leave
+
+Disabled_Leave:
+    ret
+
+Hooked_Leave:
     ; save integer return register
     push    rax
     .allocstack 8
@@ -161,7 +187,7 @@ DoneSaveVolFPRegs_Leave:
     .endprolog
 
     ; call C++ helper
-    call                    LeaveStub
+    call                    qword ptr [g_pLeaveStub]
 
     ; restore floating-point return register
     movdqa                  xmm0, [rsp + OFFSETOF_XMM_SAVE + 0h]
@@ -201,6 +227,17 @@ PUBLIC TailcallNaked
 
 TailcallNaked PROC FRAME
 
+    ; If hooks are disabled globally, or for the function whose CFunctionRecord is in rcx, there's nothing to do,
+    ; so return before saving anything
+    cmp     dword ptr [g_HooksDisabled], 0
+    jne     Disabled_Tailcall
+    cmp     dword ptr [rcx + OFFSETOF_HOOKS_DISABLED], 0
+    je      Hooked_Tailcall
+
+Disabled_Tailcall:
+    ret
+
+Hooked_Tailcall:
     ; save integer return register
     push    rax
     .allocstack 8
@@ -254,7 +291,7 @@ DoneSaveVolFPRegs_Tailcall:
     .endprolog
 
     ; call C++ helper
-    call                    TailcallStub
+    call                    qword ptr [g_pTailcallStub]
 
     ; restore floating-point return register
     movdqa                  xmm0, [rsp + OFFSETOF_XMM_SAVE + 0h]
@@ -1,6 +1,6 @@
-EXTERN EnterStubWithInfo:PROC
-EXTERN LeaveStubWithInfo:PROC
-EXTERN TailcallStubWithInfo:PROC
+EXTERN g_pEnterStubWithInfo:QWORD
+EXTERN g_pLeaveStubWithInfo:QWORD
+EXTERN g_pTailcallStubWithInfo:QWORD
 
 ; Constants which are used in the following assembly code.
 SIZEOF_OUTGOING_ARGUMENT_HOMES          equ 8h*4h
@@ -68,7 +68,7 @@ DoneSaveVolFPRegs:
     .endprolog
 
     ; call C++ helper
-    call                    EnterStubWithInfo
+    call                    qword ptr [g_pEnterStubWithInfo]
 
     ; restore floating-point return register
     movdqa                  xmm0, [rsp + OFFSETOF_XMM_SAVE + 0h]
@@ -161,7 +161,7 @@ DoneSaveVolFPRegs:
     .endprolog
 
     ; call C++ helper
-    call                    LeaveStubWithInfo
+    call                    qword ptr [g_pLeaveStubWithInfo]
 
     ; restore floating-point return register
     movdqa                  xmm0, [rsp + OFFSETOF_XMM_SAVE + 0h]
@@ -254,7 +254,7 @@ DoneSaveVolFPRegs:
     .endprolog
 
     ; call C++ helper
-    call                    TailcallStubWithInfo
+    call                    qword ptr [g_pTailcallStubWithInfo]
 
     ; restore floating-point return register
     movdqa                  xmm0, [rsp + OFFSETOF_XMM_SAVE + 0h]
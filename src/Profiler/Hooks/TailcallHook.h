@@ -3,22 +3,44 @@
 #pragma warning(push)
 #pragma warning(disable: 4102) //unreferenced label
 
-// Can't be declared inline because x64 assembly won't work
-// ReSharper disable once CppNonInlineFunctionDefinitionInHeaderFile
-extern "C" void STDMETHODCALLTYPE TailcallStub(FunctionIDOrClientID functionId)
+template<TransportKind Transport, bool Coalesce, bool Suppress>
+void STDMETHODCALLTYPE TailcallStub(FunctionIDOrClientID functionId)
 {
+    //Stubs that are called from instrumented IL don't go through the naked hooks, so must check this themselves
+    if (g_HooksDisabled)
+        return;
+
     HRESULT hr = S_OK;
 
-    LEAVE_FUNCTION(functionId.functionID);
+    CThreadContext* pContext = GetThreadContext();
+    CFunctionRecord* pRecord = ResolveFunctionRecord(functionId);
+
+    if constexpr (Suppress)
+    {
+        if (CCallSuppressor::Leave(pContext, pRecord))
+        {
+            if (pContext->ExceptionsPending)
+                CExceptionManager::ClearStaleExceptions();
+
+            return;
+        }
+    }
+
+    LEAVE_FUNCTION_EX(pContext, functionId.functionID, pRecord);
     LogCall(L"Tailcall", functionId);
 
-    CExceptionManager::ClearStaleExceptions();
+    if (pContext->ExceptionsPending)
+        CExceptionManager::ClearStaleExceptions();
 
 ErrExit:
-    if (!g_TracingEnabled)
-        return;
-
-    ValidateETW(EventWriteTailcallEvent(functionId.functionID, g_Sequence, hr));
+    if (g_TracingEnabled)
+        ValidateETW((EventWriteCallEvent<Transport, Coalesce>(pContext, &TailcallEvent, functionId.functionID, pContext->Sequence, hr)));
+    else if constexpr (Coalesce)
+        FlushCoalescedCalls(pContext);
+
+    //A capture whose frame has been left must be completed even if tracing has since been disabled, so that it isn't held until the thread's next call
+    if constexpr (Transport == TransportKind::SlowCall)
+        CSlowCallCapture::Leave(pContext);
 }
 
 #ifdef _X86_
@@ -26,6 +48,20 @@ void __declspec(naked) TailcallNaked(FunctionIDOrClientID functionIDOrClientID)
 {
     __asm
     {
+        //If hooks are disabled globally (g_HooksDisabled) or for this function (CFunctionRecord::m_HooksDisabled) there's nothing to do,
+        //so return before saving anything else. EAX may contain the return value of the function, so must be preserved
+        cmp dword ptr [g_HooksDisabled], 0
+        jne Disabled
+        push eax
+        mov eax, [esp + 8]           //The client ID, above our saved EAX and the return address
+        cmp dword ptr [eax + 4], 0
+        pop eax
+        je Hooked
+
+Disabled:
+        ret SIZE functionIDOrClientID
+
+Hooked:
         //The method prologue will push the function ID onto the stack; reset ESP so it's correctly visible within this function.
         //This is not optional, in Debug or Release
         push ebp
@@ -69,7 +105,7 @@ SaveFPReg:
 NoSaveFPReg:
     }
 
-    TailcallStub(functionIDOrClientID);
+    g_pTailcallStub(functionIDOrClientID);
 
     __asm
     {
@@ -3,25 +3,40 @@
 #pragma warning(push)
 #pragma warning(disable: 4102) //unreferenced label
 
-// Can't be declared inline because x64 assembly won't work
-// ReSharper disable once CppNonInlineFunctionDefinitionInHeaderFile
-extern "C" void STDMETHODCALLTYPE TailcallStubWithInfo(FunctionIDOrClientID functionId, COR_PRF_ELT_INFO eltInfo)
+template<bool Suppress>
+void STDMETHODCALLTYPE TailcallStubWithInfo(FunctionIDOrClientID functionId, COR_PRF_ELT_INFO eltInfo)
 {
     HRESULT hr = S_OK;
 
-    LEAVE_FUNCTION(functionId.functionID);
-    LogCall(L"TailcallDetailed", functionId);
+    CThreadContext* pContext = GetThreadContext();
+    CFunctionRecord* pRecord = ResolveFunctionRecord(functionId);
 
-    CExceptionManager::ClearStaleExceptions();
+    if constexpr (Suppress)
+    {
+        if (CCallSuppressor::Leave(pContext, pRecord))
+        {
+            if (pContext->ExceptionsPending)
+                CExceptionManager::ClearStaleExceptions();
 
-    if (!g_TracingEnabled)
-        return;
+            return;
+        }
+    }
 
+    LEAVE_FUNCTION_EX(pContext, functionId.functionID, pRecord);
+    LogCall(L"TailcallDetailed", functionId);
+
+    if (pContext->ExceptionsPending)
+        CExceptionManager::ClearStaleExceptions();
+
+    if (g_TracingEnabled)
     {
-        CValueTracer tracer;
+        CValueTracer tracer(pContext);
         tracer.TailcallWithInfo(functionId, eltInfo);
     }
 
+    if (g_SlowCallCaptureEnabled)
+        CSlowCallCapture::Leave(pContext);
+
 ErrExit:
     return;
 }
@@ -75,7 +90,7 @@ SaveFPReg:
 NoSaveFPReg:
     }
 
-    TailcallStubWithInfo(functionIDOrClientID, eltInfo);
+    g_pTailcallStubWithInfo(functionIDOrClientID, eltInfo);
 
     __asm
     {
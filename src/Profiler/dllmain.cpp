@@ -1,6 +1,7 @@
 // dllmain.cpp : Defines the entry point for the DLL application.
 #include "pch.h"
 #include "CClassFactory.h"
+#include "CThreadContext.h"
 
 BOOL APIENTRY DllMain( HMODULE hModule,
                        DWORD  ul_reason_for_call,
@@ -11,9 +12,12 @@ BOOL APIENTRY DllMain( HMODULE hModule,
     {
     case DLL_PROCESS_ATTACH:
     case DLL_THREAD_ATTACH:
-    case DLL_THREAD_DETACH:
     case DLL_PROCESS_DETACH:
         break;
+
+    case DLL_THREAD_DETACH:
+        CThreadContext::Release();
+        break;
     }
     return TRUE;
 }
@@ -41,7 +45,7 @@ extern "C" HRESULT WINAPI DllGetClassObject(REFCLSID rclsid, REFIID riid, void**
 
     //If we want to limit profiling to a particular child process, DEBUGTOOLS_TARGET_PROCESS can be specified,
     //indicating a substring of the full EXE path that should be included (e.g. "powershell")
-    DWORD actualSize = GetEnvironmentVariable(L"DEBUGTOOLS_TARGET_PROCESS", targetProcess, MAX_PATH);
+    DWORD actualSize = GetSetting(L"DEBUGTOOLS_TARGET_PROCESS", targetProcess, MAX_PATH);
 
     if (actualSize > 0 && actualSize < MAX_PATH)
     {
@@ -34,6 +34,7 @@ namespace std
 #endif
 
 #include "ErrorHandling.h"
+#include "CSettings.h"
 
 #define IfFailGoto(EXPR, LABEL) \
     do { \
@@ -63,10 +64,24 @@ namespace std
 inline BOOL GetBoolEnv(LPCSTR name)
 {
     CHAR buffer[2];
-    DWORD size = GetEnvironmentVariableA(name, buffer, 2);
+    DWORD size = GetSettingA(name, buffer, 2);
     return size == 1 && buffer[0] == '1';
 }
 
+//Reads a setting containing a base 10 integer. If the setting isn't specified (or is too long to be a number) the value is left unchanged
+template<typename T>
+inline BOOL GetIntSetting(LPCSTR name, T* pValue)
+{
+    CHAR buffer[32];
+    DWORD size = GetSettingA(name, buffer, 32);
+
+    if (size == 0 || size >= 32)
+        return FALSE;
+
+    *pValue = (T)_strtoi64(buffer, NULL, 10);
+    return TRUE;
+}
+
 class CLock
 {
 public: